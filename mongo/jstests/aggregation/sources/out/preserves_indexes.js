@@ -0,0 +1,36 @@
+// Tests that $out keeps the indexes of an existing target collection, which are built on the
+// temporary collection after all the documents have been written to it.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const source = db.out_preserves_indexes_source;
+    const target = db.out_preserves_indexes_target;
+    source.drop();
+    target.drop();
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(source.insert({_id: i, a: i, b: i % 10}));
+    }
+
+    assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+    assert.commandWorked(target.createIndex({b: 1}, {background: true}));
+
+    source.aggregate([{$out: target.getName()}]);
+    assert.eq(100, target.find().itcount());
+    assert.eq(100, target.find().hint({a: 1}).itcount());
+    assert.eq(10, target.find({b: 3}).hint({b: 1}).itcount());
+
+    const indexNames = target.getIndexes().map(index => index.name).sort();
+    assert.eq(["_id_", "a_1", "b_1"], indexNames);
+
+    // The specs of the copied indexes are unchanged, including their build options.
+    const indexB = target.getIndexes().find(index => index.name === "b_1");
+    assert.eq(true, indexB.background, tojson(indexB));
+
+    // Output that violates a unique index fails the $out and leaves the target untouched.
+    assertErrorCode(source, [{$project: {a: {$literal: 1}}}, {$out: target.getName()}], 16995);
+    assert.eq(100, target.find().itcount());
+    assert.eq(3, target.getIndexes().length);
+}());
@@ -106,6 +106,7 @@
         balancerStart: {skip: isUnrelated},
         balancerStatus: {skip: isUnrelated},
         balancerStop: {skip: isUnrelated},
+        beginBackupCursor: {skip: isUnrelated},
         buildInfo: {skip: isUnrelated},
         captrunc: {
             command: {captrunc: "view", n: 2, inc: false},
@@ -208,6 +209,7 @@
             expectFailure: true,
         },
         enableSharding: {skip: "Tested as part of shardCollection"},
+        endBackupCursor: {skip: isUnrelated},
         endSessions: {skip: isUnrelated},
         eval: {skip: isUnrelated},
         explain: {command: {explain: {count: "view"}}},
@@ -379,6 +381,7 @@
         planCacheSetFilter: {command: {planCacheSetFilter: "view"}, expectFailure: true},
         profile: {skip: isUnrelated},
         refreshLogicalSessionCacheNow: {skip: isAnInternalCommand},
+        readBackupFile: {skip: isUnrelated},
         reapLogicalSessionCacheNow: {skip: isAnInternalCommand},
         refreshSessions: {skip: isUnrelated},
         refreshSessionsInternal: {skip: isAnInternalCommand},
@@ -0,0 +1,56 @@
+/**
+ * Tests that an open backup cursor is kept open while readBackupFile renews it and is closed once
+ * it goes backupCursorTimeoutSecs without being used.
+ *
+ * @tags: [requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    load('jstests/libs/check_log.js');
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const kTimeoutSecs = 3;
+    const conn = MongoRunner.runMongod({setParameter: {backupCursorTimeoutSecs: kTimeoutSecs}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const admin = conn.getDB('admin');
+
+    assert.commandFailedWithCode(admin.runCommand({setParameter: 1, backupCursorTimeoutSecs: 0}),
+                                 ErrorCodes.BadValue);
+
+    assert.writeOK(conn.getDB('test').backup_cursor_timeout.insert({_id: 0}));
+
+    const backup = assert.commandWorked(admin.runCommand({beginBackupCursor: 1}));
+    const backupId = backup.backupId;
+
+    // Reading from the backup for longer than the timeout keeps it open.
+    const start = new Date();
+    while (new Date() - start < 2 * kTimeoutSecs * 1000) {
+        assert.commandWorked(admin.runCommand(
+            {readBackupFile: 'storage.bson', backupId: backupId, offset: 0, length: 1}));
+        sleep(500);
+    }
+    assert.commandFailedWithCode(admin.runCommand({beginBackupCursor: 1}), ErrorCodes.BadValue);
+
+    // Once the backup goes unused for the timeout, the reaper closes it. Reading would renew it,
+    // so wait for the reaper's log message instead.
+    checkLog.contains(conn, 'Closed backup cursor ' + backupId.str);
+    assert.commandFailedWithCode(
+        admin.runCommand({readBackupFile: 'storage.bson', backupId: backupId, offset: 0}),
+        ErrorCodes.NoSuchKey);
+    assert.commandFailedWithCode(admin.runCommand({endBackupCursor: 1, backupId: backupId}),
+                                 ErrorCodes.NoSuchKey);
+
+    // The storage engine left backup mode, so the node can be fsyncLocked and backed up again.
+    assert.commandWorked(admin.runCommand({fsync: 1, lock: true}));
+    assert.commandWorked(admin.runCommand({fsyncUnlock: 1}));
+    const nextBackup = assert.commandWorked(admin.runCommand({beginBackupCursor: 1}));
+    assert.commandWorked(admin.runCommand({endBackupCursor: 1, backupId: nextBackup.backupId}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,92 @@
+// Tests that a node started with --wiredTigerIndexCompactKeys, which stores dates in index keys in
+// a shorter form, returns the same results as other nodes and replicates to nodes without the
+// option. The key format is local to each node and never appears in the index spec.
+(function() {
+    "use strict";
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTest.log("Skipping test because storageEngine is not wiredTiger");
+        return;
+    }
+
+    const rst = new ReplSetTest({
+        nodes: [{wiredTigerIndexCompactKeys: true}, {rsConfig: {priority: 0}}],
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const primaryDB = primary.getDB("test");
+    const coll = primaryDB.index_compact_keys;
+
+    function formatVersion(conn, indexName) {
+        const stats = assert.commandWorked(conn.getDB("test").runCommand(
+            {collStats: coll.getName(), indexDetails: true}));
+        return stats.indexDetails[indexName].metadata.formatVersion;
+    }
+
+    const dates = [
+        new Date(-62135596800000),
+        new Date(-1),
+        new Date(0),
+        new Date(1),
+        new Date(15),
+        new Date(16),
+        new Date(1510000000000),
+        new Date(253402300799999),
+    ];
+    const bulk = coll.initializeUnorderedBulkOp();
+    dates.forEach((date, i) => {
+        bulk.insert({_id: i, tenant: "t" + (i % 2), ts: date});
+    });
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(coll.createIndex({tenant: 1, ts: -1}, {name: "compact"}));
+    assert.commandWorked(coll.createIndex({ts: 1}, {name: "v1", v: 1}));
+    rst.awaitReplication();
+
+    // Only the node started with the option stores compact keys, and only for v:2 indexes.
+    assert.eq(9, formatVersion(primary, "compact"));
+    assert.eq(8, formatVersion(secondary, "compact"));
+    assert.eq(6, formatVersion(primary, "v1"));
+
+    // The option isn't part of the index spec, which every version of the server would reject.
+    assert.commandFailedWithCode(
+        coll.createIndex({ts: -1}, {storageEngine: {wiredTiger: {compactKeys: true}}}),
+        ErrorCodes.InvalidOptions);
+
+    const queries = [
+        {tenant: "t0"},
+        {tenant: "t1", ts: {$gte: new Date(0)}},
+        {tenant: "t0", ts: {$lt: new Date(16)}},
+        {tenant: {$in: ["t0", "t1"]}, ts: {$gt: new Date(-1), $lte: new Date(1510000000000)}},
+    ];
+    const secondaryColl = secondary.getDB("test")[coll.getName()];
+    secondary.setSlaveOk();
+    queries.forEach(query => {
+        const compact = coll.find(query, {_id: 0, tenant: 1, ts: 1}).hint("compact").toArray();
+        const expected =
+            secondaryColl.find(query, {_id: 0, tenant: 1, ts: 1}).hint("compact").toArray();
+        assert.eq(expected, compact, tojson(query));
+    });
+    assert(coll.validate(true).valid);
+    rst.checkReplicatedDataHashes();
+
+    // 3.4 binaries can't read compact keys, so the featureCompatibilityVersion can't be
+    // downgraded while such an index exists, and no such index is created after a downgrade.
+    const adminDB = primary.getDB("admin");
+    assert.commandFailedWithCode(adminDB.runCommand({setFeatureCompatibilityVersion: "3.4"}),
+                                 ErrorCodes.IllegalOperation);
+    assert.commandWorked(coll.dropIndex("compact"));
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: "3.4"}));
+    assert.commandWorked(coll.createIndex({tenant: 1, ts: -1}, {name: "downgraded"}));
+    assert.eq(8, formatVersion(primary, "downgraded"));
+
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: "3.6"}));
+    assert.commandWorked(coll.createIndex({tenant: 1, ts: 1}, {name: "upgraded"}));
+    assert.eq(9, formatVersion(primary, "upgraded"));
+
+    rst.stopSet();
+})();
@@ -0,0 +1,29 @@
+/**
+ * Tests that oplogMinRetentionSeconds and oplogMaxRetentionSeconds reject negative values and a
+ * minimum retention window that is longer than the maximum.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const admin = conn.getDB('admin');
+
+    assert.commandFailedWithCode(admin.runCommand({setParameter: 1, oplogMinRetentionSeconds: -1}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(admin.runCommand({setParameter: 1, oplogMaxRetentionSeconds: -1}),
+                                 ErrorCodes.BadValue);
+
+    assert.commandWorked(admin.runCommand({setParameter: 1, oplogMaxRetentionSeconds: 3600}));
+    assert.commandFailedWithCode(
+        admin.runCommand({setParameter: 1, oplogMinRetentionSeconds: 7200}), ErrorCodes.BadValue);
+    assert.commandWorked(admin.runCommand({setParameter: 1, oplogMinRetentionSeconds: 600}));
+    assert.commandFailedWithCode(admin.runCommand({setParameter: 1, oplogMaxRetentionSeconds: 60}),
+                                 ErrorCodes.BadValue);
+
+    // Zero leaves a bound unset, so it is always accepted.
+    assert.commandWorked(admin.runCommand({setParameter: 1, oplogMaxRetentionSeconds: 0}));
+    assert.commandWorked(admin.runCommand({setParameter: 1, oplogMinRetentionSeconds: 7200}));
+
+    MongoRunner.stopMongod(conn);
+})();
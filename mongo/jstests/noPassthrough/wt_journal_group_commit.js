@@ -0,0 +1,58 @@
+/**
+ * Tests that concurrent j:true writers share journal flushes when the flusher is configured to
+ * wait for them, and that serverStatus reports the batch sizes and wait times.
+ */
+(function() {
+    'use strict';
+
+    load('jstests/libs/parallelTester.js');
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {wiredTigerJournalCommitDelayMicros: 2000, wiredTigerJournalCommitBatchSize: 4}
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const kThreads = 8;
+    const kWritesPerThread = 50;
+
+    let threads = [];
+    for (let t = 0; t < kThreads; t++) {
+        threads.push(new ScopedThread(function(host, thread, writes) {
+            const coll = new Mongo(host).getDB('test').group_commit;
+            for (let i = 0; i < writes; i++) {
+                assert.writeOK(coll.insert({thread: thread, i: i}, {writeConcern: {j: true}}));
+            }
+        }, conn.host, t, kWritesPerThread));
+    }
+    threads.forEach(thread => thread.start());
+    threads.forEach(thread => thread.join());
+
+    const db = conn.getDB('test');
+    assert.eq(kThreads * kWritesPerThread, db.group_commit.count());
+
+    const stats = db.serverStatus().wiredTiger.groupCommit;
+    assert(stats, tojson(db.serverStatus().wiredTiger));
+
+    let flushes = 0;
+    let batchedWaiters = 0;
+    stats.flushBatchSizes.forEach(function(bucket) {
+        flushes += bucket.count;
+        if (bucket.waiters > 1) {
+            batchedWaiters += bucket.count;
+        }
+    });
+    let waits = 0;
+    stats.waitMicros.forEach(bucket => waits += bucket.count);
+
+    assert.gt(flushes, 0, tojson(stats));
+    assert.gte(waits, flushes, tojson(stats));
+    assert.gt(batchedWaiters, 0, 'no flush covered more than one waiter: ' + tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+})();
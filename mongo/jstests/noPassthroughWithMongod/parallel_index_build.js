@@ -0,0 +1,63 @@
+// Tests that foreground index builds which generate keys on several threads build the same
+// indexes, and report the same duplicate key errors, as builds on a single thread.
+(function() {
+    "use strict";
+
+    const coll = db.parallel_index_build;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; ++i) {
+        bulk.insert({a: i, b: i % 7, c: [i, i + 1], d: "x" + i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const original =
+        assert.commandWorked(db.adminCommand({getParameter: 1, maxIndexBuildWorkers: 1}))
+            .maxIndexBuildWorkers;
+
+    function setWorkers(n) {
+        assert.commandWorked(db.adminCommand({setParameter: 1, maxIndexBuildWorkers: n}));
+    }
+
+    function checkIndex(keyPattern, expectedKeys, query) {
+        const res = coll.validate(true);
+        assert(res.valid, tojson(res));
+        const explain = coll.find(query).hint(keyPattern).explain("executionStats");
+        assert.eq(expectedKeys, explain.executionStats.totalKeysExamined, tojson(explain));
+    }
+
+    try {
+        setWorkers(4);
+
+        // Several indexes built together, including a multikey, a hashed and a partial index.
+        assert.commandWorked(db.runCommand({
+            createIndexes: coll.getName(),
+            indexes: [
+                {key: {a: 1}, name: "a_1"},
+                {key: {b: 1, a: -1}, name: "b_1_a_-1"},
+                {key: {c: 1}, name: "c_1"},
+                {key: {d: "hashed"}, name: "d_hashed"},
+                {key: {b: 1}, name: "b_partial", partialFilterExpression: {b: {$gt: 5}}},
+            ]
+        }));
+
+        checkIndex({a: 1}, 10000, {});
+        checkIndex({b: 1, a: -1}, 1429, {b: 0});
+        checkIndex({c: 1}, 20000, {});
+        checkIndex({b: 1}, 1428, {b: {$gt: 5}});
+        assert.eq(1, coll.find({d: "x42"}).hint({d: "hashed"}).itcount());
+        assert.eq(6, coll.getIndexes().length);
+
+        // Every key of a multikey index must be found, whichever partition generated it.
+        assert.eq(2, coll.find({c: 500}).hint({c: 1}).itcount());
+
+        // Duplicates split between partitions are still detected.
+        assert.commandFailedWithCode(coll.createIndex({b: 1}, {unique: true, name: "b_unique"}),
+                                     ErrorCodes.DuplicateKey);
+        assert.commandWorked(coll.createIndex({d: 1}, {unique: true}));
+        assert.eq(1, coll.find({d: "x9999"}).hint({d: 1}).itcount());
+    } finally {
+        setWorkers(original);
+    }
+})();
@@ -0,0 +1,78 @@
+// Tests that candidate plans whose estimated cost, from a sample of the collection, is far above
+// that of another candidate are discarded without being tried.
+(function() {
+    "use strict";
+
+    // Sampling needs a storage engine with random cursors.
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        print("Skipping plan_cost_pruning.js since this server does not have WiredTiger enabled");
+        return;
+    }
+
+    const coll = db.plan_cost_pruning;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({a: i, b: i % 2, c: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({a: 1, c: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    function usesIndex(plan, indexName) {
+        return JSON.stringify(plan).indexOf('"indexName":"' + indexName + '"') !== -1;
+    }
+
+    function setPruning(enabled) {
+        const res = assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlannerEnableCostBasedPruning: enabled}));
+        return res.was;
+    }
+
+    const wasEnabled = setPruning(true);
+    try {
+        // The sample, and the index keys generated from it, are built a little by each query
+        // planned, so the first few queries are not pruned.
+        let explain;
+        assert.soon(function() {
+            coll.getPlanCache().clear();
+            explain = coll.find({a: 5, b: 1}).explain();
+            return explain.queryPlanner.rejectedPlans.length === 1;
+        }, () => tojson(explain), 60 * 1000, 10);
+
+        // The scan of {b: 1} examines half of the collection, the scans of {a: 1} and
+        // {a: 1, c: 1} a single key. Only the two cheap candidates are tried.
+        assert(!usesIndex(explain.queryPlanner.rejectedPlans, "b_1"), tojson(explain));
+        assert(!usesIndex(explain.queryPlanner.winningPlan, "b_1"), tojson(explain));
+
+        // The trial between the surviving candidates caches the winner.
+        coll.getPlanCache().clear();
+        assert.eq(1, coll.find({a: 5, b: 1}).itcount());
+        assert.gt(coll.getPlanCache().getPlansByQuery({a: 5, b: 1}).length, 0);
+
+        // The cheapest two candidates are always kept, so the query is still multi-planned and
+        // cached.
+        coll.getPlanCache().clear();
+        assert.commandWorked(coll.dropIndex({a: 1, c: 1}));
+        explain = coll.find({a: 5, b: 1}).explain();
+        assert.gt(explain.queryPlanner.rejectedPlans.length, 0, tojson(explain));
+        assert.eq(1, coll.find({a: 5, b: 1}).itcount());
+        assert.gt(coll.getPlanCache().getPlansByQuery({a: 5, b: 1}).length, 0);
+
+        // Candidates of similar cost are still tried.
+        explain = coll.find({a: {$lt: 2500}, b: 1}).explain();
+        assert.gt(explain.queryPlanner.rejectedPlans.length, 0, tojson(explain));
+
+        // Queries with a sort are left to the trial.
+        explain = coll.find({a: 5, b: 1}).sort({b: 1}).explain();
+        assert.gt(explain.queryPlanner.rejectedPlans.length, 0, tojson(explain));
+
+        setPruning(false);
+        explain = coll.find({a: 5, b: 1}).explain();
+        assert.gt(explain.queryPlanner.rejectedPlans.length, 0, tojson(explain));
+    } finally {
+        setPruning(wasEnabled);
+    }
+}());
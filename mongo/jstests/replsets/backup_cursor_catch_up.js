@@ -0,0 +1,96 @@
+/**
+ * Tests that a secondary that fell behind can be caught up from a copy of its sync source's data
+ * files taken through a backup cursor while the sync source keeps accepting writes. The restarted
+ * secondary resumes oplog application from the copied checkpoint instead of an initial sync.
+ *
+ * @tags: [requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const rst = new ReplSetTest({nodes: [{}, {rsConfig: {priority: 0}}]});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB('test').backup_cursor_catch_up;
+
+    function insertDocs(start, end, writeConcern) {
+        let bulk = coll.initializeUnorderedBulkOp();
+        for (let i = start; i < end; i++) {
+            bulk.insert({_id: i, x: 'x'.repeat(100)});
+        }
+        assert.writeOK(bulk.execute(writeConcern));
+    }
+
+    insertDocs(0, 100, {w: 2});
+
+    // The secondary falls behind while it is down.
+    const secondaryDbpath = rst.nodes[1].dbpath;
+    rst.stop(1);
+    insertDocs(100, 200, {w: 1});
+
+    const backup = assert.commandWorked(primary.adminCommand({beginBackupCursor: 1}));
+    jsTest.log('Opened backup cursor: ' + tojson(backup));
+    assert(backup.hasOwnProperty('checkpointOpTime'), tojson(backup));
+    assert.gt(backup.files.length, 0, tojson(backup));
+
+    // Writes after the backup cursor was opened reach the secondary through the oplog.
+    insertDocs(200, 300, {w: 1});
+
+    // Only one backup cursor may be open, and it keeps the node from being fsyncLocked.
+    assert.commandFailedWithCode(primary.adminCommand({beginBackupCursor: 1}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailed(primary.adminCommand({fsync: 1, lock: true}));
+
+    // Only the listed files of the open backup can be read.
+    const backupId = backup.backupId;
+    assert.commandFailedWithCode(
+        primary.adminCommand({readBackupFile: 'mongod.lock', backupId: backupId}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        primary.adminCommand({readBackupFile: backup.files[0].filename, backupId: ObjectId()}),
+        ErrorCodes.NoSuchKey);
+
+    const storageBson = backup.files.find(file => file.filename === 'storage.bson');
+    assert(storageBson, tojson(backup.files));
+    const chunk = assert.commandWorked(
+        primary.adminCommand({readBackupFile: 'storage.bson', backupId: backupId, offset: 0}));
+    assert(chunk.eof, tojson(chunk));
+    assert.eq(storageBson.fileSize, chunk.data.length(), tojson(chunk));
+
+    // Replace the secondary's data files with the copy.
+    resetDbpath(secondaryDbpath);
+    backup.files.forEach(function(file) {
+        const dir = file.filename.lastIndexOf('/');
+        if (dir !== -1) {
+            mkdir(secondaryDbpath + '/' + file.filename.substring(0, dir));
+        }
+        copyFile(backup.dbpath + '/' + file.filename, secondaryDbpath + '/' + file.filename);
+    });
+    assert.commandWorked(primary.adminCommand({endBackupCursor: 1, backupId: backupId}));
+    assert.commandFailedWithCode(primary.adminCommand({endBackupCursor: 1, backupId: backupId}),
+                                 ErrorCodes.NoSuchKey);
+
+    rst.restart(1);
+    rst.awaitSecondaryNodes();
+    insertDocs(300, 400, {w: 2});
+    rst.awaitReplication();
+
+    const secondary = rst.getSecondary();
+    const status =
+        assert.commandWorked(secondary.adminCommand({replSetGetStatus: 1, initialSync: 1}));
+    assert(!status.hasOwnProperty('initialSyncStatus'), tojson(status));
+
+    secondary.setSlaveOk();
+    assert.eq(400, secondary.getDB('test').backup_cursor_catch_up.find().itcount());
+    rst.checkReplicatedDataHashes();
+
+    rst.stopSet();
+})();
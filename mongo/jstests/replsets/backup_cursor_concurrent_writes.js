@@ -0,0 +1,79 @@
+/**
+ * Tests that a copy of a primary taken through a backup cursor while several clients keep writing
+ * has no oplog holes: a secondary restarted on the copy catches up to every write instead of
+ * skipping the ones that had not committed when the checkpoint was taken.
+ *
+ * @tags: [requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const rst = new ReplSetTest({nodes: [{}, {rsConfig: {priority: 0}}]});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const collName = 'backup_cursor_concurrent_writes';
+    const coll = primary.getDB('test')[collName];
+    assert.writeOK(coll.insert({_id: 'initial'}, {writeConcern: {w: 2}}));
+
+    const secondaryDbpath = rst.nodes[1].dbpath;
+    rst.stop(1);
+
+    const kNumWriters = 4;
+    const kDocsPerWriter = 2000;
+    let writers = [];
+    for (let i = 0; i < kNumWriters; i++) {
+        writers.push(startParallelShell(
+            'const coll = db.getSiblingDB("test").' + collName + ';' +
+                'for (let j = 0; j < ' + kDocsPerWriter + '; j++) {' +
+                '    assert.writeOK(coll.insert({writer: ' + i + ', j: j}));' +
+                '}',
+            primary.port));
+    }
+
+    // Take the copy while the writers are running.
+    assert.soon(() => coll.find({writer: {$exists: true}}).itcount() > kNumWriters * 10);
+    const backup = assert.commandWorked(primary.adminCommand({beginBackupCursor: 1}));
+    jsTest.log('Opened backup cursor: ' + tojson(backup));
+    assert(backup.hasOwnProperty('checkpointOpTime'), tojson(backup));
+
+    resetDbpath(secondaryDbpath);
+    backup.files.forEach(function(file) {
+        const dir = file.filename.lastIndexOf('/');
+        if (dir !== -1) {
+            mkdir(secondaryDbpath + '/' + file.filename.substring(0, dir));
+        }
+        copyFile(backup.dbpath + '/' + file.filename, secondaryDbpath + '/' + file.filename);
+    });
+    assert.commandWorked(primary.adminCommand({endBackupCursor: 1, backupId: backup.backupId}));
+
+    writers.forEach(function(awaitShell) {
+        awaitShell();
+    });
+    const numDocs = 1 + kNumWriters * kDocsPerWriter;
+    assert.eq(numDocs, coll.find().itcount());
+
+    rst.restart(1);
+    rst.awaitSecondaryNodes();
+    rst.awaitReplication();
+
+    const secondary = rst.getSecondary();
+    const status =
+        assert.commandWorked(secondary.adminCommand({replSetGetStatus: 1, initialSync: 1}));
+    assert(!status.hasOwnProperty('initialSyncStatus'), tojson(status));
+
+    // The restarted member resumed from the checkpoint and got every write, including those
+    // that were in progress when the checkpoint was taken.
+    secondary.setSlaveOk();
+    assert.eq(numDocs, secondary.getDB('test')[collName].find().itcount());
+    rst.checkReplicatedDataHashes();
+
+    rst.stopSet();
+})();
@@ -0,0 +1,50 @@
+/**
+ * Tests that initial sync clones collections correctly when they are split into ranges of the _id
+ * index, each read by its own cursor. The _ids mix several types, so that range boundaries fall
+ * between values of different types.
+ */
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({name: 'initial_sync_id_ranges', nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB('test').id_ranges;
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 300; i++) {
+        bulk.insert({_id: i, x: i});
+        bulk.insert({_id: 'str' + i, x: i});
+        bulk.insert({_id: ObjectId(), x: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({x: 1}));
+
+    // Capped collections are still cloned in insertion order.
+    const capped = primary.getDB('test').id_ranges_capped;
+    assert.commandWorked(primary.getDB('test').createCollection(capped.getName(),
+                                                                {capped: true, size: 100000}));
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(capped.insert({_id: 100 - i}));
+    }
+
+    const secondary = rst.add({
+        setParameter: {
+            initialSyncCloneCollectionsInIdRanges: true,
+            maxNumInitialSyncCollectionClonerCursors: 4,
+        }
+    });
+    rst.reInitiate();
+    rst.awaitSecondaryNodes();
+    rst.awaitReplication();
+
+    const secondaryDB = secondary.getDB('test');
+    assert.eq(900, secondaryDB.id_ranges.find().itcount());
+    assert.eq(900, secondaryDB.id_ranges.find().hint({x: 1}).itcount());
+    assert.eq(capped.find().toArray(), secondaryDB.id_ranges_capped.find().toArray());
+    rst.checkReplicatedDataHashes();
+
+    rst.stopSet();
+})();
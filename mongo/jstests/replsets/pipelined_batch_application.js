@@ -0,0 +1,57 @@
+/**
+ * Tests that a secondary applying oplog batches with replPipelineBatchApplication enabled, where
+ * the next batch is written to the oplog while the current one is applied, ends up with the same
+ * data and oplog as the primary. Small batches and a backlog of buffered operations make sure
+ * many batches are prepared early, and the commands in between make sure the pipeline is
+ * restarted after batches that must be applied alone.
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const rst = new ReplSetTest({
+        nodes: [
+            {},
+            {
+              rsConfig: {priority: 0},
+              setParameter: {replPipelineBatchApplication: true, replBatchLimitOperations: 10}
+            }
+        ]
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const coll = primary.getDB('test').pipelined;
+
+    // Let the secondary buffer up a backlog, so that a next batch is always ready.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'rsSyncApplyStop', mode: 'alwaysOn'}));
+
+    for (let round = 0; round < 5; round++) {
+        let bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 200; i++) {
+            bulk.insert({_id: round * 200 + i, round: round, x: i});
+        }
+        assert.writeOK(bulk.execute());
+        assert.writeOK(coll.update({round: round}, {$inc: {x: 1}}, {multi: true}));
+        assert.commandWorked(coll.createIndex({['round' + round]: 1}));
+        assert.writeOK(coll.remove({round: round, x: {$lt: 10}}));
+    }
+
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'rsSyncApplyStop', mode: 'off'}));
+    rst.awaitReplication();
+
+    assert.eq(coll.find().itcount(), secondary.getDB('test').pipelined.find().itcount());
+    rst.checkReplicatedDataHashes();
+    rst.checkOplogs();
+
+    rst.stopSet();
+})();
@@ -0,0 +1,74 @@
+/**
+ * Tests that a secondary which crashes with replPipelineBatchApplication enabled, after the next
+ * batch was written to the oplog but before the current one was recorded as applied, truncates
+ * the next batch from its oplog on restart, replays the current one and catches up without gaps
+ * or duplicates.
+ *
+ * @tags: [requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    load('jstests/libs/check_log.js');
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const rst = new ReplSetTest({
+        nodes: [
+            {},
+            {
+              rsConfig: {priority: 0},
+              setParameter: {replPipelineBatchApplication: true, replBatchLimitOperations: 10}
+            }
+        ]
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    let secondary = rst.getSecondary();
+    const coll = primary.getDB('test').pipelined_recovery;
+    assert.writeOK(coll.insert({_id: 'initial'}, {writeConcern: {w: 2}}));
+
+    // Let the secondary buffer up a backlog, so that a next batch is ready to be prepared.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'rsSyncApplyStop', mode: 'alwaysOn'}));
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 200; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.update({}, {$inc: {x: 1}}, {multi: true}));
+
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: 'hangAfterPreparingNextBatch', mode: 'alwaysOn'}));
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'rsSyncApplyStop', mode: 'off'}));
+    checkLog.contains(secondary, 'hangAfterPreparingNextBatch fail point enabled');
+
+    // Crash with two batches in the oplog and only the first one applied.
+    rst.stop(secondary, 9, {allowedExitCode: MongoRunner.EXIT_SIGKILL});
+    secondary = rst.restart(secondary);
+
+    // Recovery drops the prepared batch from the oplog, since it was never applied.
+    checkLog.contains(secondary, 'Removing unapplied entries starting at:');
+    secondary.setSlaveOk();
+    const truncateAfterPoint = secondary.getDB('local').replset.oplogTruncateAfterPoint.findOne(
+        {_id: 'oplogTruncateAfterPoint'});
+    assert(!truncateAfterPoint ||
+               timestampCmp(truncateAfterPoint.oplogTruncateAfterPoint, Timestamp()) === 0,
+           tojson(truncateAfterPoint));
+
+    rst.awaitSecondaryNodes();
+    rst.awaitReplication();
+
+    assert.eq(coll.find().itcount(), secondary.getDB('test').pipelined_recovery.find().itcount());
+    rst.checkReplicatedDataHashes();
+    rst.checkOplogs();
+
+    rst.stopSet();
+})();
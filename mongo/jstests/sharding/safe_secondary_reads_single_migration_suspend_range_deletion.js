@@ -106,6 +106,7 @@
         balancerStart: {skip: "primary only"},
         balancerStatus: {skip: "primary only"},
         balancerStop: {skip: "primary only"},
+        beginBackupCursor: {skip: "does not return user data"},
         buildInfo: {skip: "does not return user data"},
         captrunc: {skip: "primary only"},
         checkShardingIndex: {skip: "primary only"},
@@ -179,6 +180,7 @@
         dropUser: {skip: "primary only"},
         emptycapped: {skip: "primary only"},
         enableSharding: {skip: "primary only"},
+        endBackupCursor: {skip: "does not return user data"},
         endSessions: {skip: "does not return user data"},
         eval: {skip: "primary only"},
         explain: {skip: "TODO SERVER-30068"},
@@ -296,6 +298,7 @@
         planCacheSetFilter: {skip: "does not return user data"},
         profile: {skip: "primary only"},
         reIndex: {skip: "does not return user data"},
+        readBackupFile: {skip: "does not return user data"},
         reapLogicalSessionCacheNow: {skip: "does not return user data"},
         refreshLogicalSessionCacheNow: {skip: "does not return user data"},
         refreshSessions: {skip: "does not return user data"},
@@ -94,6 +94,7 @@
         balancerStart: {skip: "primary only"},
         balancerStatus: {skip: "primary only"},
         balancerStop: {skip: "primary only"},
+        beginBackupCursor: {skip: "does not return user data"},
         buildInfo: {skip: "does not return user data"},
         captrunc: {skip: "primary only"},
         checkShardingIndex: {skip: "primary only"},
@@ -157,6 +158,7 @@
         dropUser: {skip: "primary only"},
         emptycapped: {skip: "primary only"},
         enableSharding: {skip: "primary only"},
+        endBackupCursor: {skip: "does not return user data"},
         endSessions: {skip: "does not return user data"},
         eval: {skip: "primary only"},
         explain: {skip: "TODO SERVER-30068"},
@@ -259,6 +261,7 @@
         planCacheListQueryShapes: {skip: "does not return user data"},
         planCacheSetFilter: {skip: "does not return user data"},
         profile: {skip: "primary only"},
+        readBackupFile: {skip: "does not return user data"},
         reapLogicalSessionCacheNow: {skip: "does not return user data"},
         refreshLogicalSessionCacheNow: {skip: "does not return user data"},
         refreshSessions: {skip: "does not return user data"},
@@ -164,6 +164,17 @@ Status parseCursorResponse(const BSONObj& obj,
     return Status::OK();
 }
 
+RemoteCommandRequest makeRemoteCommandRequest(const HostAndPort& source,
+                                              const std::string& dbname,
+                                              const BSONObj& cmdObj,
+                                              const BSONObj& metadata,
+                                              Milliseconds networkTimeout,
+                                              const std::string& compressor) {
+    RemoteCommandRequest request(source, dbname, cmdObj, metadata, nullptr, networkTimeout);
+    request.compressor = compressor;
+    return request;
+}
+
 }  // namespace
 
 Fetcher::Fetcher(executor::TaskExecutor* executor,
@@ -174,18 +185,21 @@ Fetcher::Fetcher(executor::TaskExecutor* executor,
                  const BSONObj& metadata,
                  Milliseconds findNetworkTimeout,
                  Milliseconds getMoreNetworkTimeout,
-                 std::unique_ptr<RemoteCommandRetryScheduler::RetryPolicy> firstCommandRetryPolicy)
+                 std::unique_ptr<RemoteCommandRetryScheduler::RetryPolicy> firstCommandRetryPolicy,
+                 const std::string& compressor)
     : _executor(executor),
       _source(source),
       _dbname(dbname),
       _cmdObj(findCmdObj.getOwned()),
       _metadata(metadata.getOwned()),
+      _compressor(compressor),
       _work(work),
       _findNetworkTimeout(findNetworkTimeout),
       _getMoreNetworkTimeout(getMoreNetworkTimeout),
       _firstRemoteCommandScheduler(
           _executor,
-          RemoteCommandRequest(_source, _dbname, _cmdObj, _metadata, nullptr, _findNetworkTimeout),
+          makeRemoteCommandRequest(
+              _source, _dbname, _cmdObj, _metadata, _findNetworkTimeout, _compressor),
           stdx::bind(&Fetcher::_callback, this, stdx::placeholders::_1, kFirstBatchFieldName),
           std::move(firstCommandRetryPolicy)) {
     uassert(ErrorCodes::BadValue, "callback function cannot be null", work);
@@ -316,8 +330,8 @@ Status Fetcher::_scheduleGetMore(const BSONObj& cmdObj) {
     }
     StatusWith<executor::TaskExecutor::CallbackHandle> scheduleResult =
         _executor->scheduleRemoteCommand(
-            RemoteCommandRequest(
-                _source, _dbname, cmdObj, _metadata, nullptr, _getMoreNetworkTimeout),
+            makeRemoteCommandRequest(
+                _source, _dbname, cmdObj, _metadata, _getMoreNetworkTimeout, _compressor),
             stdx::bind(&Fetcher::_callback, this, stdx::placeholders::_1, kNextBatchFieldName));
 
     if (!scheduleResult.isOK()) {
@@ -122,6 +122,9 @@ public:
      *
      * An optional retry policy may be provided for the first remote command request so that
      * the remote command scheduler will re-send the command in case of transient network errors.
+     *
+     * 'compressor' names the network message compressor that all remote commands ask for, see
+     * RemoteCommandRequest::compressor.
      */
     Fetcher(executor::TaskExecutor* executor,
             const HostAndPort& source,
@@ -132,7 +135,8 @@ public:
             Milliseconds findNetworkTimeout = RemoteCommandRequest::kNoTimeout,
             Milliseconds getMoreNetworkTimeout = RemoteCommandRequest::kNoTimeout,
             std::unique_ptr<RemoteCommandRetryScheduler::RetryPolicy> firstCommandRetryPolicy =
-                RemoteCommandRetryScheduler::makeNoRetryPolicy());
+                RemoteCommandRetryScheduler::makeNoRetryPolicy(),
+            const std::string& compressor = std::string());
 
     virtual ~Fetcher();
 
@@ -237,6 +241,7 @@ private:
     std::string _dbname;
     BSONObj _cmdObj;
     BSONObj _metadata;
+    std::string _compressor;
     CallbackFn _work;
 
     // Protects member data of this Fetcher.
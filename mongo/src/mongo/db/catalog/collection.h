@@ -271,6 +271,7 @@ public:
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const std::vector<std::string>* modifiedIndexedPaths,
                                         OpDebug* opDebug,
                                         OplogUpdateEntryArgs* args) = 0;
 
@@ -542,6 +543,8 @@ public:
      * If the document fits in the old space, it is put there; if not, it is moved.
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
+     * 'modifiedIndexedPaths' Optional argument. When not null and 'indexesAffected' is true, only
+     * the indexes over at least one of these paths have their keys regenerated.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
@@ -551,10 +554,18 @@ public:
                                    const BSONObj& newDoc,
                                    const bool enforceQuota,
                                    const bool indexesAffected,
+                                   const std::vector<std::string>* const modifiedIndexedPaths,
                                    OpDebug* const opDebug,
                                    OplogUpdateEntryArgs* const args) {
-        return this->_impl().updateDocument(
-            opCtx, oldLocation, oldDoc, newDoc, enforceQuota, indexesAffected, opDebug, args);
+        return this->_impl().updateDocument(opCtx,
+                                            oldLocation,
+                                            oldDoc,
+                                            newDoc,
+                                            enforceQuota,
+                                            indexesAffected,
+                                            modifiedIndexedPaths,
+                                            opDebug,
+                                            args);
     }
 
     inline bool updateWithDamagesSupported() const {
@@ -34,6 +34,8 @@
 
 #include "mongo/db/catalog/collection_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/counter.h"
 #include "mongo/base/init.h"
 #include "mongo/base/owned_pointer_map.h"
@@ -624,6 +626,7 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const std::vector<std::string>* modifiedIndexedPaths,
                                         OpDebug* opDebug,
                                         OplogUpdateEntryArgs* args) {
     {
@@ -675,14 +678,18 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                 << " != "
                                 << newDoc.objsize());
 
-    // At the end of this step, we will have a map of UpdateTickets, one per index, which
-    // represent the index updates needed to be done, based on the changes between oldDoc and
-    // newDoc.
+    // At the end of this step, we will have a map of UpdateTickets, one per index whose keys may
+    // have changed, which represent the index updates needed to be done, based on the changes
+    // between oldDoc and newDoc.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
     if (indexesAffected) {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            if (!_indexAffectedByPaths(opCtx, descriptor, modifiedIndexedPaths)) {
+                continue;
+            }
+
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
@@ -716,12 +723,16 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            auto updateTicket = updateTickets.map().find(descriptor);
+            if (updateTicket == updateTickets.map().end()) {
+                continue;
+            }
+
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
             int64_t keysInserted;
             int64_t keysDeleted;
-            uassertStatusOK(iam->update(
-                opCtx, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted));
+            uassertStatusOK(iam->update(opCtx, *updateTicket->second, &keysInserted, &keysDeleted));
             if (opDebug) {
                 opDebug->keysInserted += keysInserted;
                 opDebug->keysDeleted += keysDeleted;
@@ -737,6 +748,26 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     return {oldLocation};
 }
 
+bool CollectionImpl::_indexAffectedByPaths(
+    OperationContext* opCtx,
+    const IndexDescriptor* descriptor,
+    const std::vector<std::string>* modifiedIndexedPaths) const {
+    if (!modifiedIndexedPaths) {
+        return true;
+    }
+
+    const UpdateIndexData* indexKeys =
+        _infoCache.getIndexKeysForIndex(opCtx, descriptor->indexName());
+    if (!indexKeys) {
+        return true;
+    }
+
+    return std::any_of(
+        modifiedIndexedPaths->begin(),
+        modifiedIndexedPaths->end(),
+        [&](const std::string& path) { return indexKeys->mightBeIndexed(path); });
+}
+
 StatusWith<RecordId> CollectionImpl::_updateDocumentWithMove(OperationContext* opCtx,
                                                              const RecordId& oldLocation,
                                                              const Snapshotted<BSONObj>& oldDoc,
@@ -212,6 +212,8 @@ public:
      * If the document fits in the old space, it is put there; if not, it is moved.
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
+     * 'modifiedIndexedPaths' Optional argument. When not null and 'indexesAffected' is true, only
+     * the indexes over at least one of these paths have their keys regenerated.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
@@ -221,6 +223,7 @@ public:
                             const BSONObj& newDoc,
                             bool enforceQuota,
                             bool indexesAffected,
+                            const std::vector<std::string>* modifiedIndexedPaths,
                             OpDebug* opDebug,
                             OplogUpdateEntryArgs* args) final;
 
@@ -424,6 +427,14 @@ private:
                             OpDebug* opDebug);
 
 
+    /**
+     * Returns whether an update which modified 'modifiedIndexedPaths' may change the keys of the
+     * index 'descriptor'. A null 'modifiedIndexedPaths' may have modified any path.
+     */
+    bool _indexAffectedByPaths(OperationContext* opCtx,
+                               const IndexDescriptor* descriptor,
+                               const std::vector<std::string>* modifiedIndexedPaths) const;
+
     /**
      * Perform update when document move will be required.
      */
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -53,8 +54,13 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual CollectionStatistics* getStatistics() const = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
+        virtual const UpdateIndexData* getIndexKeysForIndex(OperationContext* opCtx,
+                                                            StringData indexName) const = 0;
+
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
 
         virtual void init(OperationContext* opCtx) = 0;
@@ -103,6 +109,13 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the statistics used to estimate the cost of query plans on this collection.
+     */
+    inline CollectionStatistics* getStatistics() const {
+        return this->_impl().getStatistics();
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -110,6 +123,15 @@ public:
         return this->_impl().getIndexKeys(opCtx);
     }
 
+    /**
+     * Like getIndexKeys(), but only for the paths of the index named 'indexName'. Returns nullptr
+     * if there is no such index.
+     */
+    inline const UpdateIndexData* getIndexKeysForIndex(OperationContext* const opCtx,
+                                                       const StringData indexName) const {
+        return this->_impl().getIndexKeysForIndex(opCtx, indexName);
+    }
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
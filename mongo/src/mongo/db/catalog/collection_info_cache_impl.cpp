@@ -65,6 +65,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
+      _statistics(stdx::make_unique<CollectionStatistics>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -82,8 +83,18 @@ const UpdateIndexData& CollectionInfoCacheImpl::getIndexKeys(OperationContext* o
     return _indexedPaths;
 }
 
+const UpdateIndexData* CollectionInfoCacheImpl::getIndexKeysForIndex(OperationContext* opCtx,
+                                                                     StringData indexName) const {
+    // This requires "some" lock, and MODE_IS is an expression for that, for now.
+    dassert(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
+    invariant(_keysComputed);
+    auto it = _indexedPathsByIndex.find(indexName.toString());
+    return it == _indexedPathsByIndex.end() ? nullptr : &it->second;
+}
+
 void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     _indexedPaths.clear();
+    _indexedPathsByIndex.clear();
 
     bool hadTTLIndex = _hasTTLIndex;
     _hasTTLIndex = false;
@@ -92,6 +103,13 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
 
+        // Every path is registered both for the collection and for the index alone.
+        UpdateIndexData& pathsForIndex = _indexedPathsByIndex[descriptor->indexName()];
+        auto addPath = [&](StringData path) {
+            _indexedPaths.addPath(path);
+            pathsForIndex.addPath(path);
+        };
+
         if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
             BSONObj key = descriptor->keyPattern();
             const BSONObj& infoObj = descriptor->infoObj();
@@ -101,28 +119,30 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
             BSONObjIterator j(key);
             while (j.more()) {
                 BSONElement e = j.next();
-                _indexedPaths.addPath(e.fieldName());
+                addPath(e.fieldName());
             }
         } else {
             fts::FTSSpec ftsSpec(descriptor->infoObj());
 
             if (ftsSpec.wildcard()) {
                 _indexedPaths.allPathsIndexed();
+                pathsForIndex.allPathsIndexed();
             } else {
                 for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraBefore(i));
+                    addPath(ftsSpec.extraBefore(i));
                 }
                 for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
                      it != ftsSpec.weights().end();
                      ++it) {
-                    _indexedPaths.addPath(it->first);
+                    addPath(it->first);
                 }
                 for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraAfter(i));
+                    addPath(ftsSpec.extraAfter(i));
                 }
                 // Any update to a path containing "language" as a component could change the
                 // language of a subdocument.  Add the override field as a path component.
                 _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
+                pathsForIndex.addPathComponent(ftsSpec.languageOverrideField());
             }
         }
 
@@ -133,7 +153,7 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
             unordered_set<std::string> paths;
             QueryPlannerIXSelect::getFields(filter, "", &paths);
             for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(*it);
+                addPath(*it);
             }
         }
     }
@@ -178,6 +198,10 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+CollectionStatistics* CollectionInfoCacheImpl::getStatistics() const {
+    return _statistics.get();
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<IndexEntry> indexEntries;
 
@@ -239,6 +263,7 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
     clearQueryCache();
+    _statistics->clear();
 
     _keysComputed = false;
     computeIndexKeys(opCtx);
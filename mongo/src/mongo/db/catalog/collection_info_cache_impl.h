@@ -31,6 +31,7 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -61,11 +62,23 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the statistics used to estimate the cost of query plans on this collection.
+     */
+    CollectionStatistics* getStatistics() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    /**
+     * Like getIndexKeys(), but only for the paths of the index named 'indexName'. Returns nullptr
+     * if there is no such index.
+     */
+    const UpdateIndexData* getIndexKeysForIndex(OperationContext* opCtx,
+                                                StringData indexName) const;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -123,6 +136,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    std::map<std::string, UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.  
     std::unique_ptr<PlanCache> _planCache;
@@ -131,6 +145,9 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Sampled statistics for plan cost estimation.
+    std::unique_ptr<CollectionStatistics> _statistics;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
@@ -175,6 +175,7 @@ public:
                             const BSONObj& newDoc,
                             bool enforceQuota,
                             bool indexesAffected,
+                            const std::vector<std::string>* modifiedIndexedPaths,
                             OpDebug* opDebug,
                             OplogUpdateEntryArgs* args) {
         std::abort();
@@ -42,7 +42,9 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/exec/parallel_batch.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -99,6 +101,14 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// How many threads a foreground build of btree and hashed indexes may generate keys on. The
+// memory limit above is shared between all of them.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildWorkers, int, 1);
+
+// How much insert() buffers before generating keys on several threads.
+const size_t kMaxPendingDocs = 4096;
+const size_t kMaxPendingBytes = 16 * 1024 * 1024;
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -211,6 +221,7 @@ MultiIndexBlockImpl::init(const std::vector<BSONObj>& indexSpecs) {
     if (!status.isOK())
         return status;
 
+    bool canBuildInParallel = true;
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
 
@@ -223,6 +234,9 @@ db.things.ensureIndex({name:1}, {background:true});
 */
 	log() << " yang test(MultiIndexBlockImpl::init) ... info:" << redact(info);
         string pluginName = IndexNames::findPluginName(info["key"].Obj());
+        // Other kinds of index are not known to generate keys safely from several threads.
+        canBuildInParallel =
+            canBuildInParallel && (pluginName.empty() || pluginName == IndexNames::HASHED);
         if (pluginName.size()) {
             Status s = _collection->getIndexCatalog()->_upgradeDatabaseMinorVersionIfNeeded(
                 _opCtx, pluginName);
@@ -244,6 +258,11 @@ db.things.ensureIndex({name:1}, {background:true});
             indexSpecs.size();
     }
 
+    if (!_buildInBackground && canBuildInParallel) {
+        _numPartitions = std::max(
+            1, std::min(maxIndexBuildWorkers.load(), static_cast<int>(ProcessInfo().getNumCores())));
+    }
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
         StatusWith<BSONObj> statusWithInfo =
@@ -268,7 +287,10 @@ db.things.ensureIndex({name:1}, {background:true});
         if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+            for (size_t partition = 0; partition < _numPartitions; ++partition) {
+                index.bulks.push_back(
+                    index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes / _numPartitions));
+            }
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -281,9 +303,13 @@ db.things.ensureIndex({name:1}, {background:true});
 
 		//build index on: test.world properties: { v: 2, key: { geometry: "2dsphere" }, name: "geometry_2dsphere", ns: "test.world", 2dsphereIndexVersion: 3 }
         log() << "build index on: " << ns << " properties: " << descriptor->toString();
-        if (index.bulk)
+        if (!index.bulks.empty()) {
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+            if (_numPartitions > 1) {
+                log() << "\t generating keys on up to " << _numPartitions << " threads";
+            }
+        }
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -436,6 +462,19 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
 }
 
 Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
+    if (_numPartitions > 1) {
+        _pendingDocs.emplace_back(doc.getOwned(), loc);
+        _pendingBytes += doc.objsize();
+        if (_pendingDocs.size() >= kMaxPendingDocs || _pendingBytes >= kMaxPendingBytes) {
+            try {
+                insertPendingDocs();
+            } catch (const DBException& ex) {
+                return ex.toStatus();
+            }
+        }
+        return Status::OK();
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
             continue;
@@ -443,8 +482,9 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
 
         int64_t unused;
         Status idxStatus(ErrorCodes::InternalError, "");
-        if (_indexes[i].bulk) {
-            idxStatus = _indexes[i].bulk->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
+        if (!_indexes[i].bulks.empty()) {
+            idxStatus =
+                _indexes[i].bulks.front()->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
         } else {
             idxStatus = _indexes[i].real->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
         }
@@ -455,14 +495,74 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
     return Status::OK();
 }
 
+void MultiIndexBlockImpl::insertPendingDocs() {
+    const size_t numDocs = _pendingDocs.size();
+
+    // BulkBuilder::insert() only generates keys and adds them to the BulkBuilder's own sorter, so
+    // each partition can go to its own thread. It doesn't use the OperationContext.
+    parallel_batch::forEachChunk(
+        _numPartitions, _numPartitions, 1, [&](size_t beginPartition, size_t endPartition) {
+            for (size_t partition = beginPartition; partition < endPartition; ++partition) {
+                const size_t end = numDocs * (partition + 1) / _numPartitions;
+                for (size_t i = numDocs * partition / _numPartitions; i < end; ++i) {
+                    const BSONObj& doc = _pendingDocs[i].first;
+                    for (auto&& index : _indexes) {
+                        if (index.filterExpression && !index.filterExpression->matchesBSON(doc)) {
+                            continue;
+                        }
+
+                        int64_t unused;
+                        uassertStatusOK(index.bulks[partition]->insert(
+                            _opCtx, doc, _pendingDocs[i].second, index.options, &unused));
+                    }
+                }
+            }
+        });
+
+    _pendingDocs.clear();
+    _pendingBytes = 0;
+}
+
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
+    if (!_pendingDocs.empty()) {
+        try {
+            insertPendingDocs();
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+    }
+
+    if (_numPartitions > 1) {
+        // Sorting, and spilling to disk if the keys don't fit in memory, is the expensive part of
+        // commitBulk(). Each BulkBuilder has its own sorter, so all of them are sorted in
+        // parallel. Loading the btrees stays serial: it writes through the one OperationContext
+        // and may update the multikey state in the catalog.
+        std::vector<IndexAccessMethod::BulkBuilder*> bulks;
+        for (auto&& index : _indexes) {
+            for (auto&& bulk : index.bulks) {
+                bulks.push_back(bulk.get());
+            }
+        }
+
+        try {
+            parallel_batch::forEachChunk(
+                bulks.size(), _numPartitions, 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        bulks[i]->sort();
+                    }
+                });
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
-        if (_indexes[i].bulk == NULL)
+        if (_indexes[i].bulks.empty())
             continue;
         LOG(1) << "\t bulk commit starting for index: "
                << _indexes[i].block->getEntry()->descriptor()->indexName();
         Status status = _indexes[i].real->commitBulk(_opCtx,
-                                                     std::move(_indexes[i].bulk),
+                                                     std::move(_indexes[i].bulks),
                                                      _allowInterruption,
                                                      _indexes[i].options.dupsAllowed,
                                                      dupsOut);
@@ -192,12 +192,20 @@ private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
 
+    /**
+     * Adds the keys of all of '_pendingDocs' to the BulkBuilders of their partitions, using up to
+     * '_numPartitions' threads, and empties it.
+     */
+    void insertPendingDocs();
+
     struct IndexToBuild {
         std::unique_ptr<IndexCatalogImpl::IndexBuildBlock> block;
 
         IndexAccessMethod* real = NULL;           // owned elsewhere
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
-        std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
+
+        // One per partition of the documents, or none if not building in bulk.
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;
 
         InsertDeleteOptions options;
     };
@@ -215,6 +223,13 @@ private:
     bool _ignoreUnique;
 
     bool _needToCleanup;
+
+    // When greater than one, insert() buffers documents in '_pendingDocs' and
+    // insertPendingDocs() splits them into this many partitions, whose keys are generated on
+    // separate threads into separate BulkBuilders. Only for foreground builds.
+    size_t _numPartitions = 1;
+    std::vector<std::pair<BSONObj, RecordId>> _pendingDocs;
+    size_t _pendingBytes = 0;
 };
 
 }  // namespace mongo
@@ -0,0 +1,415 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/optional.hpp>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/oid.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/fsync.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+#include "mongo/util/time_support.h"
+
+/**
+ * Commands that let a data file copy of this node be taken while it keeps accepting writes:
+ *
+ *   {beginBackupCursor: 1}
+ *       Takes a checkpoint and opens a storage engine backup cursor. Returns a 'backupId', the
+ *       files (relative to the dbpath) to copy and, on replica set members, the
+ *       'checkpointOpTime': the copy holds exactly the operations up to and including it, so a
+ *       member started on the copy resumes oplog application from there instead of an initial
+ *       sync. Writes wait while the checkpoint is taken, which keeps the copy's oplog free of
+ *       holes: on a primary, an operation can commit before one with an earlier optime, and a
+ *       member that found the later one at the top of its oplog would never fetch the earlier.
+ *   {readBackupFile: <filename>, backupId: <oid>, offset: <bytes>, length: <bytes>}
+ *       Returns up to 'length' bytes of a listed file starting at 'offset'.
+ *   {endBackupCursor: 1, backupId: <oid>}
+ *       Closes the backup cursor, after which the storage engine may remove the listed files.
+ *
+ * The backup cursor is not tied to the connection that opened it, so a copy can be spread over
+ * several connections. While it is open the storage engine keeps the checkpoint and every later
+ * journal file, so a backup that goes backupCursorTimeoutSecs without a readBackupFile is closed
+ * by a periodic reaper, as if endBackupCursor had been run.
+ */
+
+namespace mongo {
+namespace {
+
+// Largest chunk readBackupFile returns, leaving room in the reply for the other fields.
+const long long kMaxReadBackupFileBytes = BSONObjMaxUserSize - 1024 * 1024;
+
+// How often the reaper looks for an expired backup.
+const Milliseconds kBackupCursorReaperInterval = Seconds(1);
+
+// Number of seconds an open backup may go without a readBackupFile before it is closed.
+AtomicInt32 backupCursorTimeoutSecs(5 * 60);
+
+class ExportedBackupCursorTimeoutSecsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedBackupCursorTimeoutSecsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "backupCursorTimeoutSecs",
+              &backupCursorTimeoutSecs) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "backupCursorTimeoutSecs must be greater than or equal to 1");
+        }
+
+        return Status::OK();
+    }
+} exportedBackupCursorTimeoutSecsParam;
+
+Date_t now() {
+    return getGlobalServiceContext()->getFastClockSource()->now();
+}
+
+Date_t expirationFromNow() {
+    return now() + Seconds(backupCursorTimeoutSecs.load());
+}
+
+/**
+ * The single backup cursor that may be open on this node.
+ */
+class OpenBackup {
+public:
+    /**
+     * Returns the id of the new backup, or an error if one is already open.
+     */
+    StatusWith<OID> open(const std::vector<std::string>& files) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_backupId) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "A backup cursor is already open: " << *_backupId);
+        }
+        _backupId = OID::gen();
+        _files = std::set<std::string>(files.begin(), files.end());
+        _expiresAt = expirationFromNow();
+        return *_backupId;
+    }
+
+    Status close(const OID& backupId) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto status = _checkBackupId_inlock(backupId);
+        if (status.isOK()) {
+            _backupId = boost::none;
+            _files.clear();
+        }
+        return status;
+    }
+
+    /**
+     * Closes the open backup if it has not been renewed before 'when'. Returns the id of the
+     * closed backup.
+     */
+    boost::optional<OID> closeIfExpired(Date_t when) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_backupId || _expiresAt > when) {
+            return boost::none;
+        }
+        auto backupId = _backupId;
+        _backupId = boost::none;
+        _files.clear();
+        return backupId;
+    }
+
+    bool isExpired(Date_t when) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _backupId && _expiresAt <= when;
+    }
+
+    /**
+     * Checks that 'filename' may be read from the open backup and renews the backup's expiry.
+     */
+    Status checkFile(const OID& backupId, const std::string& filename) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto status = _checkBackupId_inlock(backupId);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (_files.find(filename) == _files.end()) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "'" << filename << "' is not part of backup "
+                                        << backupId);
+        }
+        _expiresAt = expirationFromNow();
+        return Status::OK();
+    }
+
+private:
+    Status _checkBackupId_inlock(const OID& backupId) const {
+        if (!_backupId || *_backupId != backupId) {
+            return Status(ErrorCodes::NoSuchKey,
+                          str::stream() << "No open backup cursor with id " << backupId);
+        }
+        return Status::OK();
+    }
+
+    stdx::mutex _mutex;
+    boost::optional<OID> _backupId;
+    std::set<std::string> _files;
+    Date_t _expiresAt;
+} openBackup;
+
+// Serializes opening and closing the backup cursor against each other.
+stdx::mutex backupCursorMutex;
+
+// Whether the reaper job has been handed to the periodic runner. Guarded by 'backupCursorMutex'.
+bool backupCursorReaperScheduled = false;
+
+void reapExpiredBackupCursor(Client* client) {
+    if (!openBackup.isExpired(now())) {
+        return;
+    }
+
+    auto opCtx = client->makeOperationContext();
+    stdx::lock_guard<stdx::mutex> lk(backupCursorMutex);
+    Lock::GlobalLock global(opCtx.get(), MODE_IX, UINT_MAX);
+    // The backup may have been renewed or closed while the locks were acquired.
+    auto backupId = openBackup.closeIfExpired(now());
+    if (!backupId) {
+        return;
+    }
+    getGlobalServiceContext()->getGlobalStorageEngine()->endNonBlockingBackup(opCtx.get());
+
+    log() << "Closed backup cursor " << *backupId << " because it was not used for "
+          << backupCursorTimeoutSecs.load() << " seconds";
+}
+
+void scheduleBackupCursorReaper_inlock() {
+    if (backupCursorReaperScheduled) {
+        return;
+    }
+    getGlobalServiceContext()->getPeriodicRunner()->scheduleJob(
+        {reapExpiredBackupCursor, kBackupCursorReaperInterval});
+    backupCursorReaperScheduled = true;
+}
+
+OID parseBackupId(const BSONObj& cmdObj) {
+    auto backupIdElem = cmdObj["backupId"];
+    uassert(ErrorCodes::TypeMismatch,
+            "'backupId' must be the ObjectId returned by beginBackupCursor",
+            backupIdElem.type() == jstOID);
+    return backupIdElem.OID();
+}
+
+class BackupCursorCommand : public BasicCommand {
+public:
+    explicit BackupCursorCommand(StringData name) : BasicCommand(name) {}
+
+    bool slaveOk() const final {
+        return true;
+    }
+
+    bool adminOnly() const final {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const final {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) final {
+        ActionSet actions;
+        actions.addAction(ActionType::fsync);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+};
+
+class CmdBeginBackupCursor : public BackupCursorCommand {
+public:
+    CmdBeginBackupCursor() : BackupCursorCommand("beginBackupCursor") {}
+
+    void help(std::stringstream& help) const final {
+        help << "opens a backup cursor so the data files can be copied while writes continue";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) final {
+        uassert(ErrorCodes::IllegalOperation,
+                "Cannot open a backup cursor while the node is fsyncLocked",
+                !lockedForWriting());
+
+        stdx::lock_guard<stdx::mutex> lk(backupCursorMutex);
+        scheduleBackupCursorReaper_inlock();
+        // The global S lock waits for writes in progress to finish and holds off new ones until
+        // the backup cursor is open, so that the checkpoint is taken where no operation with an
+        // earlier optime than one it contains is still uncommitted. It also keeps the storage
+        // engine from shutting down and conflicts with the global lock fsyncLock holds while it
+        // enters and leaves backup mode.
+        Lock::GlobalLock global(opCtx, MODE_S, UINT_MAX);
+        StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+
+        // Nothing can be applied until the lock is released, so this is the last operation in
+        // the checkpoint below.
+        const auto checkpointOpTime =
+            repl::ReplicationCoordinator::get(opCtx)->getMyLastAppliedOpTime();
+        storageEngine->flushAllFiles(opCtx, true);
+
+        auto files = uassertStatusOK(storageEngine->beginNonBlockingBackup(opCtx));
+
+        // The storage engine metadata is needed to start a node on the copy.
+        const boost::filesystem::path dbpath(storageGlobalParams.dbpath);
+        if (boost::filesystem::exists(dbpath / "storage.bson")) {
+            files.push_back("storage.bson");
+        }
+
+        auto swBackupId = openBackup.open(files);
+        if (!swBackupId.isOK()) {
+            storageEngine->endNonBlockingBackup(opCtx);
+            return appendCommandStatus(result, swBackupId.getStatus());
+        }
+
+        result.append("backupId", swBackupId.getValue());
+        if (!checkpointOpTime.isNull()) {
+            checkpointOpTime.append(&result, "checkpointOpTime");
+        }
+        result.append("dbpath", storageGlobalParams.dbpath);
+        BSONArrayBuilder filesBuilder(result.subarrayStart("files"));
+        for (const auto& file : files) {
+            boost::system::error_code ec;
+            const auto fileSize = boost::filesystem::file_size(dbpath / file, ec);
+            filesBuilder.append(BSON("filename" << file << "fileSize"
+                                                << static_cast<long long>(ec ? 0 : fileSize)));
+        }
+        filesBuilder.doneFast();
+
+        log() << "Opened backup cursor " << swBackupId.getValue() << " with " << files.size()
+              << " files, checkpoint optime " << checkpointOpTime;
+        return true;
+    }
+} cmdBeginBackupCursor;
+
+class CmdReadBackupFile : public BackupCursorCommand {
+public:
+    CmdReadBackupFile() : BackupCursorCommand("readBackupFile") {}
+
+    void help(std::stringstream& help) const final {
+        help << "reads a chunk of a file listed by beginBackupCursor";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) final {
+        const auto backupId = parseBackupId(cmdObj);
+        auto filenameElem = cmdObj.firstElement();
+        uassert(ErrorCodes::TypeMismatch,
+                "readBackupFile must name a file listed by beginBackupCursor",
+                filenameElem.type() == String);
+        const auto filename = filenameElem.String();
+
+        const long long offset = cmdObj["offset"].safeNumberLong();
+        uassert(ErrorCodes::BadValue, "'offset' must not be negative", offset >= 0);
+        long long length = kMaxReadBackupFileBytes;
+        if (cmdObj.hasField("length")) {
+            length = cmdObj["length"].safeNumberLong();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "'length' must be between 1 and " << kMaxReadBackupFileBytes,
+                    length > 0 && length <= kMaxReadBackupFileBytes);
+        }
+
+        uassertStatusOK(openBackup.checkFile(backupId, filename));
+
+        const auto path = boost::filesystem::path(storageGlobalParams.dbpath) / filename;
+        std::ifstream file(path.string(), std::ios::in | std::ios::binary);
+        uassert(ErrorCodes::FileNotOpen,
+                str::stream() << "Failed to open " << path.string(),
+                file.is_open());
+
+        std::vector<char> buffer(length);
+        file.seekg(offset);
+        file.read(buffer.data(), length);
+        const auto bytesRead = file.gcount();
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to read " << path.string() << " at offset " << offset,
+                !file.bad());
+
+        result.appendBinData("data", bytesRead, BinDataGeneral, buffer.data());
+        result.append("offset", offset);
+        result.append("eof", bytesRead < length);
+        return true;
+    }
+} cmdReadBackupFile;
+
+class CmdEndBackupCursor : public BackupCursorCommand {
+public:
+    CmdEndBackupCursor() : BackupCursorCommand("endBackupCursor") {}
+
+    void help(std::stringstream& help) const final {
+        help << "closes the backup cursor opened by beginBackupCursor";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) final {
+        const auto backupId = parseBackupId(cmdObj);
+
+        stdx::lock_guard<stdx::mutex> lk(backupCursorMutex);
+        Lock::GlobalLock global(opCtx, MODE_IX, UINT_MAX);
+        uassertStatusOK(openBackup.close(backupId));
+        getGlobalServiceContext()->getGlobalStorageEngine()->endNonBlockingBackup(opCtx);
+
+        log() << "Closed backup cursor " << backupId;
+        return true;
+    }
+} cmdEndBackupCursor;
+
+}  // namespace
+}  // namespace mongo
@@ -143,6 +143,7 @@ void makeUpdateRequest(const FindAndModifyRequest& args,
     requestOut->setProj(args.getFields());
     requestOut->setUpdates(args.getUpdateObj());
     requestOut->setSort(args.getSort());
+    requestOut->setAllowDiskUse(args.allowDiskUse());
     requestOut->setCollation(args.getCollation());
     requestOut->setArrayFilters(args.getArrayFilters());
     requestOut->setUpsert(args.isUpsert());
@@ -158,6 +159,7 @@ void makeDeleteRequest(const FindAndModifyRequest& args, bool explain, DeleteReq
     requestOut->setQuery(args.getQuery());
     requestOut->setProj(args.getFields());
     requestOut->setSort(args.getSort());
+    requestOut->setAllowDiskUse(args.allowDiskUse());
     requestOut->setCollation(args.getCollation());
     requestOut->setMulti(false);
     requestOut->setYieldPolicy(PlanExecutor::YIELD_AUTO);
@@ -32,12 +32,15 @@
 #include "mongo/db/catalog/coll_mod.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/commands/feature_compatibility_version_command_parser.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keys_collection_document.h"
 #include "mongo/db/logical_time_validator.h"
 #include "mongo/db/repl/repl_client_info.h"
@@ -59,6 +62,47 @@ namespace {
 
 MONGO_FP_DECLARE(featureCompatibilityDowngrade);
 MONGO_FP_DECLARE(featureCompatibilityUpgrade);
+
+/**
+ * Fails if an index stores its entries in a format that 3.4 binaries can't open, such as the
+ * compact keys written by WiredTiger nodes started with --wiredTigerIndexCompactKeys.
+ */
+void uassertNoIndexesRequiring36(OperationContext* opCtx) {
+    std::vector<std::string> dbNames;
+    StorageEngine* storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    {
+        Lock::GlobalLock lk(opCtx, MODE_IS, UINT_MAX);
+        storageEngine->listDatabases(&dbNames);
+    }
+
+    for (auto&& dbName : dbNames) {
+        AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+        Database* const db = autoDb.getDb();
+        if (!db) {
+            continue;
+        }
+        for (auto collectionIt = db->begin(); collectionIt != db->end(); ++collectionIt) {
+            Collection* coll = *collectionIt;
+            Lock::CollectionLock collLock(opCtx->lockState(), coll->ns().ns(), MODE_IS);
+            IndexCatalog* indexCatalog = coll->getIndexCatalog();
+            auto indexIt = indexCatalog->getIndexIterator(opCtx, true);
+            while (indexIt.more()) {
+                const IndexDescriptor* desc = indexIt.next();
+                uassert(ErrorCodes::IllegalOperation,
+                        str::stream() << "cannot downgrade the featureCompatibilityVersion to "
+                                      << FeatureCompatibilityVersionCommandParser::kVersion34
+                                      << " while the index '"
+                                      << desc->indexName()
+                                      << "' on "
+                                      << coll->ns().ns()
+                                      << " stores compact keys; rebuild the index on a node "
+                                         "started without --wiredTigerIndexCompactKeys first",
+                        !indexCatalog->getIndex(desc)->requiresFeatureCompatibilityVersion36());
+            }
+        }
+    }
+}
+
 /**
  * Sets the minimum allowed version for the cluster. If it is 3.4, then the node should not use 3.6
  * features.
@@ -204,8 +248,14 @@ public:
                 return true;
             }
 
+            uassertNoIndexesRequiring36(opCtx);
+
             FeatureCompatibilityVersion::setTargetDowngrade(opCtx);
 
+            // No new compact keys indexes are created from here on, but one may have been created
+            // since the check above.
+            uassertNoIndexesRequiring36(opCtx);
+
             // Fail after updating the FCV document but before removing UUIDs.
             if (MONGO_FAIL_POINT(featureCompatibilityDowngrade)) {
                 exitCleanly(EXIT_CLEAN);
@@ -41,6 +41,7 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -490,12 +491,24 @@ void LockHead::migratePartitionedLockHeads() {
 //CmdLockInfo::run    db.runCommand({lockInfo: 1})ȡϢ
 const unsigned LockManager::_numLockBuckets(128); //źĬϸֵ128   ȫͰпͻ
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+namespace {
+// Balance scalability of intent locks against potential added cost of conflicting locks, which
+// have to visit every partition holding intent locks on their resource. Lockers are spread over
+// the partitions by id, so there are at least twice as many partitions as cores to keep lockers
+// running at the same time from sharing one. Should be a power of two.
+unsigned numLockManagerPartitions() {
+    const unsigned kMinPartitions = 32;
+    const unsigned kMaxPartitions = 1024;
+    unsigned partitions = kMinPartitions;
+    while (partitions < kMaxPartitions && partitions < 2 * stdx::thread::hardware_concurrency()) {
+        partitions *= 2;
+    }
+    return partitions;
+}
+}  // namespace
 
 //LockManager::LockManager()  _numLockBucketsĬ128
-LockManager::LockManager() {
+LockManager::LockManager() : _numPartitions(numLockManagerPartitions()) {
     _lockBuckets = new LockBucket[_numLockBuckets]; //128
     _partitions = new Partition[_numPartitions]; //32
 }
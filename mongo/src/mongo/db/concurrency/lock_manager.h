@@ -141,6 +141,10 @@ private:
     // The lockheads need access to the partitions
     friend struct LockHead;
 
+    // Buckets and partitions are each used by many threads. Padding each by this much keeps
+    // neighbouring ones from sharing a cache line.
+    static const size_t kCacheLineSize = 64;
+
     // These types describe the locks hash table
     //LockManager._lockBuckets
     //ÿBucketResourceId->LockHeadĹϣùϣBucketеmutex
@@ -152,6 +156,8 @@ private:
         typedef unordered_map<ResourceId, LockHead*> Map;
         Map data; //data<ResourceId, LockHead*>
         LockHead* findOrInsert(ResourceId resId);
+
+        char padding[kCacheLineSize];
     };
 
     // Each locker maps to a partition that is used for resources acquired in intent modes
@@ -166,6 +172,8 @@ private:
         SimpleMutex mutex;
         //LockManager::Partition::find  LockManager::Partition::findOrInsert
         Map data; //dataΪ<ResourceId, PartitionedLockHead>  
+
+        char padding[kCacheLineSize];
     };
 
     /**
@@ -235,7 +243,7 @@ private:
     LockBucket* _lockBuckets; //
 
     //_partitions = new Partition[_numPartitions]; //32
-    static const unsigned _numPartitions;
+    const unsigned _numPartitions;
     //ÿresIdӦһPartitionedLockHeadṹLockManager._partitions[]
     Partition* _partitions; //
 };
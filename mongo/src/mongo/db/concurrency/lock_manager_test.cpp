@@ -28,6 +28,7 @@
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -951,4 +952,37 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, ConflictWaitsForIntentLocksInAllPartitions) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    // Enough lockers to hold intent locks in every partition, however many there are.
+    const size_t kNumIntentLockers = 2048;
+    std::vector<std::unique_ptr<MMAPV1LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (size_t i = 0; i < kNumIntentLockers; ++i) {
+        lockers.push_back(stdx::make_unique<MMAPV1LockerImpl>());
+        requests.push_back(stdx::make_unique<LockRequestCombo>(lockers.back().get()));
+        ASSERT(LOCK_OK == lockMgr.lock(resId, requests.back().get(), i % 2 ? MODE_IX : MODE_IS));
+    }
+
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    // The X lock is granted only once the last intent lock is released.
+    for (size_t i = 0; i < kNumIntentLockers; ++i) {
+        ASSERT_EQ(0, requestX.numNotifies);
+        ASSERT(lockMgr.unlock(requests[i].get()));
+    }
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+
+    // Intent locks can be partitioned again after the X lock is released.
+    ASSERT(lockMgr.unlock(&requestX));
+    LockRequestCombo requestIX(lockers[0].get());
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+    ASSERT(lockMgr.unlock(&requestIX));
+}
+
 }  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/child_result_buffer.h"
+
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+void ChildResultBuffer::fill(PlanStage* child, WorkingSet* ws, size_t maxWorks) {
+    if (!empty()) {
+        return;
+    }
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID endId = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = child->workBatch(ws, maxWorks, &batch, &endId);
+    _ids.assign(batch.begin(), batch.end());
+
+    if (PlanStage::NEED_TIME != state) {
+        _hasEndState = true;
+        _endState = state;
+        _endId = endId;
+    }
+}
+
+PlanStage::StageState ChildResultBuffer::next(PlanStage* child, WorkingSetID* out) {
+    if (!_ids.empty()) {
+        *out = _ids.front();
+        _ids.pop_front();
+        return PlanStage::ADVANCED;
+    }
+
+    if (_hasEndState) {
+        _hasEndState = false;
+        *out = _endId;
+        return _endState;
+    }
+
+    return child->work(out);
+}
+
+bool ChildResultBuffer::isEOF(PlanStage* child) const {
+    if (!_ids.empty() || (_hasEndState && PlanStage::IS_EOF != _endState)) {
+        return false;
+    }
+    return child->isEOF();
+}
+
+void ChildResultBuffer::invalidate(WorkingSet* ws, const RecordId& dl, InvalidationType type) {
+    for (auto it = _ids.begin(); it != _ids.end();) {
+        WorkingSetMember* member = ws->get(*it);
+        if (!member->hasRecordId() || member->recordId != dl) {
+            ++it;
+            continue;
+        }
+
+        if (INVALIDATION_DELETION == type) {
+            ws->free(*it);
+            it = _ids.erase(it);
+            continue;
+        }
+
+        if (member->hasObj()) {
+            if (!member->obj.value().isOwned()) {
+                member->obj.setValue(member->obj.value().getOwned());
+            }
+            ws->transitionToOwnedObj(*it);
+        } else {
+            member->isSuspicious = true;
+        }
+        ++it;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/invalidation_type.h"
+
+namespace mongo {
+
+class RecordId;
+
+/**
+ * Lets a stage with a single child pull its input in batches through PlanStage::workBatch()
+ * while keeping the result-at-a-time logic of its doWork(). A stage using this calls
+ * next() where it would otherwise call child()->work(), and from its doWorkBatch() does:
+ *
+ *     _childResults.fill(child().get(), _ws, maxWorks);
+ *     return workBatchLoop(ws, maxWorks, batch, out, [this] { return !_childResults.empty(); });
+ *
+ * Buffered results are not yet owned by the consuming stage, so it must also forward
+ * invalidations to invalidate() and account for the buffer in isEOF().
+ */
+class ChildResultBuffer {
+public:
+    /**
+     * If nothing is buffered, asks 'child' for up to 'maxWorks' units of work and buffers the
+     * results along with the state that ended the batch. Does nothing otherwise.
+     */
+    void fill(PlanStage* child, WorkingSet* ws, size_t maxWorks);
+
+    /**
+     * Hands out the buffered results as ADVANCED, then the state which ended the batch. Once
+     * the buffer is drained this is the same as child->work(out).
+     */
+    PlanStage::StageState next(PlanStage* child, WorkingSetID* out);
+
+    bool empty() const {
+        return _ids.empty() && !_hasEndState;
+    }
+
+    /**
+     * Returns true if nothing but an IS_EOF is buffered and 'child' is at EOF.
+     */
+    bool isEOF(PlanStage* child) const;
+
+    /**
+     * Updates any buffered result for 'dl'. A deleted record's result is dropped. A mutated
+     * record's result keeps its (owned) object but loses the RecordId, or, for index-only
+     * results, is marked suspicious so that a fetch will recheck it against the document.
+     */
+    void invalidate(WorkingSet* ws, const RecordId& dl, InvalidationType type);
+
+private:
+    std::deque<WorkingSetID> _ids;
+
+    // Set if the last batch ended with something other than NEED_TIME, which must be passed
+    // on once the buffered results have been consumed.
+    bool _hasEndState = false;
+    PlanStage::StageState _endState = PlanStage::NEED_TIME;
+    WorkingSetID _endId = WorkingSet::INVALID_ID;
+};
+
+}  // namespace mongo
@@ -0,0 +1,185 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+//
+// This file contains tests for batched execution through PlanStage::workBatch() and
+// mongo/db/exec/child_result_buffer.cpp.
+//
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/child_result_buffer.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/exec/limit.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/skip.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+class ChildResultBufferTest : public unittest::Test {
+public:
+    ChildResultBufferTest() {
+        _service = stdx::make_unique<ServiceContextNoop>();
+        _service->setFastClockSource(stdx::make_unique<ClockSourceMock>());
+        _client = _service->makeClient("test");
+        _opCtx = _client->makeOperationContext();
+    }
+
+protected:
+    OperationContext* getOpCtx() {
+        return _opCtx.get();
+    }
+
+    /**
+     * Returns a QueuedDataStage producing one owned document {a: i} with RecordId i for every i
+     * in [0, numDocs), each followed by a NEED_TIME.
+     */
+    std::unique_ptr<QueuedDataStage> makeQueuedStage(WorkingSet* ws, int numDocs) {
+        auto queued = stdx::make_unique<QueuedDataStage>(getOpCtx(), ws);
+        for (int i = 0; i < numDocs; ++i) {
+            WorkingSetID id = ws->allocate();
+            WorkingSetMember* member = ws->get(id);
+            member->recordId = RecordId(i);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << i));
+            ws->transitionToRecordIdAndObj(id);
+            queued->pushBack(id);
+            queued->pushBack(PlanStage::NEED_TIME);
+        }
+        return queued;
+    }
+
+    int getA(WorkingSet* ws, WorkingSetID id) {
+        return ws->get(id)->obj.value()["a"].numberInt();
+    }
+
+private:
+    // The UniqueClient must be destroyed before the ServiceContextNoop, and the
+    // UniqueOperationContext before the UniqueClient.
+    std::unique_ptr<ServiceContextNoop> _service;
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(ChildResultBufferTest, WorkBatchReturnsSameResultsAsWork) {
+    WorkingSet ws;
+    SkipStage skip(getOpCtx(), 2, &ws, makeQueuedStage(&ws, 10).release());
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (PlanStage::NEED_TIME == state) {
+        state = skip.workBatch(&ws, 3, &batch, &out);
+    }
+
+    ASSERT_EQUALS(PlanStage::IS_EOF, state);
+    ASSERT_TRUE(skip.isEOF());
+    ASSERT_EQUALS(8U, batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        ASSERT_EQUALS(static_cast<int>(i) + 2, getA(&ws, batch[i]));
+    }
+    ASSERT_EQUALS(8U, skip.getCommonStats()->advanced);
+}
+
+TEST_F(ChildResultBufferTest, WorkBatchAndWorkCanBeInterleaved) {
+    WorkingSet ws;
+    SkipStage skip(getOpCtx(), 0, &ws, makeQueuedStage(&ws, 4).release());
+
+    // A batch of one unit of work reads ahead a single result from the child.
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_TIME, skip.workBatch(&ws, 1, &batch, &out));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(0, getA(&ws, batch[0]));
+
+    std::vector<int> seen;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state;
+    while (PlanStage::IS_EOF != (state = skip.work(&id))) {
+        if (PlanStage::ADVANCED == state) {
+            seen.push_back(getA(&ws, id));
+        }
+    }
+    ASSERT_EQUALS(3U, seen.size());
+    ASSERT_EQUALS(1, seen[0]);
+    ASSERT_EQUALS(2, seen[1]);
+    ASSERT_EQUALS(3, seen[2]);
+}
+
+TEST_F(ChildResultBufferTest, LimitDoesNotReadPastItsLimit) {
+    WorkingSet ws;
+    auto queued = makeQueuedStage(&ws, 10);
+    QueuedDataStage* queuedPtr = queued.get();
+    LimitStage limit(getOpCtx(), 2, &ws, queued.release());
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (PlanStage::NEED_TIME == state) {
+        state = limit.workBatch(&ws, 100, &batch, &out);
+    }
+
+    ASSERT_EQUALS(PlanStage::IS_EOF, state);
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_FALSE(queuedPtr->isEOF());
+    ASSERT_LESS_THAN_OR_EQUALS(queuedPtr->getCommonStats()->works, 4U);
+}
+
+TEST_F(ChildResultBufferTest, InvalidationDropsDeletedAndDetachesMutatedResults) {
+    WorkingSet ws;
+    auto queued = makeQueuedStage(&ws, 3);
+    QueuedDataStage* queuedPtr = queued.get();
+    ChildResultBuffer buffer;
+    buffer.fill(queuedPtr, &ws, 6);
+
+    buffer.invalidate(&ws, RecordId(0), INVALIDATION_DELETION);
+    buffer.invalidate(&ws, RecordId(1), INVALIDATION_MUTATION);
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, buffer.next(queuedPtr, &id));
+    ASSERT_EQUALS(1, getA(&ws, id));
+    ASSERT_EQUALS(WorkingSetMember::OWNED_OBJ, ws.get(id)->getState());
+
+    ASSERT_EQUALS(PlanStage::ADVANCED, buffer.next(queuedPtr, &id));
+    ASSERT_EQUALS(2, getA(&ws, id));
+    ASSERT_EQUALS(WorkingSetMember::RID_AND_OBJ, ws.get(id)->getState());
+
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_TRUE(buffer.isEOF(queuedPtr));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,9 +35,12 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/parallel_batch.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
@@ -55,6 +58,61 @@ using stdx::make_unique;
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
+namespace {
+
+/**
+ * Returns true if 'expr' can be matched against different documents from several threads at
+ * once. Rules out anything running JavaScript or aggregation expressions, which keep state
+ * between evaluations, as well as string comparisons under a collation.
+ */
+bool canMatchConcurrently(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            if (static_cast<const ComparisonMatchExpression*>(expr)->getCollator()) {
+                return false;
+            }
+            break;
+        case MatchExpression::MATCH_IN:
+            if (static_cast<const InMatchExpression*>(expr)->getCollator()) {
+                return false;
+            }
+            break;
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+        case MatchExpression::ELEM_MATCH_OBJECT:
+        case MatchExpression::ELEM_MATCH_VALUE:
+        case MatchExpression::SIZE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR:
+        case MatchExpression::TYPE_OPERATOR:
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE:
+            break;
+        default:
+            return false;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchConcurrently(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 /*
 (gdb) bt
 #0  mongo::CollectionScan::CollectionScan (this=0x7f644e182000, opCtx=<optimized out>, params=..., workingSet=<optimized out>, filter=<optimized out>) at src/mongo/db/exec/collection_scan.cpp:71
@@ -246,6 +304,96 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {//PlanStage::wo
     return returnIfMatches(member, id, out); //CollectionScan::returnIfMatches
 }
 
+PlanStage::StageState CollectionScan::doWorkBatch(WorkingSet* ws,
+                                                  size_t maxWorks,
+                                                  std::vector<WorkingSetID>* batch,
+                                                  WorkingSetID* out) {
+    // Only the steady state of a plain forward or backward scan is batched. Opening or
+    // re-seeking the cursor, tailing, scan bounds and the oplog-specific options all go
+    // through doWork() one unit at a time.
+    const bool canBatch = _cursor && !_isDead && !_commonStats.isEOF && !_params.tailable &&
+        0 == _params.maxScan && !_endCondition && !_params.stopApplyingFilterAfterFirstMatch &&
+        !_params.shouldTrackLatestOplogTimestamp &&
+        !(_lastSeenId.isNull() && !_params.start.isNull());
+    if (!canBatch) {
+        return PlanStage::doWorkBatch(ws, maxWorks, batch, out);
+    }
+
+    // First read a run of records, then run the filter over all of them, so that the cursor
+    // code and the matcher each stay hot for a whole batch rather than alternating per record.
+    const size_t firstNew = batch->size();
+    StageState endState = PlanStage::NEED_TIME;
+    try {
+        while (batch->size() - firstNew < maxWorks) {
+            if (_cursor->fetcherForNext()) {
+                // The next record isn't in memory. Let doWork() pass the fetch request up.
+                break;
+            }
+
+            boost::optional<Record> record = _cursor->next();
+            if (!record) {
+                _commonStats.isEOF = true;
+                endState = PlanStage::IS_EOF;
+                break;
+            }
+
+            _lastSeenId = record->id;
+            WorkingSetID id = _workingSet->allocate();
+            WorkingSetMember* member = _workingSet->get(id);
+            member->recordId = record->id;
+            // The cursor moves on before the batch is handed out, so each record must be owned.
+            member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(),
+                           record->data.releaseToBson().getOwned()};
+            _workingSet->transitionToRecordIdAndObj(id);
+            batch->push_back(id);
+        }
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        endState = PlanStage::NEED_YIELD;
+    }
+
+    if (batch->size() == firstNew && PlanStage::NEED_TIME == endState) {
+        return PlanStage::doWorkBatch(ws, 1, batch, out);
+    }
+
+    // The records are owned and the cursor is not touched while filtering, so when the filter
+    // allows it the matching can be split across worker threads.
+    std::vector<char> matched(batch->size() - firstNew);
+    auto matchRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            matched[i] = Filter::passes(_workingSet->get((*batch)[firstNew + i]), _filter);
+        }
+    };
+    const int maxWorkers = internalQueryExecParallelWorkers.load();
+    if (maxWorkers > 1 && _filter && canMatchConcurrently(_filter)) {
+        parallel_batch::forEachChunk(matched.size(),
+                                     maxWorkers,
+                                     internalQueryExecParallelMinItemsPerWorker.load(),
+                                     matchRange);
+    } else {
+        matchRange(0, matched.size());
+    }
+
+    size_t numKept = firstNew;
+    for (size_t i = firstNew; i < batch->size(); ++i) {
+        const WorkingSetID id = (*batch)[i];
+        ++_specificStats.docsTested;
+        if (matched[i - firstNew]) {
+            (*batch)[numKept++] = id;
+            recordWork(PlanStage::ADVANCED);
+        } else {
+            _workingSet->free(id);
+            recordWork(PlanStage::NEED_TIME);
+        }
+    }
+    batch->resize(numKept);
+
+    if (PlanStage::NEED_TIME != endState) {
+        recordWork(endState);
+    }
+    return endState;
+}
+
 Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
@@ -71,7 +71,7 @@ bool FetchStage::isEOF() {
         return false;
     }
 
-    return child()->isEOF();
+    return _childResults.isEOF(child().get());
 }
 
 /*
@@ -114,7 +114,7 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     WorkingSetID id;
     StageState status;
     if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id); //ʵǵIndexScan::doWork
+        status = _childResults.next(child().get(), &id); //ʵǵIndexScan::doWork
     } else {
         status = ADVANCED;
         id = _idRetrying;
@@ -185,6 +185,20 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(WorkingSet* ws,
+                                              size_t maxWorks,
+                                              std::vector<WorkingSetID>* batch,
+                                              WorkingSetID* out) {
+    // Read a run of record ids from our child up front, then fetch and filter them one at a
+    // time. A pending retry is finished first, on its own.
+    if (WorkingSet::INVALID_ID == _idRetrying) {
+        _childResults.fill(child().get(), _ws, maxWorks);
+    }
+    return workBatchLoop(ws, maxWorks, batch, out, [this] {
+        return WorkingSet::INVALID_ID != _idRetrying || !_childResults.empty();
+    });
+}
+
 void FetchStage::doSaveState() {
     if (_cursor)
         _cursor->saveUnpositioned();
@@ -215,6 +229,8 @@ void FetchStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inval
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    _childResults.invalidate(_ws, dl, type);
 }
 
 //FetchStage::doWork
@@ -30,6 +30,7 @@
 
 #include <memory>
 
+#include "mongo/db/exec/child_result_buffer.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
@@ -59,6 +60,10 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -100,6 +105,9 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Record ids read ahead from our child by doWorkBatch().
+    ChildResultBuffer _childResults;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -271,6 +271,10 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) { //PlanStage::work
 
     _scanState = GETTING_NEXT;
 
+    return returnIfMatches(&*kv, out);
+}
+
+PlanStage::StageState IndexScan::returnIfMatches(IndexKeyEntry* kv, WorkingSetID* out) {
     if (_shouldDedup) {
         ++_specificStats.dupsTested;
         if (!_returned.insert(kv->loc).second) {
@@ -307,6 +311,49 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) { //PlanStage::work
     return PlanStage::ADVANCED;
 }
 
+PlanStage::StageState IndexScan::doWorkBatch(WorkingSet* ws,
+                                             size_t maxWorks,
+                                             std::vector<WorkingSetID>* batch,
+                                             WorkingSetID* out) {
+    // Only the steady state of a scan over a contiguous range is batched. Opening the cursor,
+    // seeking past keys rejected by the bounds checker and maxScan all go through doWork() one
+    // unit at a time. Without those, only reaching the end of the range ends GETTING_NEXT.
+    if (GETTING_NEXT != _scanState || _checker || _params.maxScan) {
+        return PlanStage::doWorkBatch(ws, maxWorks, batch, out);
+    }
+
+    for (size_t i = 0; i < maxWorks; ++i) {
+        boost::optional<IndexKeyEntry> kv;
+        try {
+            kv = _indexCursor->next();
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            recordWork(PlanStage::NEED_YIELD);
+            return PlanStage::NEED_YIELD;
+        }
+
+        if (!kv) {
+            _scanState = HIT_END;
+            _commonStats.isEOF = true;
+            _indexCursor.reset();
+            recordWork(PlanStage::IS_EOF);
+            return PlanStage::IS_EOF;
+        }
+
+        ++_specificStats.keysExamined;
+
+        // returnIfMatches() makes the key owned, so it survives the cursor moving on.
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        const StageState state = returnIfMatches(&*kv, &id);
+        recordWork(state);
+        if (PlanStage::ADVANCED == state) {
+            batch->push_back(id);
+        }
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
@@ -96,6 +96,10 @@ public:
               const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
     bool isEOF() final;
     void doSaveState() final;
     void doRestoreState() final;
@@ -119,6 +123,13 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Dedups and filters the index entry 'kv', which is within the bounds of the scan. If it is to
+     * be returned, makes its key owned, adds it to the working set and returns ADVANCED with the
+     * new member in *out. Otherwise returns NEED_TIME.
+     */
+    StageState returnIfMatches(IndexKeyEntry* kv, WorkingSetID* out);
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
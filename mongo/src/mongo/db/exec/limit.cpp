@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/limit.h"
 
+#include <algorithm>
+
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/stdx/memory.h"
@@ -51,7 +53,7 @@ LimitStage::LimitStage(OperationContext* opCtx, long long limit, WorkingSet* ws,
 LimitStage::~LimitStage() {}
 
 bool LimitStage::isEOF() {
-    return (0 == _numToReturn) || child()->isEOF();
+    return (0 == _numToReturn) || _childResults.isEOF(child().get());
 }
 
 PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
@@ -61,7 +63,7 @@ PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
     }
 
     WorkingSetID id = WorkingSet::INVALID_ID;
-    StageState status = child()->work(&id);
+    StageState status = _childResults.next(child().get(), &id);
 
     if (PlanStage::ADVANCED == status) {
         *out = id;
@@ -86,6 +88,23 @@ PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState LimitStage::doWorkBatch(WorkingSet* ws,
+                                              size_t maxWorks,
+                                              std::vector<WorkingSetID>* batch,
+                                              WorkingSetID* out) {
+    // Never ask our child for more results than we may still return.
+    if (_numToReturn > 0) {
+        _childResults.fill(
+            child().get(), _ws, std::min(maxWorks, static_cast<size_t>(_numToReturn)));
+    }
+    return workBatchLoop(
+        ws, maxWorks, batch, out, [this] { return 0 == _numToReturn || !_childResults.empty(); });
+}
+
+void LimitStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) {
+    _childResults.invalidate(_ws, dl, type);
+}
+
 unique_ptr<PlanStageStats> LimitStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_LIMIT);
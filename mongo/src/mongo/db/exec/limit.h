@@ -29,6 +29,7 @@
 #pragma once
 
 
+#include "mongo/db/exec/child_result_buffer.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
@@ -49,6 +50,12 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
+
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_LIMIT;
@@ -66,6 +73,9 @@ private:
     // We only return this many results.
     long long _numToReturn;
 
+    // Results read ahead from our child by doWorkBatch().
+    ChildResultBuffer _childResults;
+
     // Stats
     LimitStats _specificStats;
 };
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_batch.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace parallel_batch {
+
+namespace {
+
+/**
+ * The pool is created on first use and deliberately never destroyed, since queries may still be
+ * running when static destructors run at shutdown.
+ */
+ThreadPool* getPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "QueryExecWorkerPool";
+        options.threadNamePrefix = "QueryExecWorker-";
+        options.minThreads = 0;
+        options.maxThreads = std::max(1u, ProcessInfo().getNumCores());
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
+size_t numChunks(size_t numItems, size_t maxWorkers, size_t minItemsPerChunk) {
+    const size_t bySize = numItems / std::max(minItemsPerChunk, size_t(1));
+    return std::max(size_t(1), std::min(maxWorkers, bySize));
+}
+
+void forEachChunk(size_t numItems,
+                  size_t maxWorkers,
+                  size_t minItemsPerChunk,
+                  const stdx::function<void(size_t begin, size_t end)>& fn) {
+    if (0 == numItems) {
+        return;
+    }
+
+    const size_t chunks = numChunks(numItems, maxWorkers, minItemsPerChunk);
+    if (1 == chunks) {
+        fn(0, numItems);
+        return;
+    }
+
+    const size_t chunkSize = (numItems + chunks - 1) / chunks;
+
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t numPending = 0;
+    std::exception_ptr firstError;
+
+    auto runChunk = [&](size_t begin, size_t end) {
+        std::exception_ptr error;
+        try {
+            fn(begin, end);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (error) {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (!firstError) {
+                firstError = error;
+            }
+        }
+    };
+
+    for (size_t begin = chunkSize; begin < numItems; begin += chunkSize) {
+        const size_t end = std::min(begin + chunkSize, numItems);
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++numPending;
+        }
+        Status scheduled = getPool()->schedule([&, begin, end] {
+            runChunk(begin, end);
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (0 == --numPending) {
+                allDone.notify_all();
+            }
+        });
+        if (!scheduled.isOK()) {
+            // The pool is shutting down. Do the work here instead.
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                --numPending;
+            }
+            runChunk(begin, end);
+        }
+    }
+
+    runChunk(0, std::min(chunkSize, numItems));
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    allDone.wait(lk, [&] { return 0 == numPending; });
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+}  // namespace parallel_batch
+}  // namespace mongo
@@ -0,0 +1,61 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/stdx/functional.h"
+
+namespace mongo {
+namespace parallel_batch {
+
+/**
+ * Returns how many chunks forEachChunk() will split 'numItems' items into: at most 'maxWorkers',
+ * and few enough that each chunk has at least 'minItemsPerChunk' items. Always at least one.
+ */
+size_t numChunks(size_t numItems, size_t maxWorkers, size_t minItemsPerChunk);
+
+/**
+ * Calls 'fn(begin, end)' over consecutive, non-overlapping ranges covering [0, numItems), as split
+ * by numChunks(). The calling thread runs the first range itself and the others are handed to a
+ * process-wide pool of worker threads. Returns once every range has been processed; if any call
+ * threw, the first exception is then rethrown.
+ *
+ * 'fn' runs on threads with no Client or OperationContext, so it may only compute over data that
+ * is owned and not modified concurrently, and must not touch storage or any other per-operation
+ * state. Each call must only write to the part of its output belonging to its own range.
+ */
+void forEachChunk(size_t numItems,
+                  size_t maxWorkers,
+                  size_t minItemsPerChunk,
+                  const stdx::function<void(size_t begin, size_t end)>& fn);
+
+}  // namespace parallel_batch
+}  // namespace mongo
@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_batch.h"
+
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+TEST(ParallelBatchTest, NumChunksRespectsWorkerAndChunkSizeLimits) {
+    ASSERT_EQ(1U, parallel_batch::numChunks(0, 8, 10));
+    ASSERT_EQ(1U, parallel_batch::numChunks(100, 0, 10));
+    ASSERT_EQ(1U, parallel_batch::numChunks(100, 1, 10));
+    ASSERT_EQ(1U, parallel_batch::numChunks(19, 8, 10));
+    ASSERT_EQ(2U, parallel_batch::numChunks(20, 8, 10));
+    ASSERT_EQ(8U, parallel_batch::numChunks(1000, 8, 10));
+    ASSERT_EQ(8U, parallel_batch::numChunks(8, 8, 0));
+}
+
+TEST(ParallelBatchTest, EveryItemIsVisitedExactlyOnce) {
+    for (size_t numItems : {0, 1, 7, 64, 1000, 1001}) {
+        std::vector<int> visits(numItems, 0);
+        AtomicUInt32 numCalls;
+        parallel_batch::forEachChunk(numItems, 4, 1, [&](size_t begin, size_t end) {
+            ASSERT_LT(begin, end);
+            numCalls.fetchAndAdd(1);
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+        for (size_t i = 0; i < numItems; ++i) {
+            ASSERT_EQ(1, visits[i]);
+        }
+        if (numItems > 0) {
+            ASSERT_EQ(parallel_batch::numChunks(numItems, 4, 1), numCalls.load());
+        }
+    }
+}
+
+TEST(ParallelBatchTest, ExceptionIsRethrownAfterAllChunksFinish) {
+    std::vector<int> visits(100, 0);
+    ASSERT_THROWS_CODE(parallel_batch::forEachChunk(100,
+                                                    4,
+                                                    1,
+                                                    [&](size_t begin, size_t end) {
+                                                        for (size_t i = begin; i < end; ++i) {
+                                                            ++visits[i];
+                                                        }
+                                                        uassert(ErrorCodes::BadValue,
+                                                                "chunk failed",
+                                                                begin != 0);
+                                                    }),
+                       AssertionException,
+                       ErrorCodes::BadValue);
+    for (int v : visits) {
+        ASSERT_EQ(1, v);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
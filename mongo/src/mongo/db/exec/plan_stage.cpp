@@ -110,6 +110,47 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {   //
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(WorkingSet* ws,
+                                           size_t maxWorks,
+                                           std::vector<WorkingSetID>* batch,
+                                           WorkingSetID* out) {
+    invariant(_opCtx);
+    invariant(maxWorks > 0);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    return doWorkBatch(ws, maxWorks, batch, out);
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(WorkingSet* ws,
+                                             size_t maxWorks,
+                                             std::vector<WorkingSetID>* batch,
+                                             WorkingSetID* out) {
+    return workBatchLoop(ws, maxWorks, batch, out, [] { return true; });
+}
+
+PlanStage::StageState PlanStage::workBatchLoop(WorkingSet* ws,
+                                               size_t maxWorks,
+                                               std::vector<WorkingSetID>* batch,
+                                               WorkingSetID* out,
+                                               const stdx::function<bool()>& keepGoing) {
+    for (size_t i = 0; i < maxWorks && keepGoing(); ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        recordWork(state);
+
+        if (StageState::ADVANCED == state) {
+            // The next unit of work may move a storage engine cursor out from under an unowned
+            // result, so results must be owned before we go on.
+            ws->get(id)->makeObjOwnedIfNeeded();
+            batch->push_back(id);
+        } else if (StageState::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return StageState::NEED_TIME;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
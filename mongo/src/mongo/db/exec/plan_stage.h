@@ -34,6 +34,7 @@
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/invalidation_type.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -189,6 +190,27 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Performs up to 'maxWorks' units of work in a single call, appending the id of every result
+     * produced along the way to 'batch'. This amortizes the per-call dispatch, timing and stats
+     * overhead of work() over a batch of results.
+     *
+     * Returns NEED_TIME if the batch ended without hitting any other state (a stage may stop short
+     * of 'maxWorks'). Otherwise returns the state which ended the batch early: IS_EOF,
+     * NEED_YIELD, DEAD or FAILURE. For the last three, *out is set
+     * exactly as work() would have set it. Results already appended to 'batch' are valid in
+     * either case and must be consumed (or freed) before the returned state is acted upon.
+     *
+     * Every object in a result handed out this way is owned, since the storage engine memory
+     * behind an unowned result is only guaranteed to live until the next unit of work.
+     *
+     * Calls to work() and workBatch() may be freely interleaved on the same stage.
+     */
+    StageState workBatch(WorkingSet* ws,
+                         size_t maxWorks,
+                         std::vector<WorkingSetID>* batch,
+                         WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -348,6 +370,43 @@ protected:
      */ //Ӧ//IndexScan::doWork()  CollectionScan::doWork(ȫɨ)  
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work.  See comment at workBatch() above.
+     *
+     * The default implementation simply calls doWork() in a loop. Stages override this when they
+     * can do better, e.g. by pulling a whole batch from their child at once.
+     */
+    virtual StageState doWorkBatch(WorkingSet* ws,
+                                   size_t maxWorks,
+                                   std::vector<WorkingSetID>* batch,
+                                   WorkingSetID* out);
+
+    /**
+     * Calls doWork() up to 'maxWorks' times, collecting results into 'batch' and making them
+     * owned. Stops early on any state other than ADVANCED or NEED_TIME, or as soon as
+     * 'keepGoing' returns false. Used to implement doWorkBatch().
+     */
+    StageState workBatchLoop(WorkingSet* ws,
+                             size_t maxWorks,
+                             std::vector<WorkingSetID>* batch,
+                             WorkingSetID* out,
+                             const stdx::function<bool()>& keepGoing);
+
+    /**
+     * Updates the common stats for one unit of work which returned 'state'. work() does this
+     * automatically; doWorkBatch() implementations must do it for every unit they perform.
+     */
+    void recordWork(StageState state) {
+        ++_commonStats.works;
+        if (StageState::ADVANCED == state) {
+            ++_commonStats.advanced;
+        } else if (StageState::NEED_TIME == state) {
+            ++_commonStats.needTime;
+        } else if (StageState::NEED_YIELD == state) {
+            ++_commonStats.needYield;
+        }
+    }
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -189,12 +189,12 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
 }
 
 bool ProjectionStage::isEOF() {
-    return child()->isEOF();
+    return _childResults.isEOF(child().get());
 }
 
 PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     WorkingSetID id = WorkingSet::INVALID_ID;
-    StageState status = child()->work(&id);
+    StageState status = _childResults.next(child().get(), &id);
 
     // Note that we don't do the normal if isEOF() return EOF thing here.  Our child might be a
     // tailable cursor and isEOF() would be true even if it had more data...
@@ -227,6 +227,20 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(WorkingSet* ws,
+                                                   size_t maxWorks,
+                                                   std::vector<WorkingSetID>* batch,
+                                                   WorkingSetID* out) {
+    _childResults.fill(child().get(), _ws, maxWorks);
+    return workBatchLoop(ws, maxWorks, batch, out, [this] { return !_childResults.empty(); });
+}
+
+void ProjectionStage::doInvalidate(OperationContext* opCtx,
+                                   const RecordId& dl,
+                                   InvalidationType type) {
+    _childResults.invalidate(_ws, dl, type);
+}
+
 unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_PROJECTION);
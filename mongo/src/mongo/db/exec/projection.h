@@ -29,6 +29,7 @@
 #pragma once
 
 
+#include "mongo/db/exec/child_result_buffer.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/projection_exec.h"
 #include "mongo/db/jsobj.h"
@@ -82,6 +83,12 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
+
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_PROJECTION;
@@ -120,6 +127,9 @@ private:
     // _ws is not owned by us.
     WorkingSet* _ws;
 
+    // Results read ahead from our child by doWorkBatch().
+    ChildResultBuffer _childResults;
+
     // Stats
     ProjectionStats _specificStats;
 
@@ -49,12 +49,12 @@ SkipStage::SkipStage(OperationContext* opCtx, long long toSkip, WorkingSet* ws,
 SkipStage::~SkipStage() {}
 
 bool SkipStage::isEOF() {
-    return child()->isEOF();
+    return _childResults.isEOF(child().get());
 }
 
 PlanStage::StageState SkipStage::doWork(WorkingSetID* out) {
     WorkingSetID id = WorkingSet::INVALID_ID;
-    StageState status = child()->work(&id);
+    StageState status = _childResults.next(child().get(), &id);
 
     if (PlanStage::ADVANCED == status) {
         // If we're still skipping results...
@@ -87,6 +87,18 @@ PlanStage::StageState SkipStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState SkipStage::doWorkBatch(WorkingSet* ws,
+                                             size_t maxWorks,
+                                             std::vector<WorkingSetID>* batch,
+                                             WorkingSetID* out) {
+    _childResults.fill(child().get(), _ws, maxWorks);
+    return workBatchLoop(ws, maxWorks, batch, out, [this] { return !_childResults.empty(); });
+}
+
+void SkipStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) {
+    _childResults.invalidate(_ws, dl, type);
+}
+
 unique_ptr<PlanStageStats> SkipStage::getStats() {
     _commonStats.isEOF = isEOF();
     _specificStats.skip = _toSkip;
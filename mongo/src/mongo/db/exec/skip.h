@@ -29,6 +29,7 @@
 #pragma once
 
 
+#include "mongo/db/exec/child_result_buffer.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
@@ -48,6 +49,12 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
+
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_SKIP;
@@ -65,6 +72,9 @@ private:
     // We drop the first _toSkip results that we would have returned.
     long long _toSkip;
 
+    // Results read ahead from our child by doWorkBatch().
+    ChildResultBuffer _childResults;
+
     // Stats
     SkipStats _specificStats;
 };
@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -54,6 +55,28 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
+namespace {
+
+/**
+ * Orders the (sortKey, document) pairs handed to the external sorter. The keys carry the RecordId
+ * as a trailing element, so 'pattern' must have one more field than the user's sort pattern.
+ */
+class ExternalSortComparator {
+public:
+    explicit ExternalSortComparator(BSONObj pattern) : _pattern(std::move(pattern)) {}
+
+    int operator()(const std::pair<BSONObj, BSONObj>& lhs,
+                   const std::pair<BSONObj, BSONObj>& rhs) const {
+        // False means ignore field names.
+        return lhs.first.woCompare(rhs.first, _pattern, false);
+    }
+
+private:
+    BSONObj _pattern;
+};
+
+}  // namespace
+
 SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
@@ -76,6 +99,7 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -97,18 +121,32 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _sorterIterator ? !_sorterIterator->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
     if (_memUsage > maxBytes) {
-        mongoutils::str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
-        return PlanStage::FAILURE;
+        if (!_allowDiskUse) {
+            mongoutils::str::stream ss;
+            ss << "Sort operation used more than the maximum " << maxBytes
+               << " bytes of RAM. Add an index, specify a smaller limit,"
+               << " or pass allowDiskUse:true to opt in to sorting on disk.";
+            Status status(ErrorCodes::OperationFailed, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
+
+        // Hand everything buffered so far to the external sorter. From here on the sorter is
+        // responsible for keeping its own memory usage within 'maxBytes'.
+        Status status = spillToSorter();
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
     }
 
     if (isEOF()) {
@@ -129,8 +167,9 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             // Planner must put a fetch before we get here.
             verify(member->hasObj());
 
-            // We might be sorting something that was invalidated at some point.
-            if (member->hasRecordId()) {
+            // We might be sorting something that was invalidated at some point. Results that go
+            // straight to the external sorter are copied out and never need invalidation.
+            if (member->hasRecordId() && !_sorter) {
                 _wsidByRecordId[member->recordId] = id;
             }
 
@@ -148,14 +187,27 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
-            addToBuffer(item);
+            if (_sorter) {
+                Status status = addToSorter(item);
+                if (!status.isOK()) {
+                    *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                    return PlanStage::FAILURE;
+                }
+            } else {
+                addToBuffer(item);
+            }
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
-            _resultIterator = _data.begin();
+            if (_sorter) {
+                _sorterIterator.reset(_sorter->done());
+                _sorter.reset();
+            } else {
+                sortBuffer();
+                _resultIterator = _data.begin();
+            }
             _sorted = true;
             return PlanStage::NEED_TIME;
         } else if (PlanStage::FAILURE == code || PlanStage::DEAD == code) {
@@ -178,6 +230,11 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_sorterIterator) {
+        *out = allocateFromSorter();
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -340,4 +397,108 @@ void SortStage::sortBuffer() {
     }
 }
 
+Status SortStage::spillToSorter() {
+    invariant(!_sorter);
+
+    SortOptions opts;
+    opts.limit = _limit;
+    opts.maxMemoryUsageBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    opts.extSortAllowed = true;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+
+    // The RecordId is appended to every key as an ascending tie-breaker, matching the ordering of
+    // WorkingSetComparator.
+    BSONObjBuilder patternBob;
+    patternBob.appendElements(_sortKeyComparator->pattern);
+    patternBob.append("$recordId", 1);
+    _sorter.reset(ExternalSorter::make(opts, ExternalSortComparator(patternBob.obj())));
+    _specificStats.usedDisk = true;
+
+    std::vector<SortableDataItem> buffered;
+    if (_dataSet) {
+        buffered.assign(_dataSet->begin(), _dataSet->end());
+        _dataSet->clear();
+    }
+    buffered.insert(buffered.end(), _data.begin(), _data.end());
+    _data.clear();
+    _resultIterator = _data.end();
+    _memUsage = 0;
+
+    Status status = Status::OK();
+    for (const auto& item : buffered) {
+        if (status.isOK()) {
+            status = addToSorter(item);
+            continue;
+        }
+
+        // Still release what is left in the buffer so that nothing leaks in the working set.
+        WorkingSetMember* member = _ws->get(item.wsid);
+        if (member->hasRecordId()) {
+            _wsidByRecordId.erase(member->recordId);
+        }
+        _ws->free(item.wsid);
+    }
+    return status;
+}
+
+Status SortStage::addToSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+
+    // Only the document and its sort key survive a round trip through the sorter, so we cannot
+    // spill results that carry other computed data, such as a text score or geo distance.
+    for (int type = 0; type < WSM_COMPUTED_NUM_TYPES; ++type) {
+        if (type != WSM_SORT_KEY &&
+            member->hasComputed(static_cast<WorkingSetComputedDataType>(type))) {
+            return Status(ErrorCodes::OperationFailed,
+                          "Sort operation exceeded the memory limit and its results cannot be "
+                          "sorted on disk. Add an index, or specify a smaller limit.");
+        }
+    }
+
+    BSONObjBuilder keyBob;
+    keyBob.appendElements(item.sortKey);
+    keyBob.append("", static_cast<long long>(item.recordId.repr()));
+    _sorter->add(keyBob.obj(), member->obj.value().getOwned());
+
+    if (member->hasRecordId()) {
+        _wsidByRecordId.erase(member->recordId);
+    }
+    _ws->free(item.wsid);
+    return Status::OK();
+}
+
+WorkingSetID SortStage::allocateFromSorter() {
+    ExternalSorter::Data next = _sorterIterator->next();
+
+    // Split the RecordId tie-breaker back off the end of the key.
+    BSONObjBuilder sortKeyBob;
+    RecordId recordId;
+    for (BSONObjIterator it(next.first); it.more();) {
+        BSONElement elt = it.next();
+        if (it.more()) {
+            sortKeyBob.append(elt);
+        } else {
+            recordId = RecordId(elt.numberLong());
+        }
+    }
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+
+    // The document is a copy taken before the spill. Leave its SnapshotId unset so that any
+    // consumer which cares (e.g. update or delete) refetches it under the current snapshot.
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), next.second.getOwned());
+    member->addComputed(new SortKeyComputedData(sortKeyBob.obj()));
+    if (recordId.isNormal()) {
+        member->recordId = recordId;
+        _ws->transitionToRecordIdAndObj(id);
+    } else {
+        member->transitionToOwnedObj();
+    }
+    return id;
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
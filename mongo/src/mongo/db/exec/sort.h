@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +47,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,11 +57,19 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, spill to disk instead of failing once the memory limit is exceeded.
+    bool allowDiskUse;
 };
 
 /**
  * Sorts the input received from the child according to the sort pattern provided.
  *
+ * Results are buffered in the WorkingSet until they exceed internalQueryExecMaxBlockingSortBytes.
+ * At that point the stage either fails or, if 'allowDiskUse' was requested, hands everything it
+ * has buffered to an external Sorter and continues from there, returning owned copies of the
+ * documents once the input is exhausted.
+ *
  * Preconditions:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
@@ -106,6 +115,9 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether we may switch to an external sort once we run out of memory.
+    bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -152,6 +164,23 @@ private:
      */
     void sortBuffer();
 
+    /**
+     * Moves the contents of the data buffer into '_sorter' and frees the corresponding working
+     * set members. All further input is added to '_sorter' directly.
+     */
+    Status spillToSorter();
+
+    /**
+     * Copies the document and sort key for 'item' into '_sorter', then frees its working set
+     * member. Fails if the member carries computed data that the sorter cannot preserve.
+     */
+    Status addToSorter(const SortableDataItem& item);
+
+    /**
+     * Allocates a working set member for the next result of '_sorterIterator'.
+     */
+    WorkingSetID allocateFromSorter();
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -174,6 +203,14 @@ private:
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByRecordId;
 
+    // Used once buffered data has exceeded the memory limit and '_allowDiskUse' is set. Keys are
+    // the sort keys with the RecordId appended as a tie-breaker, values are owned documents.
+    typedef Sorter<BSONObj, BSONObj> ExternalSorter;
+    std::unique_ptr<ExternalSorter> _sorter;
+
+    // Iterates through the output of '_sorter' post-sort.
+    std::unique_ptr<ExternalSorter::Iterator> _sorterIterator;
+
     SortStats _specificStats;
 
     // The usage in bytes of all buffered data that we're sorting.
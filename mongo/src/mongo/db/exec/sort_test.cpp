@@ -39,9 +39,12 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/query/collation/collator_factory_mock.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
@@ -66,7 +69,7 @@ public:
 
     /**
      * Test function to verify sort stage.
-     * SortStageParams will be initialized using patternStr, collator, and limit.
+     * SortStageParams will be initialized using patternStr, collator, limit and allowDiskUse.
      * inputStr represents the input data set in a BSONObj.
      *     {input: [doc1, doc2, doc3, ...]}
      * expectedStr represents the expected sorted data set.
@@ -76,7 +79,8 @@ public:
                   CollatorInterface* collator,
                   int limit,
                   const char* inputStr,
-                  const char* expectedStr) {
+                  const char* expectedStr,
+                  bool allowDiskUse = false) {
         // WorkingSet is not owned by stages
         // so it's fine to declare
         WorkingSet ws;
@@ -105,6 +109,7 @@ public:
         SortStageParams params;
         params.pattern = fromjson(patternStr);
         params.limit = limit;
+        params.allowDiskUse = allowDiskUse;
 
         auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
             getOpCtx(), queuedDataStage.release(), &ws, params.pattern, collator);
@@ -300,4 +305,83 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+//
+// External sort
+// Once the buffered data exceeds internalQueryExecMaxBlockingSortBytes, a stage with
+// allowDiskUse set should hand its data to the external sorter instead of failing.
+//
+
+class SortStageExternalTest : public SortStageTest {
+public:
+    SortStageExternalTest() : _tempDir("SortStageExternalTest") {
+        _oldDbPath = storageGlobalParams.dbpath;
+        storageGlobalParams.dbpath = _tempDir.path();
+        _oldMaxBytes = internalQueryExecMaxBlockingSortBytes.load();
+        internalQueryExecMaxBlockingSortBytes.store(1);
+    }
+
+    ~SortStageExternalTest() {
+        internalQueryExecMaxBlockingSortBytes.store(_oldMaxBytes);
+        storageGlobalParams.dbpath = _oldDbPath;
+    }
+
+private:
+    unittest::TempDir _tempDir;
+    std::string _oldDbPath;
+    int _oldMaxBytes;
+};
+
+TEST_F(SortStageExternalTest, SortAscendingSpillsToDisk) {
+    testWork("{a: 1}",
+             nullptr,
+             0,
+             "{input: [{a: 2}, {a: 1}, {a: 3}, {a: 5}, {a: 4}]}",
+             "{output: [{a: 1}, {a: 2}, {a: 3}, {a: 4}, {a: 5}]}",
+             true);
+}
+
+TEST_F(SortStageExternalTest, SortDescendingWithLimitSpillsToDisk) {
+    testWork("{a: -1}",
+             nullptr,
+             2,
+             "{input: [{a: 2}, {a: 1}, {a: 3}, {a: 5}, {a: 4}]}",
+             "{output: [{a: 5}, {a: 4}]}",
+             true);
+}
+
+TEST_F(SortStageExternalTest, SortWithCollationSpillsToDisk) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testWork("{a: 1}",
+             &collator,
+             0,
+             "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
+             "{output: [{a: 'aa'}, {a: 'ba'}, {a: 'ab'}]}",
+             true);
+}
+
+TEST_F(SortStageExternalTest, SortFailsWithoutAllowDiskUse) {
+    WorkingSet ws;
+    auto queuedDataStage = stdx::make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (int i = 0; i < 3; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << i));
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = BSON("a" << 1);
+    auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+        getOpCtx(), queuedDataStage.release(), &ws, params.pattern, nullptr);
+    SortStage sort(getOpCtx(), params, &ws, sortKeyGen.release());
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state == PlanStage::NEED_TIME) {
+        state = sort.work(&id);
+    }
+    ASSERT_EQUALS(state, PlanStage::FAILURE);
+}
 }  // namespace
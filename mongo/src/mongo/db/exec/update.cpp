@@ -338,6 +338,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                                           newObj,
                                                           true,
                                                           driver->modsAffectIndices(),
+                                                          driver->modifiedIndexedPaths(),
                                                           _params.opDebug,
                                                           &args);
             }
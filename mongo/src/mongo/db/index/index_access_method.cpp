@@ -325,6 +325,10 @@ long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* opCtx) const {
     return _newInterface->getSpaceUsedBytes(opCtx);
 }
 
+bool IndexAccessMethod::requiresFeatureCompatibilityVersion36() const {
+    return _newInterface->requiresFeatureCompatibilityVersion36();
+}
+
 pair<vector<BSONObj>, vector<BSONObj>> IndexAccessMethod::setDifference(const BSONObjSet& left,
                                                                         const BSONObjSet& right) {
     // Two iterators to traverse the two sets in sorted order.
@@ -501,21 +505,65 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
     return Status::OK();
 }
 
+void IndexAccessMethod::BulkBuilder::sort() {
+    invariant(!_sortedRun);
+    _sortedRun.reset(_sorter->done());
+}
+
 
 Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      std::unique_ptr<BulkBuilder> bulk,
                                      bool mayInterrupt,
                                      bool dupsAllowed,
                                      set<RecordId>* dupsToDrop) {
+    std::vector<std::unique_ptr<BulkBuilder>> bulks;
+    bulks.push_back(std::move(bulk));
+    return commitBulk(opCtx, std::move(bulks), mayInterrupt, dupsAllowed, dupsToDrop);
+}
+
+Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
+                                     std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                                     bool mayInterrupt,
+                                     bool dupsAllowed,
+                                     set<RecordId>* dupsToDrop) {
+    invariant(!bulks.empty());
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    int64_t keysInserted = 0;
+    bool everGeneratedMultipleKeys = false;
+    MultikeyPaths indexMultikeyPaths;
+    std::vector<std::shared_ptr<BulkBuilder::Sorter::Iterator>> runs;
+    for (auto&& bulk : bulks) {
+        keysInserted += bulk->_keysInserted;
+        everGeneratedMultipleKeys = everGeneratedMultipleKeys || bulk->_everGeneratedMultipleKeys;
+        if (indexMultikeyPaths.empty()) {
+            indexMultikeyPaths = bulk->_indexMultikeyPaths;
+        } else if (!bulk->_indexMultikeyPaths.empty()) {
+            invariant(indexMultikeyPaths.size() == bulk->_indexMultikeyPaths.size());
+            for (size_t i = 0; i < indexMultikeyPaths.size(); ++i) {
+                indexMultikeyPaths[i].insert(bulk->_indexMultikeyPaths[i].begin(),
+                                             bulk->_indexMultikeyPaths[i].end());
+            }
+        }
+        if (!bulk->_sortedRun) {
+            bulk->sort();
+        }
+        runs.push_back(bulk->_sortedRun);
+    }
+
+    std::shared_ptr<BulkBuilder::Sorter::Iterator> i = runs.front();
+    if (runs.size() > 1) {
+        i.reset(BulkBuilder::Sorter::Iterator::merge(
+            runs,
+            SortOptions(),
+            BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    }
 
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(
         CurOp::get(opCtx)->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                              "Index: (2/3) BTree Bottom Up Progress",
-                                             bulk->_keysInserted,
+                                             keysInserted,
                                              10));
     lk.unlock();
 
@@ -524,8 +572,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     writeConflictRetry(opCtx, "setting index multikey flag", "", [&] {
         WriteUnitOfWork wunit(opCtx);
 
-        if (bulk->_everGeneratedMultipleKeys || isMultikeyFromPaths(bulk->_indexMultikeyPaths)) {
-            _btreeState->setMultikey(opCtx, bulk->_indexMultikeyPaths);
+        if (everGeneratedMultipleKeys || isMultikeyFromPaths(indexMultikeyPaths)) {
+            _btreeState->setMultikey(opCtx, indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(opCtx, dupsAllowed));
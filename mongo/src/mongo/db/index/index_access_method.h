@@ -208,6 +208,11 @@ public:
      */
     long long getSpaceUsedBytes(OperationContext* opCtx) const;
 
+    /**
+     * @return true if this index stores its entries in a format that 3.4 binaries can't read.
+     */
+    bool requiresFeatureCompatibilityVersion36() const;
+
     RecordId findSingle(OperationContext* opCtx, const BSONObj& key) const;
 
     /**
@@ -231,6 +236,14 @@ public:
                       const InsertDeleteOptions& options,
                       int64_t* numInserted);
 
+        /**
+         * Sorts the keys inserted so far, spilling to disk if needed. No more keys may be inserted
+         * afterwards. commitBulk() sorts the keys itself if this hasn't been called; calling it
+         * beforehand lets the keys of several BulkBuilders be sorted on different threads. Like
+         * insert(), it doesn't use an OperationContext.
+         */
+        void sort();
+
     private:
         friend class IndexAccessMethod;
 
@@ -241,6 +254,8 @@ public:
                     size_t maxMemoryUsageBytes);
 
         std::unique_ptr<Sorter> _sorter;
+        // The keys in sorted order, once sort() has been called.
+        std::shared_ptr<Sorter::Iterator> _sortedRun;
         const IndexAccessMethod* _real;
         int64_t _keysInserted = 0;
 
@@ -280,6 +295,16 @@ public:
                       bool dupsAllowed,
                       std::set<RecordId>* dups);
 
+    /**
+     * Like commitBulk() above, but loads the keys of several BulkBuilders for this index, each
+     * filled with the keys of a different set of documents, merging their sorted runs.
+     */
+    Status commitBulk(OperationContext* opCtx,
+                      std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                      bool mayInterrupt,
+                      bool dupsAllowed,
+                      std::set<RecordId>* dups);
+
     /**
      * Specifies whether getKeys should relax the index constraints or not.
      */
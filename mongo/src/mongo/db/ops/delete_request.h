@@ -62,6 +62,9 @@ public:
     void setCollation(const BSONObj& collation) {
         _collation = collation;
     }
+    void setAllowDiskUse(bool allowDiskUse = true) {
+        _allowDiskUse = allowDiskUse;
+    }
     void setMulti(bool multi = true) {
         _multi = multi;
     }
@@ -96,6 +99,9 @@ public:
     const BSONObj& getCollation() const {
         return _collation;
     }
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
     bool isMulti() const {
         return _multi;
     }
@@ -136,6 +142,7 @@ private:
     bool _fromMigrate;
     bool _isExplain;
     bool _returnDeleted;
+    bool _allowDiskUse = false;
     PlanExecutor::YieldPolicy _yieldPolicy;
 };
 
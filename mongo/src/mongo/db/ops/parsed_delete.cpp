@@ -77,6 +77,7 @@ Status ParsedDelete::parseQueryToCQ() {
     auto qr = stdx::make_unique<QueryRequest>(_request->getNamespaceString());
     qr->setFilter(_request->getQuery());
     qr->setSort(_request->getSort());
+    qr->setAllowDiskUse(_request->allowDiskUse());
     qr->setCollation(_request->getCollation());
     qr->setExplain(_request->isExplain());
 
@@ -102,6 +102,7 @@ Status ParsedUpdate::parseQueryToCQ() {
     auto qr = stdx::make_unique<QueryRequest>(_request->getNamespaceString());
     qr->setFilter(_request->getQuery());
     qr->setSort(_request->getSort());
+    qr->setAllowDiskUse(_request->allowDiskUse());
     qr->setCollation(_request->getCollation());
     qr->setExplain(_request->isExplain());
 
@@ -96,6 +96,14 @@ public:
         return _sort;
     }
 
+    inline void setAllowDiskUse(bool value = true) {
+        _allowDiskUse = value;
+    }
+
+    inline bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
     inline void setCollation(const BSONObj& collation) {
         _collation = collation;
     }
@@ -216,6 +224,7 @@ public:
         builder << " query: " << _query;
         builder << " projection: " << _proj;
         builder << " sort: " << _sort;
+        builder << " allowDiskUse: " << _allowDiskUse;
         builder << " collation: " << _collation;
         builder << " updates: " << _updates;
         builder << " stmtId: " << _stmtId;
@@ -252,6 +261,9 @@ private:
     // Contains the sort order information.
     BSONObj _sort;
 
+    // Whether a blocking sort over '_sort' may spill to disk.
+    bool _allowDiskUse = false;
+
     // Contains the collation information.
     BSONObj _collation;
 
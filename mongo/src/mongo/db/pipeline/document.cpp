@@ -49,6 +49,8 @@ const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore, Document::metaFieldRandVal, Document::metaFieldSortKey};
 
 Position DocumentStorage::findField(StringData requested) const {
+    buildFieldTableIfLazy();
+
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -77,6 +79,8 @@ Position DocumentStorage::findField(StringData requested) const {
 }
 
 Value& DocumentStorage::appendField(StringData name) {
+    dassert(!_lazy);
+
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -188,6 +192,16 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
+    if (_lazy) {
+        // Clones are made to be modified, so the copy is not lazy.
+        out->appendAllFields(_lazyBson);
+        out->_metaFields = _metaFields;
+        out->_textScore = _textScore;
+        out->_randVal = _randVal;
+        out->_sortKey = _sortKey.getOwned();
+        return out;
+    }
+
     // Make a copy of the buffer.
     // It is very important that the positions of each field are the same after cloning.
     const size_t bufferBytes = allocatedBytes();
@@ -214,10 +228,47 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     return out;
 }
 
+void DocumentStorage::initLazy(BSONObj bson) {
+    invariant(!_buffer && !_lazy && bson.isOwned());
+    _lazy = true;
+    _lazyBson = std::move(bson);
+}
+
+void DocumentStorage::appendAllFields(const BSONObj& bson) {
+    reserveFields(bson.nFields());
+    BSONObjIterator it(bson);
+    while (it.more()) {
+        BSONElement elem(it.next());
+        appendField(elem.fieldNameStringData()) = Value(elem);
+    }
+}
+
+void DocumentStorage::buildFieldTable() const {
+    DocumentStorage table;
+    table.appendAllFields(_lazyBson);
+
+    // Take over the buffer of 'table'. Positions are offsets into it, so they stay valid. Nothing
+    // else about this storage changes, and no thread reads the buffer until '_fieldTableBuilt' is
+    // set or the std::call_once() in buildFieldTableIfLazy() returns.
+    auto self = const_cast<DocumentStorage*>(this);
+    self->_buffer = table._buffer;
+    self->_bufferEnd = table._bufferEnd;
+    self->_usedBytes = table._usedBytes;
+    self->_numFields = table._numFields;
+    self->_hashTabMask = table._hashTabMask;
+    table._buffer = nullptr;
+    table._bufferEnd = nullptr;
+    table._usedBytes = 0;
+    table._numFields = 0;
+
+    _fieldTableBuilt.store(true);
+}
+
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    // Not iteratorAll(), which would build the field table of a lazy storage.
+    for (DocumentStorageIterator it(_firstElement, end(), true); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
 }
@@ -258,12 +309,23 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // An unconverted top-level Document holds exactly the fields of its BSON. Nested ones go
+    // through the Values so that the depth limit is still enforced.
+    if (recursionLevel == 1 && storage().isLazy()) {
+        builder->appendElements(storage().lazyBson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
 BSONObj Document::toBson() const {
+    if (storage().isLazy()) {
+        return storage().lazyBson();
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
@@ -312,6 +374,16 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+Document Document::fromBsonLazily(const BSONObj& bson) {
+    if (bson.isEmpty()) {
+        return Document();
+    }
+
+    intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+    storage->initLazy(bson.getOwned());
+    return Document(storage.get());
+}
+
 MutableDocument::MutableDocument(size_t expectedFields)
     : _storageHolder(NULL), _storage(_storageHolder) {
     if (expectedFields) {
@@ -381,6 +453,9 @@ size_t Document::getApproximateSize() const {
         return 0;  // we've allocated no memory
 
     size_t size = sizeof(DocumentStorage);
+    if (storage().isLazy()) {
+        return size + storage().lazyBson().objsize();
+    }
     size += storage().allocatedBytes();
 
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
@@ -144,7 +144,8 @@ public:
 
     /// True if this document has no fields.
     bool empty() const {
-        return !_storage || storage().iterator().atEnd();
+        // A lazy storage is never made for an empty object.
+        return !_storage || (!storage().isLazy() && storage().iterator().atEnd());
     }
 
     /// Create a new FieldIterator that can be used to examine the Document's fields in order.
@@ -217,6 +218,17 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like Document(BSONObj), but keeps a copy of 'bson' and only converts its fields when they
+     * are needed. Until then, looking up a field by name scans 'bson' for it, and toBson() returns
+     * 'bson' itself. Iterating or comparing the Document converts all of it, once, and modifying
+     * it through a MutableDocument makes a converted copy. The Document may be read from several
+     * threads at once. Suited to large documents of which only a few fields are ever looked up,
+     * such as the input of a pipeline that filters most documents out or passes them through
+     * unchanged. Field names starting with '$' get no special treatment.
+     */
+    static Document fromBsonLazily(const BSONObj& bson);
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
@@ -564,7 +576,8 @@ private:
         if (MONGO_unlikely(!_storage))
             return newStorage();
 
-        if (MONGO_unlikely(_storage->isShared()))
+        // A lazy storage is never modified in place, so it is replaced by a clone even if unshared.
+        if (MONGO_unlikely(_storage->isShared() || storagePtr()->isLazy()))
             return clonedStorage();
 
         // This function exists to ensure this is safe
@@ -32,9 +32,11 @@
 
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
+#include <mutex>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -189,7 +191,8 @@ public:
           _hashTabMask(0),
           _metaFields(),
           _textScore(0),
-          _randVal(0) {}
+          _randVal(0),
+          _lazy(false) {}
 
     ~DocumentStorage();
 
@@ -206,6 +209,9 @@ public:
     }
 
     size_t size() const {
+        if (_lazy)
+            return _lazyBson.nFields();
+
         // can't use _numFields because it includes removed Fields
         size_t count = 0;
         for (DocumentStorageIterator it = iterator(); !it.atEnd(); it.advance())
@@ -227,6 +233,11 @@ public:
         return *(_firstElement->plusBytes(pos.index));
     }
     Value getField(StringData name) const {
+        if (_lazy && !_fieldTableBuilt.load()) {
+            BSONElement elem = _lazyBson.getField(name);
+            return elem.eoo() ? Value() : Value(elem);
+        }
+
         Position pos = findField(name);
         if (!pos.found())
             return Value();
@@ -255,14 +266,36 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        buildFieldTableIfLazy();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
+        buildFieldTableIfLazy();
         return DocumentStorageIterator(_firstElement, end(), true);
     }
 
+    /**
+     * Makes this storage, which must be new, a lazy view of 'bson': until something needs
+     * positions, such as iteration, lookups by name read the fields straight from 'bson'. The
+     * field table is then built from every field at once, exactly once even if the storage is
+     * shared between threads. A lazy storage is never modified in place: MutableDocument replaces
+     * it with a clone(), which is not lazy. 'bson' must be owned, and is treated as having no
+     * metadata fields.
+     */
+    void initLazy(BSONObj bson);
+
+    /// True for a storage made by initLazy(). Its fields are always exactly those of lazyBson().
+    bool isLazy() const {
+        return _lazy;
+    }
+
+    /// The object a lazy storage is a view of. Only valid if isLazy().
+    const BSONObj& lazyBson() const {
+        return _lazyBson;
+    }
+
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
@@ -325,6 +358,18 @@ private:
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
     }
 
+    void buildFieldTableIfLazy() const {
+        if (_lazy && !_fieldTableBuilt.load()) {
+            std::call_once(_buildFieldTableOnce, [this] { buildFieldTable(); });
+        }
+    }
+
+    /// Builds the field table of a lazy storage from '_lazyBson'. Only called once.
+    void buildFieldTable() const;
+
+    /// Appends every field of 'bson' to this storage, which must be new and not lazy.
+    void appendAllFields(const BSONObj& bson);
+
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
@@ -401,6 +446,14 @@ private:
     double _textScore;
     double _randVal;
     BSONObj _sortKey;
+
+    // Only used by storages made with initLazy(). '_lazy' and '_lazyBson' do not change after
+    // initLazy(). The field table is built under '_buildFieldTableOnce', after which
+    // '_fieldTableBuilt' is set.
+    bool _lazy;
+    BSONObj _lazyBson;
+    mutable std::once_flag _buildFieldTableOnce;
+    mutable AtomicWord<bool> _fieldTableBuilt;
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
@@ -781,6 +781,20 @@ public:
          */
         virtual BSONObj getCollectionOptions(const NamespaceString& nss) = 0;
 
+        /**
+         * Returns the specs of the indexes on the collection given by 'nss', or an empty list if
+         * it does not exist.
+         */
+        virtual std::list<BSONObj> getIndexSpecs(const NamespaceString& nss) = 0;
+
+        /**
+         * Builds the indexes given by 'specs' on the existing collection 'nss' in one scan of the
+         * collection, holding the database lock in exclusive mode only while the indexes are
+         * added to and marked ready in the catalog. The specs are logged unchanged.
+         */
+        virtual Status createIndexes(const NamespaceString& nss,
+                                     const std::vector<BSONObj>& specs) = 0;
+
         /**
          * Performs the given rename command if the collection given by 'targetNs' has the same
          * options as specified in 'originalCollectionOptions', and has the same indexes as
@@ -30,11 +30,16 @@
 
 #include "mongo/db/pipeline/document_source_cursor.h"
 
+#include <iterator>
+#include <vector>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/parallel_batch.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/util/scopeguard.h"
 
@@ -83,13 +88,18 @@ void DocumentSourceCursor::loadBatch() {
         {
             ON_BLOCK_EXIT([this] { recordPlanSummaryStats(); });
 
+            // When worker threads are available, results are buffered as owned BSON and only
+            // converted to Documents once the batch is complete, so that the conversion can be
+            // split across threads. Such a batch is sized by the BSON size of its results.
+            const bool convertInParallel =
+                internalQueryExecParallelWorkers.load() > 1 && !_shouldProduceEmptyDocs;
+            std::vector<BSONObj> unconvertedBatch;
+
             while ((state = _exec->getNext(&resultObj, nullptr)) == PlanExecutor::ADVANCED) {
-                if (_shouldProduceEmptyDocs) {
-                    _currentBatch.push_back(Document());
-                } else if (_dependencies) {
-                    _currentBatch.push_back(_dependencies->extractFields(resultObj));
+                if (convertInParallel) {
+                    unconvertedBatch.push_back(resultObj.getOwned());
                 } else {
-                    _currentBatch.push_back(Document::fromBsonWithMetaData(resultObj));
+                    _currentBatch.push_back(transformBSONObjToDocument(resultObj));
                 }
 
                 if (_limit) {
@@ -99,7 +109,8 @@ void DocumentSourceCursor::loadBatch() {
                     verify(_docsAddedToBatches < _limit->getLimit());
                 }
 
-                memUsageBytes += _currentBatch.back().getApproximateSize();
+                memUsageBytes += convertInParallel ? unconvertedBatch.back().objsize()
+                                                   : _currentBatch.back().getApproximateSize();
 
                 // As long as we're waiting for inserts, we shouldn't do any batching at this level
                 // we need the whole pipeline to see each document to see if we should stop waiting.
@@ -109,10 +120,13 @@ void DocumentSourceCursor::loadBatch() {
                     (pExpCtx->isTailableAwaitData() && pExpCtx->needsMerge) ||
                     memUsageBytes > internalDocumentSourceCursorBatchSizeBytes.load()) {
                     // End this batch and prepare PlanExecutor for yielding.
+                    appendConvertedBatch(unconvertedBatch);
                     _exec->saveState();
                     return;
                 }
             }
+            appendConvertedBatch(unconvertedBatch);
+
             // Special case for tailable cursor -- EOF doesn't preclude more results, so keep
             // the PlanExecutor alive.
             if (state == PlanExecutor::IS_EOF && pExpCtx->isTailableAwaitData()) {
@@ -164,6 +178,35 @@ Pipeline::SourceContainer::iterator DocumentSourceCursor::doOptimizeAt(
     return std::next(itr);
 }
 
+Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
+    if (_shouldProduceEmptyDocs) {
+        return Document();
+    } else if (_dependencies) {
+        return _dependencies->extractFields(obj);
+    } else if (_shouldConvertLazily) {
+        return Document::fromBsonLazily(obj);
+    } else {
+        return Document::fromBsonWithMetaData(obj);
+    }
+}
+
+void DocumentSourceCursor::appendConvertedBatch(const std::vector<BSONObj>& objs) {
+    if (objs.empty()) {
+        return;
+    }
+
+    std::vector<Document> docs(objs.size());
+    parallel_batch::forEachChunk(objs.size(),
+                                 internalQueryExecParallelWorkers.load(),
+                                 internalQueryExecParallelMinItemsPerWorker.load(),
+                                 [&](size_t begin, size_t end) {
+                                     for (size_t i = begin; i < end; ++i) {
+                                         docs[i] = transformBSONObjToDocument(objs[i]);
+                                     }
+                                 });
+    std::move(docs.begin(), docs.end(), std::back_inserter(_currentBatch));
+}
+
 void DocumentSourceCursor::recordPlanSummaryStats() {
     invariant(_exec);
     // Aggregation handles in-memory sort outside of the query sub-system. Given that we need to
@@ -131,6 +131,15 @@ public:
         _shouldProduceEmptyDocs = true;
     }
 
+    /**
+     * If subsequent sources need whole documents but look up only a few of their fields and need
+     * no metadata, the cursor can output Documents that convert their fields from BSON only when
+     * needed. See Document::fromBsonLazily().
+     */
+    void shouldConvertLazily() {
+        _shouldConvertLazily = true;
+    }
+
     Timestamp getLatestOplogTimestamp() const {
         if (_exec) {
             return _exec->getLatestOplogTimestamp();
@@ -175,6 +184,17 @@ private:
      */
     void loadBatch();
 
+    /**
+     * Converts a result of '_exec' into the Document this stage returns for it.
+     */
+    Document transformBSONObjToDocument(const BSONObj& obj) const;
+
+    /**
+     * Converts 'objs' and appends them to '_currentBatch' in order, splitting the conversion
+     * across worker threads when the batch is large enough.
+     */
+    void appendConvertedBatch(const std::vector<BSONObj>& objs);
+
     void recordPlanSummaryStats();
 
     std::deque<Document> _currentBatch;
@@ -184,6 +204,7 @@ private:
     BSONObj _sort;
     BSONObj _projection;
     bool _shouldProduceEmptyDocs = false;
+    bool _shouldConvertLazily = false;
     boost::optional<ParsedDeps> _dependencies;
     boost::intrusive_ptr<DocumentSourceLimit> _limit;
     long long _docsAddedToBatches;  // for _limit enforcement
@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/exec/parallel_batch.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -38,6 +39,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -80,47 +82,31 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
-    // We aren't streaming, and we have spilled to disk.
-    if (!_sorterIterator)
-        return GetNextResult::makeEOF();
-
-    _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
-    while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
-        // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
-        // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
-
-        if (!_sorterIterator->more()) {
+    // We aren't streaming, and we have spilled to disk. Return the groups of one partition at a
+    // time.
+    while (_nextGroup == _groups->size()) {
+        if (_spilledPartitions.empty()) {
             dispose();
-            break;
+            return GetNextResult::makeEOF();
         }
-
-        _firstPartOfNextGroup = _sorterIterator->next();
+        loadNextSpilledPartition();
     }
 
-    return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+    const size_t group = _nextGroup++;
+    return makeDocument(
+        _groups->getId(group), _groups->getAccumulators(group), pExpCtx->needsMerge);
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     // Not spilled, and not streaming.
-    if (_groups->empty())
+    if (_nextGroup == _groups->size())
         return GetNextResult::makeEOF();
 
-    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    const size_t group = _nextGroup++;
+    Document out =
+        makeDocument(_groups->getId(group), _groups->getAccumulators(group), pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (_nextGroup == _groups->size())
         dispose();
 
     return std::move(out);
@@ -158,7 +144,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
         id = computeId(*_firstDocOfNextGroup);
     } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
 
-    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+    Document out = makeDocument(_currentId, _currentAccumulators.data(), pExpCtx->needsMerge);
     _currentId = std::move(id);
 
     return std::move(out);
@@ -166,11 +152,12 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
 
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
-    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
-    _sorterIterator.reset();
+    _groups.emplace(pExpCtx->getValueComparator(), _accumulatedFields.size());
+    _spillFiles.clear();
+    _spilledPartitions.clear();
 
     // Make us look done.
-    groupsIterator = _groups->end();
+    _nextGroup = 0;
 
     _firstDocOfNextGroup = boost::none;
 }
@@ -264,7 +251,6 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _inputSort(BSONObj()),
       _streaming(false),
       _initialized(false),
-      _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
       _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
 
@@ -357,33 +343,18 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
 
 namespace {
 
-using GroupsMap = DocumentSourceGroup::GroupsMap;
-
-class SorterComparator {
-public:
-    typedef pair<Value, Value> Data;
-
-    SorterComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
-
-    int operator()(const Data& lhs, const Data& rhs) const {
-        return _valueComparator.compare(lhs.first, rhs.first);
-    }
-
-private:
-    ValueComparator _valueComparator;
-};
-
-class SpillSTLComparator {
-public:
-    SpillSTLComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
-
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return _valueComparator.evaluate(lhs->first < rhs->first);
-    }
-
-private:
-    ValueComparator _valueComparator;
-};
+// The number of files a $group spills its groups to, and the most times a spilled partition that
+// is still too large to group in memory is partitioned again. Each level of partitioning takes
+// the next bits from the top of the mixed hash of _id, and all of them stay clear of the bits
+// used by GroupHashTable.
+const size_t kSpillPartitionBits = 4;
+const size_t kNumSpillPartitions = 1 << kSpillPartitionBits;
+const int kMaxSpillDepth = 4;
+
+size_t spillPartitionFor(size_t hash, int depth) {
+    const uint64_t mixed = GroupHashTable::mixHash(hash);
+    return (mixed >> (64 - kSpillPartitionBits * (depth + 1))) & (kNumSpillPartitions - 1);
+}
 
 bool containsOnlyFieldPathsAndConstants(ExpressionObject* expressionObj) {
     for (auto&& it : expressionObj->getChildExpressions()) {
@@ -427,25 +398,6 @@ void getFieldPathMap(ExpressionObject* expressionObj,
     }
 }
 
-void getFieldPathListForSpilled(ExpressionObject* expressionObj,
-                                std::string prefix,
-                                std::vector<std::string>* fields) {
-    // Given an expression, attempt to compute a vector of strings, each representing the path
-    // through the object to a leaf. For example, for the expression represented by
-    // {x: 2, y: {z: "$a.b"}}, the output would be ["x", "y.z"].
-    for (auto&& it : expressionObj->getChildExpressions()) {
-        intrusive_ptr<Expression> childExp = it.second;
-        ExpressionObject* expObj = dynamic_cast<ExpressionObject*>(childExp.get());
-
-        std::string newPrefix = prefix.empty() ? it.first : prefix + "." + it.first;
-
-        if (expObj) {
-            getFieldPathListForSpilled(expObj, newPrefix, fields);
-        } else {
-            fields->push_back(newPrefix);
-        }
-    }
-}
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
@@ -478,6 +430,31 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     }
 
 
+    if (!_groups) {
+        _groups.emplace(pExpCtx->getValueComparator(), numAccumulators);
+    }
+
+    // If the work can be split across threads, documents are gathered into batches that are
+    // pre-aggregated in parallel, and each batch is added to '_groups' before it can be spilled.
+    // Every batch is finished before this function returns, including when pausing.
+    const int maxWorkers = internalQueryExecParallelWorkers.load();
+    if (maxWorkers > 1 && canGroupInParallel()) {
+        const size_t batchSize =
+            maxWorkers * std::max(1, internalQueryExecParallelMinItemsPerWorker.load());
+        std::vector<Document> batch;
+        batch.reserve(batchSize);
+
+        GetNextResult input = pSource->getNext();
+        for (; input.isAdvanced(); input = pSource->getNext()) {
+            batch.push_back(input.releaseDocument());
+            if (batch.size() == batchSize) {
+                groupBatchInParallel(&batch, maxWorkers);
+            }
+        }
+        groupBatchInParallel(&batch, maxWorkers);
+        return finishInitialize(std::move(input));
+    }
+
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
     for (; input.isAdvanced(); input = pSource->getNext()) {
@@ -486,8 +463,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
                     _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
+            spill(&_spillFiles, 0);
         }
 
         // We release the result document here so that it does not outlive the end of this loop
@@ -495,31 +471,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         auto rootDocument = input.releaseDocument();
         Value id = computeId(rootDocument);
 
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
-            }
-        }
+        bool inserted;
+        intrusive_ptr<Accumulator>* group = findOrCreateGroup(id, &inserted);
 
         /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
         for (size_t i = 0; i < numAccumulators; i++) {
             group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
                               _doingMerge);
@@ -529,16 +484,20 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
             // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+            if (!inserted &&           // is a dup
+                !pExpCtx->inMongos &&  // can't spill to disk in mongos
+                !_allowDiskUse &&      // don't change behavior when testing external sort
+                _numSpills < 20) {     // don't spend too long rewriting the same groups
 
-                _sortedFiles.push_back(spill());
+                spill(&_spillFiles, 0);
             }
         }
     }
 
+    return finishInitialize(std::move(input));
+}
+
+DocumentSource::GetNextResult DocumentSourceGroup::finishInitialize(GetNextResult input) {
     switch (input.getStatus()) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
@@ -548,31 +507,18 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (!_spillFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
-                    _sortedFiles.push_back(spill());
+                    spill(&_spillFiles, 0);
                 }
-
-                // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
-
-                _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
-                    _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
-
-                // prepare current to accumulate data
-                _currentAccumulators.reserve(numAccumulators);
-                for (auto&& accumulatedField : _accumulatedFields) {
-                    _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
-                }
-
-                verify(_sorterIterator->more());  // we put data in, we should get something out.
-                _firstPartOfNextGroup = _sorterIterator->next();
-            } else {
-                // start the group iterator
-                groupsIterator = _groups->begin();
+                finishSpillFiles(&_spillFiles, 0);
             }
 
+            // Start returning groups from the beginning of the table, which is empty if we
+            // spilled. In that case getNextSpilled() loads the spilled partitions in turn.
+            _nextGroup = 0;
+
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
             _initialized = true;
@@ -582,44 +528,214 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     MONGO_UNREACHABLE;
 }
 
-shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(_groups->size());
-    for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
-        ptrs.push_back(&*it);
+bool DocumentSourceGroup::canGroupInParallel() const {
+    auto isSafe = [](Expression* expression) {
+        if (dynamic_cast<ExpressionFieldPath*>(expression) ||
+            dynamic_cast<ExpressionConstant*>(expression)) {
+            return true;
+        }
+        auto expressionObj = dynamic_cast<ExpressionObject*>(expression);
+        return expressionObj && containsOnlyFieldPathsAndConstants(expressionObj);
+    };
+
+    for (auto&& idExpression : _idExpressions) {
+        if (!isSafe(idExpression.get())) {
+            return false;
+        }
     }
+    for (auto&& accumulatedField : _accumulatedFields) {
+        if (!isSafe(accumulatedField.expression.get())) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+void DocumentSourceGroup::groupBatchInParallel(std::vector<Document>* batch, size_t maxWorkers) {
+    const size_t numAccumulators = _accumulatedFields.size();
 
-    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+    // The partial table of the chunk starting at each position. Chunk tables are not counted
+    // against the memory limit, which is instead bounded by the size of the batch.
+    std::vector<std::unique_ptr<GroupHashTable>> partials(batch->size());
+    parallel_batch::forEachChunk(
+        batch->size(),
+        maxWorkers,
+        internalQueryExecParallelMinItemsPerWorker.load(),
+        [&](size_t begin, size_t end) {
+            auto partial = stdx::make_unique<GroupHashTable>(pExpCtx->getValueComparator(),
+                                                             numAccumulators);
+            for (size_t i = begin; i < end; ++i) {
+                const Document& rootDocument = (*batch)[i];
+                const Value id = computeId(rootDocument);
+
+                bool inserted;
+                const size_t group = partial->findOrInsert(id, partial->hash(id), &inserted);
+                intrusive_ptr<Accumulator>* accums = partial->getAccumulators(group);
+                for (size_t j = 0; j < numAccumulators; j++) {
+                    if (inserted) {
+                        accums[j] = _accumulatedFields[j].makeAccumulator(pExpCtx);
+                    }
+                    accums[j]->process(_accumulatedFields[j].expression->evaluate(rootDocument),
+                                       _doingMerge);
+                }
             }
-            break;
+            partials[begin] = std::move(partial);
+        });
+    batch->clear();
 
-        case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+    for (auto&& partial : partials) {
+        if (!partial) {
+            continue;
+        }
+
+        for (size_t partialGroup = 0; partialGroup < partial->size(); partialGroup++) {
+            if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+                uassert(16945,
+                        "Exceeded memory limit for $group, but didn't allow external sort."
+                        " Pass allowDiskUse:true to opt in.",
+                        _allowDiskUse);
+                spill(&_spillFiles, 0);
             }
-            break;
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
+            bool inserted;
+            intrusive_ptr<Accumulator>* group =
+                findOrCreateGroup(partial->getId(partialGroup), &inserted);
+            const intrusive_ptr<Accumulator>* partialAccums =
+                partial->getAccumulators(partialGroup);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(partialAccums[i]->getValue(/*toBeMerged=*/true),
+                                  /*merging=*/true);
+                _memoryUsageBytes += group[i]->memUsageForSorter();
+            }
+        }
+        partial.reset();
+    }
+}
+
+intrusive_ptr<Accumulator>* DocumentSourceGroup::findOrCreateGroup(const Value& id,
+                                                                     bool* inserted) {
+    const size_t group = _groups->findOrInsert(id, _groups->hash(id), inserted);
+    intrusive_ptr<Accumulator>* accums = _groups->getAccumulators(group);
+
+    if (*inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        for (size_t i = 0; i < _accumulatedFields.size(); i++) {
+            accums[i] = _accumulatedFields[i].makeAccumulator(pExpCtx);
+        }
+    } else {
+        for (size_t i = 0; i < _accumulatedFields.size(); i++) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= accums[i]->memUsageForSorter();
+        }
+    }
+
+    return accums;
+}
+
+void DocumentSourceGroup::spill(SpillFiles* files, int depth) {
+    if (files->empty()) {
+        for (size_t i = 0; i < kNumSpillPartitions; i++) {
+            files->push_back(stdx::make_unique<SortedFileWriter<Value, Value>>(
+                SortOptions().TempDir(pExpCtx->tempDir)));
+        }
+    }
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t group = 0; group < _groups->size(); group++) {
+        const Value& id = _groups->getId(group);
+        const intrusive_ptr<Accumulator>* accums = _groups->getAccumulators(group);
+        auto& file = (*files)[spillPartitionFor(_groups->hash(id), depth)];
+
+        switch (numAccumulators) {
+            case 0:  // no values, essentially a distinct
+                file->addAlreadySorted(id, Value());
+                break;
+
+            case 1:  // just one value, use optimized serialization as single Value
+                file->addAlreadySorted(id, accums[0]->getValue(/*toBeMerged=*/true));
+                break;
+
+            default: {  // multiple values, serialize as array-typed Value
+                vector<Value> states;
+                states.reserve(numAccumulators);
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    states.push_back(accums[i]->getValue(/*toBeMerged=*/true));
                 }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+                file->addAlreadySorted(id, Value(std::move(states)));
+                break;
             }
-            break;
+        }
     }
 
     _groups->clear();
+    _memoryUsageBytes = 0;
+    _numSpills++;
+}
 
-    return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+void DocumentSourceGroup::finishSpillFiles(SpillFiles* files, int depth) {
+    for (auto&& file : *files) {
+        _spilledPartitions.push_back(
+            {shared_ptr<Sorter<Value, Value>::Iterator>(file->done()), depth});
+    }
+    files->clear();
+}
+
+void DocumentSourceGroup::loadNextSpilledPartition() {
+    SpilledPartition partition = std::move(_spilledPartitions.back());
+    _spilledPartitions.pop_back();
+
+    _groups->clear();
+    _nextGroup = 0;
+    _memoryUsageBytes = 0;
+
+    // Only used if the partition turns out to be too large to group in memory.
+    SpillFiles subpartitions;
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    while (partition.iterator->more()) {
+        pExpCtx->checkForInterrupt();
+        auto spilledGroup = partition.iterator->next();
+
+        if (!subpartitions.empty()) {
+            // The partial results read from here on are passed through as they are.
+            const size_t hash = _groups->hash(spilledGroup.first);
+            subpartitions[spillPartitionFor(hash, partition.depth + 1)]->addAlreadySorted(
+                spilledGroup.first, spilledGroup.second);
+            continue;
+        }
+
+        bool inserted;
+        intrusive_ptr<Accumulator>* group = findOrCreateGroup(spilledGroup.first, &inserted);
+        switch (numAccumulators) {  // mirrors switch in spill()
+            case 1:                 // Single accumulators serialize as a single Value.
+                group[0]->process(spilledGroup.second, true);
+            case 0:  // No accumulators so no Values.
+                break;
+            default: {  // Multiple accumulators serialize as an array of Values.
+                const vector<Value>& accumulatorStates = spilledGroup.second.getArray();
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    group[i]->process(accumulatorStates[i], true);
+                }
+            }
+        }
+        for (size_t i = 0; i < numAccumulators; i++) {
+            _memoryUsageBytes += group[i]->memUsageForSorter();
+        }
+
+        // Split the partition further if it is too large. With a single group, or once the
+        // partitioning bits run out, there is nothing left to split by, so the partition is
+        // grouped in memory even though that goes over the limit.
+        if (_memoryUsageBytes > _maxMemoryUsageBytes && _groups->size() > 1 &&
+            partition.depth < kMaxSpillDepth) {
+            spill(&subpartitions, partition.depth + 1);
+        }
+    }
+
+    if (!subpartitions.empty()) {
+        finishSpillFiles(&subpartitions, partition.depth + 1);
+    }
 }
 
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
@@ -695,27 +811,23 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
                        // False negatives are OK.
     }
 
-    if (!(_streaming || _spilled)) {
+    // Groups spilled to disk are partitioned by hash, so only a streaming $group has a sort order.
+    if (!_streaming) {
         return SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     }
 
     BSONObjBuilder sortOrder;
 
     if (_idFieldNames.empty()) {
-        if (_spilled) {
-            sortOrder.append("_id", 1);
-        } else {
-            // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is,
-            // get the sort order out of it.
-            if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
-                FieldPath _idSort = obj->getFieldPath();
-
-                sortOrder.append(
-                    "_id",
-                    _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
-            }
+        // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is,
+        // get the sort order out of it.
+        if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
+            FieldPath _idSort = obj->getFieldPath();
+
+            sortOrder.append(
+                "_id", _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
         }
-    } else if (_streaming) {
+    } else {
         // At this point, we know that _streaming is true, so _id must have only contained
         // ExpressionObjects, ExpressionConstants or ExpressionFieldPaths. We now process each
         // '_idExpression'.
@@ -749,28 +861,13 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
 
             sortOrder.append(itr->second, _inputSort.getIntField(sortString));
         }
-    } else {
-        // We are blocking and have spilled to disk.
-        std::vector<std::string> outputSort;
-        for (size_t i = 0; i < _idFieldNames.size(); i++) {
-            intrusive_ptr<Expression> exp = _idExpressions[i];
-            if (auto obj = dynamic_cast<ExpressionObject*>(exp.get())) {
-                // _id is an object containing a nested document, such as: {_id: {x: {y: "$b"}}}.
-                getFieldPathListForSpilled(obj, "_id." + _idFieldNames[i], &outputSort);
-            } else {
-                outputSort.push_back("_id." + _idFieldNames[i]);
-            }
-        }
-        for (auto&& field : outputSort) {
-            sortOrder.append(field, 1);
-        }
     }
 
     return allPrefixes(sortOrder.obj());
 }
 
 
-Value DocumentSourceGroup::computeId(const Document& root) {
+Value DocumentSourceGroup::computeId(const Document& root) const {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
         Value retValue = _idExpressions[0]->evaluate(root);
@@ -806,7 +903,7 @@ Value DocumentSourceGroup::expandId(const Value& val) {
 }
 
 Document DocumentSourceGroup::makeDocument(const Value& id,
-                                           const Accumulators& accums,
+                                           const intrusive_ptr<Accumulator>* accums,
                                            bool mergeableOutput) {
     const size_t n = _accumulatedFields.size();
     MutableDocument out(1 + n);
@@ -34,6 +34,7 @@
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/group_hash_table.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
@@ -41,7 +42,6 @@ namespace mongo {
 class DocumentSourceGroup final : public DocumentSource, public SplittableDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
-    using GroupsMap = ValueUnorderedMap<Accumulators>;
 
     static const size_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
@@ -136,19 +136,64 @@ private:
      */
     GetNextResult initialize();
 
+    using SpillFiles = std::vector<std::unique_ptr<SortedFileWriter<Value, Value>>>;
+
+    /**
+     * Writes the partial result of every group in '_groups' to one of 'files', chosen by the hash
+     * of the group's _id at the given partitioning depth, and empties '_groups'. Creates the files
+     * if 'files' is empty. Note: Since a sorted $group does not exhaust the previous stage before
+     * returning, and thus does not maintain as large a store of documents at any one time, only
+     * an unsorted group can spill to disk.
+     */
+    void spill(SpillFiles* files, int depth);
+
+    /**
+     * Moves 'files' to the list of spilled partitions still to be returned.
+     */
+    void finishSpillFiles(SpillFiles* files, int depth);
+
+    /**
+     * Replaces the contents of '_groups' with the next spilled partition, merging the partial
+     * results spilled for each _id. If the partition does not fit in memory, it is instead split
+     * into smaller partitions by a further level of hashing and '_groups' is left empty.
+     */
+    void loadNextSpilledPartition();
+
+    /**
+     * Completes initialize() once 'pSource' has returned 'input', which is not an advanced result:
+     * propagates a pause, or prepares to return the groups at EOF.
+     */
+    GetNextResult finishInitialize(GetNextResult input);
+
     /**
-     * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
-     * does not exhaust the previous stage before returning, and thus does not maintain as large a
-     * store of documents at any one time, only an unsorted group can spill to disk.
+     * Returns the accumulators of the group in '_groups' with the given _id, creating the group if
+     * there isn't one. Their current memory usage is taken out of '_memoryUsageBytes'; the caller
+     * must add it back once it has finished updating them.
      */
-    std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
+    boost::intrusive_ptr<Accumulator>* findOrCreateGroup(const Value& id, bool* inserted);
 
-    Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
+    /**
+     * Returns true if the _id and every accumulator argument can be evaluated from several threads
+     * at once, which holds for field paths, constants and objects built only from those.
+     */
+    bool canGroupInParallel() const;
+
+    /**
+     * Adds the documents of 'batch' to '_groups', in order, and empties 'batch'. The batch is split
+     * into at most 'maxWorkers' consecutive chunks, each grouped into its own table on a worker
+     * thread. The partial results of each chunk are then merged into '_groups' in chunk order, so
+     * order-dependent accumulators such as $first and $push see their inputs in the usual order.
+     */
+    void groupBatchInParallel(std::vector<Document>* batch, size_t maxWorkers);
+
+    Document makeDocument(const Value& id,
+                          const boost::intrusive_ptr<Accumulator>* accums,
+                          bool mergeableOutput);
 
     /**
      * Computes the internal representation of the group key.
      */
-    Value computeId(const Document& root);
+    Value computeId(const Document& root) const;
 
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
@@ -174,19 +219,28 @@ private:
     // We use boost::optional to defer initialization until the ExpressionContext containing the
     // correct comparator is injected, since the groups must be built using the comparator's
     // definition of equality.
-    boost::optional<GroupsMap> _groups;
+    boost::optional<GroupHashTable> _groups;
 
-    std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
-    bool _spilled;
+    // The number of the next group in '_groups' to return.
+    size_t _nextGroup = 0;
 
-    // Only used when '_spilled' is false.
-    GroupsMap::iterator groupsIterator;
-
-    // Only used when '_spilled' is true.
-    std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
+    // Rather than sorting spilled groups by _id and merging the sorted files, a $group that runs
+    // out of memory spreads its groups over a fixed number of files by hash of _id. All partial
+    // results for an _id then land in the same file, and each file can later be grouped in
+    // memory on its own. '_spillFiles' are the files being written while consuming the input.
+    SpillFiles _spillFiles;
+    bool _spilled;
+    int _numSpills = 0;
+
+    // Only used when '_spilled' is true. The partitions not yet loaded into '_groups', along with
+    // how many times their _ids have been partitioned.
+    struct SpilledPartition {
+        std::shared_ptr<Sorter<Value, Value>::Iterator> iterator;
+        int depth;
+    };
+    std::vector<SpilledPartition> _spilledPartitions;
     const bool _allowDiskUse;
 
-    std::pair<Value, Value> _firstPartOfNextGroup;
     // Only used when '_sorted' is true.
     boost::optional<Document> _firstDocOfNextGroup;
 };
@@ -47,12 +47,14 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -139,6 +141,49 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldMergeSpilledPartitionsThatDoNotFitInMemory) {
+    auto expCtx = getExpCtx();
+
+    // Allow the $group stage to spill to disk, with too little memory to hold even one of the
+    // spilled partitions.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {countStatement}, maxMemoryUsageBytes);
+
+    const int numGroups = 500;
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int copy = 0; copy < 3; ++copy) {
+        for (int i = 0; i < numGroups; ++i) {
+            inputs.push_back(Document{{"a", i}});
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    // Every group should be returned once, with the counts from every spill merged.
+    map<int, int> counts;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(0UL, counts.count(doc["_id"].coerceToInt()));
+        counts[doc["_id"].coerceToInt()] = doc["count"].coerceToInt();
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    ASSERT_EQ(size_t(numGroups), counts.size());
+    for (auto&& count : counts) {
+        ASSERT_EQ(3, count.second);
+    }
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -189,6 +234,67 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16945);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldPreAggregateInParallelInInputOrder) {
+    auto expCtx = getExpCtx();
+    const int oldWorkers = internalQueryExecParallelWorkers.load();
+    const int oldMinItems = internalQueryExecParallelMinItemsPerWorker.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryExecParallelWorkers.store(oldWorkers);
+        internalQueryExecParallelMinItemsPerWorker.store(oldMinItems);
+    });
+    internalQueryExecParallelWorkers.store(4);
+    internalQueryExecParallelMinItemsPerWorker.store(10);
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto group = DocumentSourceGroup::create(
+        expCtx,
+        ExpressionFieldPath::parse(expCtx, "$a", vps),
+        {AccumulationStatement{"count",
+                               ExpressionConstant::create(expCtx, Value(1)),
+                               AccumulationStatement::getFactory("$sum")},
+         AccumulationStatement{"first",
+                               ExpressionFieldPath::parse(expCtx, "$b", vps),
+                               AccumulationStatement::getFactory("$first")},
+         AccumulationStatement{"all",
+                               ExpressionFieldPath::parse(expCtx, "$b", vps),
+                               AccumulationStatement::getFactory("$push")}});
+
+    // Spans several batches of 40 documents, with a pause in the middle of one.
+    const int numGroups = 7;
+    const int numDocs = 150;
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.push_back(Document{{"a", i % numGroups}, {"b", i}});
+        if (i == 55) {
+            inputs.push_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    auto result = group->getNext();
+    ASSERT_TRUE(result.isPaused());
+
+    map<int, Document> groups;
+    for (result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        groups[doc["_id"].coerceToInt()] = doc;
+    }
+    ASSERT_TRUE(result.isEOF());
+
+    ASSERT_EQ(size_t(numGroups), groups.size());
+    for (auto&& entry : groups) {
+        const int a = entry.first;
+        vector<Value> expected;
+        for (int b = a; b < numDocs; b += numGroups) {
+            expected.push_back(Value(b));
+        }
+        ASSERT_EQ(int(expected.size()), entry.second["count"].coerceToInt());
+        ASSERT_VALUE_EQ(Value(a), entry.second["first"]);
+        ASSERT_VALUE_EQ(Value(expected), entry.second["all"]);
+    }
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
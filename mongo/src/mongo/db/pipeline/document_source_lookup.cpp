@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/document_source_lookup.h"
 
 #include "mongo/base/init.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document.h"
@@ -38,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
@@ -221,27 +223,35 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
-
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto appendResult = [&](Document&& result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline "
                               << getUserPipelineDefinition()
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    if (auto matches = probeHashTable(inputDoc)) {
+        for (auto&& match : *matches) {
+            appendResult(std::move(match));
+        }
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        auto pipeline = buildPipeline(inputDoc);
+        while (auto result = pipeline->getNext()) {
+            appendResult(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -249,6 +259,127 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+void DocumentSourceLookUp::tryBuildHashTable() {
+    invariant(!_triedHashTable);
+    _triedHashTable = true;
+
+    const int maxSizeBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+    if (wasConstructedWithPipelineSyntax() || maxSizeBytes <= 0 ||
+        !LookUpHashTable::canHashOnPath(*_foreignField) || !shouldBuildHashTable(maxSizeBytes)) {
+        return;
+    }
+
+    // Read the foreign collection through the same pipeline as the per-document sub-queries, with
+    // only the filter absorbed from a following $match in place of the join predicate.
+    auto foreignPipeline = _resolvedPipeline;
+    foreignPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline =
+        uassertStatusOK(_mongoProcessInterface->makePipeline(foreignPipeline, _fromExpCtx));
+
+    _hashTable.emplace(*_foreignField, _fromExpCtx->getValueComparator(), maxSizeBytes);
+    while (auto foreignDoc = pipeline->getNext()) {
+        if (!_hashTable->insert(std::move(*foreignDoc))) {
+            // Too large to hold in memory. Fall back to a sub-query per input document.
+            _hashTable = boost::none;
+            return;
+        }
+    }
+}
+
+bool DocumentSourceLookUp::shouldBuildHashTable(long long maxSizeBytes) {
+    BSONObjBuilder statsBuilder;
+    auto status =
+        _mongoProcessInterface->appendStorageStats(_resolvedNs, BSONObj(), &statsBuilder);
+    if (status == ErrorCodes::NamespaceNotFound) {
+        // Nothing to read, and every sub-query would come back empty.
+        return true;
+    }
+    if (!status.isOK()) {
+        return false;
+    }
+
+    const long long dataSizeBytes = statsBuilder.obj()["size"].safeNumberLong();
+    if (dataSizeBytes <= internalDocumentSourceLookupHashJoinIndexedCollectionMaxBytes.load()) {
+        return true;
+    }
+    if (dataSizeBytes > maxSizeBytes) {
+        // The build would be abandoned after reading most of the collection.
+        return false;
+    }
+    return !foreignFieldIsIndexed();
+}
+
+bool DocumentSourceLookUp::foreignFieldIsIndexed() {
+    // A view's pipeline may rename or compute the foreign field, and may still let the sub-queries
+    // use an index on the underlying collection, so assume that it does.
+    if (_resolvedPipeline.size() > 1) {
+        return true;
+    }
+
+    const auto collator = _fromExpCtx->getCollator();
+    const BSONObj collation = collator ? collator->getSpec().toBSON() : BSONObj();
+    for (auto&& spec : _mongoProcessInterface->getIndexSpecs(_resolvedNs)) {
+        if (spec.hasField("partialFilterExpression")) {
+            continue;
+        }
+
+        // Only an index leading with the foreign field can answer an equality on it. Text and
+        // geo indexes cannot.
+        auto firstKey = spec.getObjectField("key").firstElement();
+        if (!firstKey || firstKey.fieldNameStringData() != _foreignField->fullPath() ||
+            (firstKey.type() == String && firstKey.valueStringData() != "hashed")) {
+            continue;
+        }
+
+        if (SimpleBSONObjComparator::kInstance.evaluate(spec.getObjectField("collation") ==
+                                                        collation)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+boost::optional<std::vector<Document>> DocumentSourceLookUp::probeHashTable(
+    const Document& inputDoc) {
+    if (wasConstructedWithPipelineSyntax()) {
+        return boost::none;
+    }
+
+    if (!_triedHashTable) {
+        tryBuildHashTable();
+    }
+
+    if (!_hashTable) {
+        return boost::none;
+    }
+
+    std::vector<Value> localValues;
+    bool canProbe = true;
+    document_path_support::visitAllValuesAtPath(
+        inputDoc, *_localField, [&localValues, &canProbe](const Value& localValue) {
+            canProbe = canProbe && LookUpHashTable::canProbe(localValue);
+            localValues.push_back(localValue);
+        });
+
+    // A missing local value is treated as null, which the table cannot answer for.
+    if (localValues.empty() || !canProbe) {
+        return boost::none;
+    }
+
+    return _hashTable->probe(localValues);
+}
+
+boost::optional<Document> DocumentSourceLookUp::getNextForeignDocument() {
+    if (_hashMatches) {
+        if (_hashMatchIndex == _hashMatches->size()) {
+            return boost::none;
+        }
+        return (*_hashMatches)[_hashMatchIndex++];
+    }
+
+    return _pipeline->getNext();
+}
+
 std::unique_ptr<Pipeline, Pipeline::Deleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -436,6 +567,8 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashMatches = boost::none;
+    _hashTable = boost::none;
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -528,7 +661,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
+    while ((!_pipeline && !_hashMatches) || !_nextValue) {
         auto nextInput = pSource->getNext();
         if (!nextInput.isAdvanced()) {
             return nextInput;
@@ -536,27 +669,34 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
-
         if (_pipeline) {
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
 
-        _pipeline = buildPipeline(*_input);
+        _hashMatches = probeHashTable(*_input);
+        _hashMatchIndex = 0;
+
+        if (!_hashMatches) {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
+
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextForeignDocument();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -574,7 +714,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextForeignDocument();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
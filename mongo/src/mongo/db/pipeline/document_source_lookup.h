@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -244,6 +245,40 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Called on the first input document of a localField/foreignField $lookup. Reads the foreign
+     * collection into '_hashTable' if that is enabled, worthwhile according to
+     * shouldBuildHashTable(), and the table stays within
+     * internalDocumentSourceLookupHashJoinMaxBytes. Otherwise leaves '_hashTable' empty, and each
+     * input document is joined by its own sub-query as before.
+     */
+    void tryBuildHashTable();
+
+    /**
+     * Returns whether reading the whole foreign collection into a hash table is expected to be
+     * cheaper than a sub-query per input document. That is the case when the foreign collection
+     * is small, or when no index can answer the sub-queries so each of them scans the collection.
+     */
+    bool shouldBuildHashTable(long long maxSizeBytes);
+
+    /**
+     * Returns whether the foreign collection has an index which the per-document sub-queries can
+     * use to find the documents matching on 'foreignField'.
+     */
+    bool foreignFieldIsIndexed();
+
+    /**
+     * Returns the foreign documents which join with 'inputDoc' if they can be found in
+     * '_hashTable', or boost::none if a sub-query must be run for 'inputDoc'.
+     */
+    boost::optional<std::vector<Document>> probeHashTable(const Document& inputDoc);
+
+    /**
+     * Returns the next foreign document joining with '_input' while unwinding, taken from either
+     * '_hashMatches' or '_pipeline'.
+     */
+    boost::optional<Document> getNextForeignDocument();
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -307,6 +342,12 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // For localField/foreignField syntax, the foreign collection read into memory once so that
+    // input documents can be joined without a sub-query each. Empty if it has not been built yet,
+    // or if it was not possible or too large to build.
+    bool _triedHashTable = false;
+    boost::optional<LookUpHashTable> _hashTable;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -330,6 +371,8 @@ private:
     // not null.
     long long _cursorIndex = 0;
     std::unique_ptr<Pipeline, Pipeline::Deleter> _pipeline;
+    boost::optional<std::vector<Document>> _hashMatches;
+    size_t _hashMatchIndex = 0;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
 };
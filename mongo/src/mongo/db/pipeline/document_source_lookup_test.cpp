@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -523,6 +524,7 @@ public:
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -554,9 +556,36 @@ public:
         return Status::OK();
     }
 
+    Status appendStorageStats(const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        builder->appendNumber("size", _dataSizeBytes);
+        return Status::OK();
+    }
+
+    std::list<BSONObj> getIndexSpecs(const NamespaceString& nss) final {
+        return _indexSpecs;
+    }
+
+    /**
+     * Sets the size and indexes reported for the foreign collection. By default it is empty and
+     * has no indexes.
+     */
+    void setForeignCollectionStats(long long dataSizeBytes, std::list<BSONObj> indexSpecs) {
+        _dataSizeBytes = dataSizeBytes;
+        _indexSpecs = std::move(indexSpecs);
+    }
+
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    long long _dataSizeBytes = 0;
+    std::list<BSONObj> _indexSpecs;
+    int _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -663,6 +692,130 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, HashJoinMatchesPerDocumentSubQueries) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto runLookup = [&](int hashJoinMaxBytes) {
+        const auto originalMaxBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+        internalDocumentSourceLookupHashJoinMaxBytes.store(hashJoinMaxBytes);
+        ON_BLOCK_EXIT(
+            [&] { internalDocumentSourceLookupHashJoinMaxBytes.store(originalMaxBytes); });
+
+        auto lookupSpec = Document{{"$lookup",
+                                    Document{{"from", fromNs.coll()},
+                                             {"localField", "foreignId"_sd},
+                                             {"foreignField", "key"_sd},
+                                             {"as", "foreignDocs"_sd}}}}
+                              .toBson();
+        auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+        auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+        // The local documents join on a scalar, on an array, on a null and on a missing field.
+        auto mockLocalSource = DocumentSourceMock::create(
+            {"{_id: 0, foreignId: 1}", "{_id: 1, foreignId: [1, 2]}", "{_id: 2, foreignId: null}",
+             "{_id: 3}"});
+        lookup->setSource(mockLocalSource.get());
+
+        deque<DocumentSource::GetNextResult> mockForeignContents{
+            Document(fromjson("{_id: 0, key: 1}")),
+            Document(fromjson("{_id: 1, key: [2, 3]}")),
+            Document(fromjson("{_id: 2, key: 3}")),
+            Document(fromjson("{_id: 3}"))};
+        lookup->injectMongoProcessInterface(
+            std::make_shared<MockMongoProcessInterface>(std::move(mockForeignContents)));
+
+        std::vector<Document> results;
+        for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+            results.push_back(next.releaseDocument());
+        }
+        lookup->dispose();
+        return results;
+    };
+
+    const std::vector<Document> expected{
+        Document(fromjson("{_id: 0, foreignId: 1, foreignDocs: [{_id: 0, key: 1}]}")),
+        Document(fromjson(
+            "{_id: 1, foreignId: [1, 2], foreignDocs: [{_id: 0, key: 1}, {_id: 1, key: [2, 3]}]}")),
+        Document(fromjson("{_id: 2, foreignId: null, foreignDocs: [{_id: 3}]}")),
+        Document(fromjson("{_id: 3, foreignDocs: [{_id: 3}]}"))};
+
+    // Join through the hash table, then again with a size limit that is too small to build it.
+    for (int hashJoinMaxBytes : {1024 * 1024, 1}) {
+        auto results = runLookup(hashJoinMaxBytes);
+        ASSERT_EQ(expected.size(), results.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_DOCUMENT_EQ(expected[i], results[i]);
+        }
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinIsOnlyUsedForSmallOrUnindexedForeignCollections) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    const long long kLargeCollectionBytes =
+        internalDocumentSourceLookupHashJoinIndexedCollectionMaxBytes.load() + 1;
+    const std::list<BSONObj> kKeyIndex{BSON("v" << 2 << "key" << BSON("key" << 1) << "name"
+                                                << "key_1")};
+    const std::list<BSONObj> kPartialKeyIndex{
+        BSON("v" << 2 << "key" << BSON("key" << 1) << "name"
+                 << "key_1"
+                 << "partialFilterExpression"
+                 << BSON("key" << BSON("$gt" << 0)))};
+    const std::list<BSONObj> kCompoundIndex{BSON("v" << 2 << "key" << BSON("other" << 1 << "key"
+                                                                               << 1)
+                                                     << "name"
+                                                     << "other_1_key_1")};
+
+    // Returns how many pipelines the $lookup made to join three input documents.
+    auto countPipelinesMade = [&](long long dataSizeBytes, std::list<BSONObj> indexSpecs) {
+        auto lookupSpec = Document{{"$lookup",
+                                    Document{{"from", fromNs.coll()},
+                                             {"localField", "foreignId"_sd},
+                                             {"foreignField", "key"_sd},
+                                             {"as", "foreignDocs"_sd}}}}
+                              .toBson();
+        auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+        auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+        auto mockLocalSource = DocumentSourceMock::create(
+            {"{_id: 0, foreignId: 1}", "{_id: 1, foreignId: 2}", "{_id: 2, foreignId: 3}"});
+        lookup->setSource(mockLocalSource.get());
+
+        deque<DocumentSource::GetNextResult> mockForeignContents{
+            Document(fromjson("{_id: 0, key: 1}")), Document(fromjson("{_id: 1, key: 3}"))};
+        auto mongoProcessInterface =
+            std::make_shared<MockMongoProcessInterface>(std::move(mockForeignContents));
+        mongoProcessInterface->setForeignCollectionStats(dataSizeBytes, std::move(indexSpecs));
+        lookup->injectMongoProcessInterface(mongoProcessInterface);
+
+        int numResults = 0;
+        for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+            ++numResults;
+        }
+        ASSERT_EQ(3, numResults);
+        lookup->dispose();
+        return mongoProcessInterface->numPipelinesMade();
+    };
+
+    // A small foreign collection is read once, whether or not it is indexed.
+    ASSERT_EQ(1, countPipelinesMade(0, {}));
+    ASSERT_EQ(1, countPipelinesMade(0, kKeyIndex));
+
+    // A larger one is only read once if no index can answer the sub-queries.
+    ASSERT_EQ(1, countPipelinesMade(kLargeCollectionBytes, {}));
+    ASSERT_EQ(1, countPipelinesMade(kLargeCollectionBytes, kPartialKeyIndex));
+    ASSERT_EQ(1, countPipelinesMade(kLargeCollectionBytes, kCompoundIndex));
+    ASSERT_EQ(3, countPipelinesMade(kLargeCollectionBytes, kKeyIndex));
+
+    // A collection too large for the hash table is never read in full.
+    const long long kTooLargeBytes = internalDocumentSourceLookupHashJoinMaxBytes.load() + 1LL;
+    ASSERT_EQ(3, countPipelinesMade(kTooLargeBytes, {}));
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -122,26 +122,43 @@ void DocumentSourceOut::initialize() {
                 ok);
     }
 
-    // copy indexes to _tempNs
-    for (std::list<BSONObj>::const_iterator it = _originalIndexes.begin();
-         it != _originalIndexes.end();
-         ++it) {
-        MutableDocument index((Document(*it)));
+    // The indexes of the target collection, other than the _id index the temporary collection
+    // already has, are only copied once all the documents are in. See createIndexes().
+    _initialized = true;
+}
+
+void DocumentSourceOut::createIndexes() {
+    vector<BSONObj> indexes;
+    for (auto&& spec : _originalIndexes) {
+        if (spec["name"].valueStringData() == "_id_") {
+            continue;
+        }
+
+        MutableDocument index((Document(spec)));
         index.remove("_id");  // indexes shouldn't have _ids but some existing ones do
         index["ns"] = Value(_tempNs.ns());
+        indexes.push_back(index.freeze().toBson());
+    }
 
-        BSONObj indexBson = index.freeze().toBson();
-        conn->insert(_tempNs.getSystemIndexesCollection(), indexBson);
-        BSONObj err = conn->getLastErrorDetailed();
-        uassert(16995,
-                str::stream() << "copying index for $out failed."
-                              << " index: "
-                              << indexBson
-                              << " error: "
-                              << err,
-                DBClientBase::getLastErrorString(err).empty());
+    if (indexes.empty()) {
+        return;
+    }
+
+    // Nothing else writes to the temporary collection, so all of the indexes are bulk-loaded in
+    // one scan of it, without locking the rest of the database for the duration of the build.
+    Status status = _mongoProcessInterface->createIndexes(_tempNs, indexes);
+    if (!status.isOK()) {
+        BSONArrayBuilder specs;
+        for (auto&& index : indexes) {
+            specs.append(index);
+        }
+        uasserted(16995,
+                  str::stream() << "copying indexes for $out failed."
+                                << " indexes: "
+                                << specs.arr()
+                                << " error: "
+                                << status.toString());
     }
-    _initialized = true;
 }
 
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
@@ -190,6 +207,7 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            createIndexes();
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
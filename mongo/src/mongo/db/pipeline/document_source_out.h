@@ -86,12 +86,19 @@ private:
      * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
      * sharded or capped, and saves the collection options and indexes of the target collection.
      * Then creates the temporary collection we will insert into by copying the collection options
-     * and indexes from the target collection.
+     * from the target collection.
      *
      * Sets '_initialized' to true upon completion.
      */
     void initialize();
 
+    /**
+     * Builds the indexes of the target collection on the temporary collection. Called once all the
+     * documents have been inserted, so that each index is bulk-loaded from sorted keys instead of
+     * being updated by every insert.
+     */
+    void createIndexes();
+
     /**
      * Inserts all of 'toInsert' into the temporary collection.
      */
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/thread.h"
 
 namespace DocumentTests {
 
@@ -113,6 +114,77 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, FromBsonLazilyAnswersLookupsFromBson) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << 2));
+    Document document = Document::fromBsonLazily(bson);
+    ASSERT_VALUE_EQ(Value(1), document["a"]);
+    ASSERT_VALUE_EQ(Value(2), document.getNestedField(FieldPath("b.c")));
+    ASSERT_TRUE(document["missing"].missing());
+    ASSERT_EQ(2U, document.size());
+    ASSERT_FALSE(document.empty());
+    ASSERT_EQ(bson.objdata(), document.toBson().objdata());
+}
+
+TEST(DocumentConstruction, FromBsonLazilyMatchesEagerConversion) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON_ARRAY(1 << 2) << "c"
+                            << "x"
+                            << "d" << 4.5 << "e" << BSONNULL);
+    Document lazy = Document::fromBsonLazily(bson);
+    Document eager(bson);
+    ASSERT_DOCUMENT_EQ(eager, lazy);
+    ASSERT_EQ(Document::compare(eager, lazy, nullptr), 0);
+    ASSERT_BSONOBJ_EQ(bson, lazy.toBson());
+
+    mongo::FieldIterator it(lazy);
+    ASSERT_EQ("a", it.next().first);
+    ASSERT_EQ("b", it.next().first);
+
+    ASSERT_TRUE(Document::fromBsonLazily(BSONObj()).empty());
+}
+
+TEST(DocumentConstruction, FromBsonLazilyCanBeReadFromSeveralThreads) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < 50; ++i) {
+        bob.append(str::stream() << "f" << i, i);
+    }
+    BSONObj bson = bob.obj();
+    Document document = Document::fromBsonLazily(bson);
+
+    // Some threads iterate, which builds the field table, while others look fields up by name.
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            if (t % 2) {
+                ASSERT_DOCUMENT_EQ(Document(bson), document);
+            }
+            for (int i = 0; i < 50; ++i) {
+                ASSERT_VALUE_EQ(Value(i), document[std::string(str::stream() << "f" << i)]);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(bson.objdata(), document.toBson().objdata());
+}
+
+TEST(DocumentConstruction, FromBsonLazilyIsCopiedWhenModifiedEvenIfUnshared) {
+    MutableDocument md(Document::fromBsonLazily(BSON("a" << 1 << "b" << 2)));
+    md["a"] = Value(3);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 3 << "b" << 2), md.freeze().toBson());
+}
+
+TEST(DocumentConstruction, FromBsonLazilyCanBeModified) {
+    Document original = Document::fromBsonLazily(BSON("a" << 1 << "b" << 2));
+    MutableDocument md(original);
+    md["b"] = Value(3);
+    md["c"] = Value(4);
+    Document modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 3 << "c" << 4), modified.toBson());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 2), original.toBson());
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_hash_table.h"
+
+#include <limits>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const size_t kInitialNumSlots = 16;
+
+}  // namespace
+
+GroupHashTable::GroupHashTable(const ValueComparator& comparator, size_t numAccumulators)
+    : _comparator(comparator), _numAccumulators(numAccumulators) {}
+
+uint64_t GroupHashTable::mixHash(uint64_t hash) {
+    // The finalizer of MurmurHash3, which makes every input bit affect every output bit.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+size_t GroupHashTable::findOrInsert(const Value& id, size_t hash, bool* inserted) {
+    if ((_ids.size() + 1) * 4 > _slots.size() * 3) {
+        grow();
+    }
+
+    const uint32_t hashBits = static_cast<uint32_t>(mixHash(hash));
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = hashBits & mask;; i = (i + 1) & mask) {
+        Slot& slot = _slots[i];
+        if (slot.groupPlusOne == 0) {
+            uassert(ErrorCodes::ExceededMemoryLimit,
+                    "Too many groups for $group",
+                    _ids.size() < std::numeric_limits<uint32_t>::max());
+            slot.hashBits = hashBits;
+            slot.groupPlusOne = static_cast<uint32_t>(_ids.size() + 1);
+            _ids.push_back(id);
+            _accumulators.resize(_accumulators.size() + _numAccumulators);
+            *inserted = true;
+            return _ids.size() - 1;
+        }
+
+        const size_t group = slot.groupPlusOne - 1;
+        if (slot.hashBits == hashBits && _comparator.evaluate(_ids[group] == id)) {
+            *inserted = false;
+            return group;
+        }
+    }
+}
+
+void GroupHashTable::grow() {
+    std::vector<Slot> oldSlots(std::max(kInitialNumSlots, _slots.size() * 2), Slot{0, 0});
+    oldSlots.swap(_slots);
+
+    const size_t mask = _slots.size() - 1;
+    for (const Slot& slot : oldSlots) {
+        if (slot.groupPlusOne == 0) {
+            continue;
+        }
+        size_t i = slot.hashBits & mask;
+        while (_slots[i].groupPlusOne != 0) {
+            i = (i + 1) & mask;
+        }
+        _slots[i] = slot;
+    }
+}
+
+void GroupHashTable::clear() {
+    std::vector<Value>().swap(_ids);
+    std::vector<boost::intrusive_ptr<Accumulator>>().swap(_accumulators);
+    std::vector<Slot>().swap(_slots);
+}
+
+}  // namespace mongo
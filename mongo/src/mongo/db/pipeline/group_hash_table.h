@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * The table of groups built by a blocking $group. Each group is numbered in the order it was
+ * added; its _id is kept in one flat vector and the pointers to its accumulators in another, back
+ * to back with those of the other groups. Groups are located by hash through an open-addressing
+ * index of fixed-size slots probed linearly.
+ *
+ * Compared to an unordered map from _id to a vector of accumulators, this saves a map node, a
+ * bucket pointer and a separately allocated vector for every group. The accumulators themselves
+ * are still allocated one by one, since each kind keeps its own state.
+ */
+class GroupHashTable {
+public:
+    /**
+     * The table hashes and compares _ids using 'comparator', which must outlive it. Every group
+     * holds 'numAccumulators' accumulators.
+     */
+    GroupHashTable(const ValueComparator& comparator, size_t numAccumulators);
+
+    /**
+     * Returns the number of the group with the given _id. If there is none, adds one, sets
+     * '*inserted' to true and leaves its accumulators null for the caller to create. 'hash' must
+     * be hash(id).
+     */
+    size_t findOrInsert(const Value& id, size_t hash, bool* inserted);
+
+    size_t hash(const Value& id) const {
+        return _comparator.hash(id);
+    }
+
+    /**
+     * Spreads the bits of a hash computed by hash(), whose low bits alone are poorly distributed.
+     * The table picks slots from the low 32 bits of the result, so users partitioning groups by
+     * hash should take their bits from the top.
+     */
+    static uint64_t mixHash(uint64_t hash);
+
+    const Value& getId(size_t group) const {
+        return _ids[group];
+    }
+
+    /**
+     * Returns the first of the group's accumulators. Invalidated by the next findOrInsert().
+     */
+    boost::intrusive_ptr<Accumulator>* getAccumulators(size_t group) {
+        return _accumulators.data() + group * _numAccumulators;
+    }
+
+    size_t size() const {
+        return _ids.size();
+    }
+
+    bool empty() const {
+        return _ids.empty();
+    }
+
+    /**
+     * Removes every group and releases the memory held by the table.
+     */
+    void clear();
+
+private:
+    // An entry of the index. 'groupPlusOne' is zero for an empty slot. 'hashBits' caches the mixed
+    // hash of the group's _id, which both picks the slot and lets most mismatches be rejected
+    // without comparing _ids, so growing the index never needs to rehash an _id.
+    struct Slot {
+        uint32_t hashBits;
+        uint32_t groupPlusOne;
+    };
+
+    void grow();
+
+    const ValueComparator& _comparator;
+    const size_t _numAccumulators;
+
+    std::vector<Value> _ids;
+    std::vector<boost::intrusive_ptr<Accumulator>> _accumulators;
+
+    // Always empty or a power of two in size, and at most three quarters full.
+    std::vector<Slot> _slots;
+};
+
+}  // namespace mongo
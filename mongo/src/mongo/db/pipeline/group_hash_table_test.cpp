@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_hash_table.h"
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator defaultComparator{nullptr};
+
+size_t findOrInsert(GroupHashTable* table, const Value& id, bool* inserted) {
+    return table->findOrInsert(id, table->hash(id), inserted);
+}
+
+TEST(GroupHashTableTest, GroupsAreNumberedInInsertionOrder) {
+    GroupHashTable table(defaultComparator, 2);
+    bool inserted;
+
+    ASSERT_EQ(0U, findOrInsert(&table, Value("b"_sd), &inserted));
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(1U, findOrInsert(&table, Value("a"_sd), &inserted));
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(0U, findOrInsert(&table, Value("b"_sd), &inserted));
+    ASSERT_FALSE(inserted);
+
+    ASSERT_EQ(2U, table.size());
+    ASSERT_VALUE_EQ(Value("b"_sd), table.getId(0));
+    ASSERT_VALUE_EQ(Value("a"_sd), table.getId(1));
+}
+
+TEST(GroupHashTableTest, NewGroupsHaveNullAccumulators) {
+    GroupHashTable table(defaultComparator, 3);
+    bool inserted;
+
+    const size_t group = findOrInsert(&table, Value(1), &inserted);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_FALSE(table.getAccumulators(group)[i]);
+    }
+}
+
+TEST(GroupHashTableTest, NumericTypesCompareByValue) {
+    GroupHashTable table(defaultComparator, 0);
+    bool inserted;
+
+    findOrInsert(&table, Value(1), &inserted);
+    findOrInsert(&table, Value(1.0), &inserted);
+    ASSERT_FALSE(inserted);
+    findOrInsert(&table, Value(1LL), &inserted);
+    ASSERT_FALSE(inserted);
+    ASSERT_EQ(1U, table.size());
+}
+
+TEST(GroupHashTableTest, UsesComparatorForStringEquality) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    ValueComparator comparator(&collator);
+    GroupHashTable table(comparator, 0);
+    bool inserted;
+
+    findOrInsert(&table, Value("foo"_sd), &inserted);
+    ASSERT_TRUE(inserted);
+    findOrInsert(&table, Value("bar"_sd), &inserted);
+    ASSERT_FALSE(inserted);
+    ASSERT_EQ(1U, table.size());
+}
+
+TEST(GroupHashTableTest, FindsEveryGroupAfterGrowing) {
+    GroupHashTable table(defaultComparator, 1);
+    bool inserted;
+
+    const int numGroups = 10000;
+    for (int i = 0; i < numGroups; ++i) {
+        ASSERT_EQ(size_t(i), findOrInsert(&table, Value(i), &inserted));
+        ASSERT_TRUE(inserted);
+    }
+    for (int i = 0; i < numGroups; ++i) {
+        ASSERT_EQ(size_t(i), findOrInsert(&table, Value(i), &inserted));
+        ASSERT_FALSE(inserted);
+    }
+    ASSERT_EQ(size_t(numGroups), table.size());
+}
+
+TEST(GroupHashTableTest, ClearRemovesEveryGroup) {
+    GroupHashTable table(defaultComparator, 1);
+    bool inserted;
+
+    findOrInsert(&table, Value(1), &inserted);
+    findOrInsert(&table, Value(2), &inserted);
+    table.clear();
+    ASSERT_TRUE(table.empty());
+
+    ASSERT_EQ(0U, findOrInsert(&table, Value(2), &inserted));
+    ASSERT_TRUE(inserted);
+}
+
+}  // namespace
+}  // namespace mongo
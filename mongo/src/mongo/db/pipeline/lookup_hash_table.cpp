@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+#include "mongo/db/pipeline/document_path_support.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/stringutils.h"
+
+namespace mongo {
+
+LookUpHashTable::LookUpHashTable(FieldPath foreignField,
+                                 const ValueComparator& comparator,
+                                 size_t maxSizeBytes)
+    : _foreignField(std::move(foreignField)),
+      _maxSizeBytes(maxSizeBytes),
+      _index(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool LookUpHashTable::canHashOnPath(const FieldPath& foreignField) {
+    // The first component is always treated as a field name.
+    for (size_t i = 1; i < foreignField.getPathLength(); ++i) {
+        if (parseUnsignedBase10Integer(foreignField.getFieldName(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LookUpHashTable::canProbe(const Value& localValue) {
+    switch (localValue.getType()) {
+        case EOO:
+        case jstNULL:
+        case Undefined:
+        case RegEx:
+        case Array:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool LookUpHashTable::insert(Document foreignDoc) {
+    const size_t position = _documents.size();
+    _sizeBytes += foreignDoc.getApproximateSize();
+
+    // An equality predicate on a path matches a document if any of the values along that path
+    // match, with arrays at the end of the path contributing each of their elements.
+    document_path_support::visitAllValuesAtPath(
+        foreignDoc, _foreignField, [this, position](const Value& key) {
+            auto& positions = _index[key];
+            if (positions.empty() || positions.back() != position) {
+                positions.push_back(position);
+                _sizeBytes += key.getApproximateSize() + sizeof(size_t);
+            }
+        });
+
+    _documents.push_back(std::move(foreignDoc));
+    return _sizeBytes <= _maxSizeBytes;
+}
+
+std::vector<Document> LookUpHashTable::probe(const std::vector<Value>& localValues) const {
+    std::vector<size_t> positions;
+    for (auto&& localValue : localValues) {
+        invariant(canProbe(localValue));
+        auto it = _index.find(localValue);
+        if (it != _index.end()) {
+            positions.insert(positions.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    if (localValues.size() > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    std::vector<Document> matches;
+    matches.reserve(positions.size());
+    for (auto position : positions) {
+        matches.push_back(_documents[position]);
+    }
+    return matches;
+}
+
+}  // namespace mongo
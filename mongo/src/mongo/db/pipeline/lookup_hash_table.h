@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * An in-memory hash table over the documents of a $lookup's foreign collection, keyed on the
+ * values found at the 'foreignField' path. Lets a localField/foreignField $lookup read the foreign
+ * collection once and then answer each local document with a probe, rather than running a
+ * sub-query per local document.
+ *
+ * A probe returns the same documents as the equality query built by
+ * DocumentSourceLookUp::makeMatchStageFromInput() would, in the order they were inserted. Local
+ * values whose query semantics differ from plain equality (see canProbe()) must be looked up with
+ * a sub-query instead.
+ */
+class LookUpHashTable {
+public:
+    /**
+     * The table hashes and compares keys using 'comparator', which must outlive it. Once the
+     * approximate size of the table exceeds 'maxSizeBytes', insert() fails.
+     */
+    LookUpHashTable(FieldPath foreignField,
+                    const ValueComparator& comparator,
+                    size_t maxSizeBytes);
+
+    /**
+     * Returns true if a table keyed on 'foreignField' can reproduce the matching semantics of the
+     * query language for that path. Paths with numeric components, which may address array
+     * positions, cannot be.
+     */
+    static bool canHashOnPath(const FieldPath& foreignField);
+
+    /**
+     * Returns true if foreign documents matching 'localValue' can be found by a probe. This is not
+     * the case for null and undefined, which also match missing fields, for regular expressions,
+     * and for arrays.
+     */
+    static bool canProbe(const Value& localValue);
+
+    /**
+     * Adds a document from the foreign collection. Returns false, leaving the table in a
+     * consistent but incomplete state, if this takes the table over its size limit.
+     */
+    bool insert(Document foreignDoc);
+
+    /**
+     * Returns every inserted document with a value at 'foreignField' equal to one of
+     * 'localValues', each once, in insertion order. Every element of 'localValues' must satisfy
+     * canProbe().
+     */
+    std::vector<Document> probe(const std::vector<Value>& localValues) const;
+
+    size_t sizeBytes() const {
+        return _sizeBytes;
+    }
+
+    size_t numDocuments() const {
+        return _documents.size();
+    }
+
+private:
+    const FieldPath _foreignField;
+    const size_t _maxSizeBytes;
+
+    // The foreign documents in insertion order, and for each key the positions in '_documents' of
+    // the documents having that key. Each list of positions is sorted and free of duplicates.
+    std::vector<Document> _documents;
+    ValueUnorderedMap<std::vector<size_t>> _index;
+
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator defaultComparator{nullptr};
+const size_t kNoSizeLimit = std::numeric_limits<size_t>::max();
+
+TEST(LookUpHashTableTest, ProbeReturnsMatchesInInsertionOrderWithoutDuplicates) {
+    LookUpHashTable table(FieldPath("a"), defaultComparator, kNoSizeLimit);
+    ASSERT_TRUE(table.insert(Document{{"_id", 0}, {"a", 2}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 1}, {"a", 1}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 2}, {"a", std::vector<Value>{Value(1), Value(2)}}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 3}, {"a", 3}}));
+
+    auto matches = table.probe({Value(2), Value(1)});
+    ASSERT_EQ(3U, matches.size());
+    ASSERT_VALUE_EQ(Value(0), matches[0]["_id"]);
+    ASSERT_VALUE_EQ(Value(1), matches[1]["_id"]);
+    ASSERT_VALUE_EQ(Value(2), matches[2]["_id"]);
+
+    ASSERT_EQ(0U, table.probe({Value(4)}).size());
+}
+
+TEST(LookUpHashTableTest, NumericTypesCompareByValue) {
+    LookUpHashTable table(FieldPath("a"), defaultComparator, kNoSizeLimit);
+    ASSERT_TRUE(table.insert(Document{{"a", 1.0}}));
+    ASSERT_TRUE(table.insert(Document{{"a", 1LL}}));
+
+    ASSERT_EQ(2U, table.probe({Value(1)}).size());
+}
+
+TEST(LookUpHashTableTest, FindsValuesInArraysAlongPath) {
+    LookUpHashTable table(FieldPath("a.b"), defaultComparator, kNoSizeLimit);
+    ASSERT_TRUE(table.insert(Document{
+        {"a",
+         std::vector<Value>{Value(Document{{"b", 1}}),
+                            Value(Document{{"b", std::vector<Value>{Value(2), Value(3)}}})}}}));
+
+    ASSERT_EQ(1U, table.probe({Value(1)}).size());
+    ASSERT_EQ(1U, table.probe({Value(2)}).size());
+    ASSERT_EQ(1U, table.probe({Value(3)}).size());
+}
+
+TEST(LookUpHashTableTest, RespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    ValueComparator comparator(&collator);
+    LookUpHashTable table(FieldPath("a"), comparator, kNoSizeLimit);
+    ASSERT_TRUE(table.insert(Document{{"a", "foo"_sd}}));
+
+    ASSERT_EQ(1U, table.probe({Value("bar"_sd)}).size());
+}
+
+TEST(LookUpHashTableTest, InsertFailsOnceOverSizeLimit) {
+    LookUpHashTable table(FieldPath("a"), defaultComparator, 100);
+    bool inserted = true;
+    for (int i = 0; i < 100 && inserted; ++i) {
+        inserted = table.insert(Document{{"a", i}});
+    }
+    ASSERT_FALSE(inserted);
+    ASSERT_GT(table.sizeBytes(), 100U);
+}
+
+TEST(LookUpHashTableTest, CannotHashOnPathWithNumericComponent) {
+    ASSERT_TRUE(LookUpHashTable::canHashOnPath(FieldPath("a.b")));
+    ASSERT_TRUE(LookUpHashTable::canHashOnPath(FieldPath("0.a")));
+    ASSERT_FALSE(LookUpHashTable::canHashOnPath(FieldPath("a.0")));
+    ASSERT_FALSE(LookUpHashTable::canHashOnPath(FieldPath("a.1.b")));
+}
+
+TEST(LookUpHashTableTest, CannotProbeValuesWithNonEqualitySemantics) {
+    ASSERT_TRUE(LookUpHashTable::canProbe(Value(1)));
+    ASSERT_TRUE(LookUpHashTable::canProbe(Value("a"_sd)));
+    ASSERT_TRUE(LookUpHashTable::canProbe(Value(Document{{"x", 1}})));
+    ASSERT_FALSE(LookUpHashTable::canProbe(Value()));
+    ASSERT_FALSE(LookUpHashTable::canProbe(Value(BSONNULL)));
+    ASSERT_FALSE(LookUpHashTable::canProbe(Value(BSONUndefined)));
+    ASSERT_FALSE(LookUpHashTable::canProbe(Value(BSONRegEx("^a"))));
+    ASSERT_FALSE(LookUpHashTable::canProbe(Value(std::vector<Value>{Value(1)})));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,11 +35,13 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/background.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_create.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -52,6 +54,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/op_observer.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
@@ -66,6 +69,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
@@ -163,6 +167,79 @@ public:
         return infos.empty() ? BSONObj() : infos.front().getObjectField("options").getOwned();
     }
 
+    std::list<BSONObj> getIndexSpecs(const NamespaceString& nss) final {
+        return _client.getIndexSpecs(nss.ns());
+    }
+
+    Status createIndexes(const NamespaceString& nss, const std::vector<BSONObj>& specs) final {
+        auto opCtx = _ctx->opCtx;
+        Lock::DBLock dbLock(opCtx, nss.db(), MODE_X);
+        Status status = _checkCanBuildIndexes(nss);
+        if (!status.isOK()) {
+            return status;
+        }
+        Collection* collection = dbHolder().get(opCtx, nss.db())->getCollection(opCtx, nss);
+
+        // The build is not allowed to run in the background, so the keys are sorted and loaded
+        // into each index in bulk whatever the specs say. The specs themselves are kept as given.
+        MultiIndexBlock indexer(opCtx, collection);
+        indexer.allowInterruption();
+
+        std::vector<BSONObj> indexInfoObjs;
+        try {
+            indexInfoObjs = writeConflictRetry(opCtx, "$out", nss.ns(), [&indexer, &specs] {
+                return uassertStatusOK(indexer.init(specs));
+            });
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+
+        // Only the catalog changes need the database to be locked exclusively. While the
+        // collection is scanned, other collections of the database remain readable and writable.
+        // Registering the build as a background operation makes drops and renames of the
+        // collection and its database fail instead of freeing what 'indexer' points to while the
+        // exclusive lock is released. It must end before 'indexer' is destroyed, which happens
+        // under the exclusive lock again.
+        BackgroundOperation backgroundOp(nss.ns());
+        opCtx->recoveryUnit()->abandonSnapshot();
+        dbLock.relockWithMode(MODE_IX);
+        try {
+            Lock::CollectionLock collLock(opCtx->lockState(), nss.ns(), MODE_X);
+            status = _checkCollectionUnchanged(nss, collection);
+            if (status.isOK()) {
+                status = indexer.insertAllDocumentsInCollection();
+            }
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        // Abandoning the build in the destructor of 'indexer' needs the exclusive lock too.
+        opCtx->recoveryUnit()->abandonSnapshot();
+        dbLock.relockWithMode(MODE_X);
+        if (!status.isOK()) {
+            return status;
+        }
+        status = _checkCollectionUnchanged(nss, collection);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        try {
+            writeConflictRetry(opCtx, "$out", nss.ns(), [&] {
+                WriteUnitOfWork wunit(opCtx);
+                indexer.commit();
+                for (auto&& infoObj : indexInfoObjs) {
+                    getGlobalServiceContext()->getOpObserver()->onCreateIndex(
+                        opCtx, nss, collection->uuid(), infoObj, false);
+                }
+                wunit.commit();
+            });
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    }
+
     Status renameIfOptionsAndIndexesHaveNotChanged(
         const BSONObj& renameCommandObj,
         const NamespaceString& targetNs,
@@ -415,6 +492,42 @@ public:
     }
 
 private:
+    /**
+     * Checks that the collection given by 'nss' exists and that this node can accept writes to
+     * it. The database of 'nss' must be locked exclusively.
+     */
+    Status _checkCanBuildIndexes(const NamespaceString& nss) {
+        auto opCtx = _ctx->opCtx;
+        if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx, nss)) {
+            return {ErrorCodes::NotMaster,
+                    str::stream() << "Not primary while creating indexes in " << nss.ns()};
+        }
+        Database* db = dbHolder().get(opCtx, nss.db());
+        if (!db || !db->getCollection(opCtx, nss)) {
+            return {ErrorCodes::NamespaceNotFound,
+                    str::stream() << "collection " << nss.ns() << " does not exist"};
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Checks, after the database lock was released and taken again during an index build on
+     * 'nss', that the node is still primary and that 'collection' is still the one the build
+     * started on.
+     */
+    Status _checkCollectionUnchanged(const NamespaceString& nss, const Collection* collection) {
+        Status status = _checkCanBuildIndexes(nss);
+        if (!status.isOK()) {
+            return status;
+        }
+        auto opCtx = _ctx->opCtx;
+        if (dbHolder().get(opCtx, nss.db())->getCollection(opCtx, nss) != collection) {
+            return {ErrorCodes::NamespaceNotFound,
+                    str::stream() << "collection " << nss.ns() << " dropped during index build"};
+        }
+        return Status::OK();
+    }
+
     /**
      * Looks up the collection default collator for the collection given by 'collectionUUID'. A
      * collection's default collation is not allowed to change, so we cache the result to allow for
@@ -574,6 +687,25 @@ BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     }
     return projectionObj.removeField(Document::metaFieldSortKey);
 }
+
+/**
+ * Returns true if the documents of a pipeline with dependencies 'deps' and no metadata projection
+ * should be converted from BSON lazily. Each lookup by name in a lazily converted Document scans
+ * the BSON, so this is only worth it if the pipeline needs whole documents but names few top-level
+ * fields. Stages whose dependencies are unknown may look up more.
+ */
+bool shouldConvertLazily(const DepsTracker& deps) {
+    const size_t kMaxTopLevelFields = 8;
+    if (!deps.needWholeDocument || deps.getNeedTextScore() || deps.getNeedSortKey()) {
+        return false;
+    }
+
+    std::set<StringData> topLevelFields;
+    for (auto&& field : deps.fields) {
+        topLevelFields.insert(StringData(field).substr(0, field.find('.')));
+    }
+    return topLevelFields.size() <= kMaxTopLevelFields;
+}
 }  // namespace
 
 void PipelineD::injectMongodInterface(Pipeline* pipeline) {
@@ -897,6 +1029,9 @@ void PipelineD::addCursorSource(Collection* collection,
         }
 
         pSource->setProjection(deps.toProjection(), deps.toParsedDeps());
+        if (shouldConvertLazily(deps)) {
+            pSource->shouldConvertLazily();
+        }
     }
     pipeline->addInitialSource(pSource);
 }
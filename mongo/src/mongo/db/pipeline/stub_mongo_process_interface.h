@@ -84,6 +84,14 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::list<BSONObj> getIndexSpecs(const NamespaceString& nss) override {
+        MONGO_UNREACHABLE;
+    }
+
+    Status createIndexes(const NamespaceString& nss, const std::vector<BSONObj>& specs) override {
+        MONGO_UNREACHABLE;
+    }
+
     Status renameIfOptionsAndIndexesHaveNotChanged(
         const BSONObj& renameCommandObj,
         const NamespaceString& targetNs,
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Statistics about the contents of a single collection, used by the query planner to estimate the
+ * cost of candidate plans. Owned by the collection's CollectionInfoCache.
+ *
+ * The statistics are a random sample of the collection's documents along with, computed on demand,
+ * the keys those documents generate for each index. They are kept in memory only, and are rebuilt
+ * when the collection has grown or shrunk enough, or when its indexes change. A new sample is
+ * gathered a few documents at a time by the queries being planned, so that no single query pays
+ * for all of it.
+ *
+ * All methods are thread-safe. The samples handed out are immutable, so callers can keep using one
+ * after it has been replaced.
+ */
+class CollectionStatistics {
+public:
+    struct Sample {
+        // The number of records in the collection when it was sampled.
+        long long numRecords = 0;
+
+        // The sampled documents, owned.
+        std::vector<BSONObj> docs;
+    };
+
+    /**
+     * Returns the current sample, or nullptr if there is none.
+     */
+    std::shared_ptr<const Sample> getSample() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _sample;
+    }
+
+    /**
+     * Replaces the current sample, forgetting the index keys computed from the old one.
+     */
+    void setSample(std::shared_ptr<const Sample> sample) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sample = std::move(sample);
+        _indexKeys.clear();
+    }
+
+    /**
+     * Adds 'docs' to the sample being gathered. Once that holds 'sampleSize' documents, it becomes
+     * the current sample, as by setSample(), and is returned; until then returns nullptr.
+     * 'numRecords' is the number of records the collection now has.
+     */
+    std::shared_ptr<const Sample> addToPendingSample(std::vector<BSONObj> docs,
+                                                     long long numRecords,
+                                                     size_t sampleSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_pendingSample) {
+            _pendingSample = std::make_shared<Sample>();
+            _pendingSample->docs.reserve(sampleSize);
+        }
+        for (auto&& doc : docs) {
+            if (_pendingSample->docs.size() == sampleSize) {
+                break;
+            }
+            _pendingSample->docs.push_back(std::move(doc));
+        }
+        if (_pendingSample->docs.size() < sampleSize) {
+            return nullptr;
+        }
+
+        _pendingSample->numRecords = numRecords;
+        _sample = std::move(_pendingSample);
+        _pendingSample.reset();
+        _indexKeys.clear();
+        return _sample;
+    }
+
+    /**
+     * Returns the keys the documents of 'sample' generate for the index named 'indexName', or
+     * nullptr if they haven't been computed, or 'sample' is no longer the current sample.
+     */
+    std::shared_ptr<const std::vector<BSONObj>> getIndexKeys(const Sample* sample,
+                                                             StringData indexName) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (sample != _sample.get()) {
+            return nullptr;
+        }
+        auto it = _indexKeys.find(indexName);
+        return it == _indexKeys.end() ? nullptr : it->second;
+    }
+
+    /**
+     * Remembers the keys the documents of 'sample' generate for the index named 'indexName'. Does
+     * nothing if 'sample' is no longer the current sample.
+     */
+    void setIndexKeys(const Sample* sample,
+                      StringData indexName,
+                      std::shared_ptr<const std::vector<BSONObj>> keys) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (sample == _sample.get()) {
+            _indexKeys[indexName] = std::move(keys);
+        }
+    }
+
+    /**
+     * Forgets everything. Must be called whenever the indexes of the collection change.
+     */
+    void clear() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sample.reset();
+        _pendingSample.reset();
+        _indexKeys.clear();
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    std::shared_ptr<const Sample> _sample;
+    std::shared_ptr<Sample> _pendingSample;
+    StringMap<std::shared_ptr<const std::vector<BSONObj>>> _indexKeys;
+};
+
+}  // namespace mongo
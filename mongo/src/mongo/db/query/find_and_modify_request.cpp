@@ -49,6 +49,7 @@ const char kNewField[] = "new";
 const char kFieldProjectionField[] = "fields";
 const char kUpsertField[] = "upsert";
 const char kWriteConcernField[] = "writeConcern";
+const char kAllowDiskUseField[] = "allowDiskUse";
 
 const std::vector<BSONObj> emptyArrayFilters{};
 }  // unnamed namespace
@@ -111,6 +112,10 @@ BSONObj FindAndModifyRequest::toBSON() const {
         builder.append(kNewField, _shouldReturnNew.get());
     }
 
+    if (_allowDiskUse) {
+        builder.append(kAllowDiskUseField, _allowDiskUse.get());
+    }
+
     if (_writeConcern) {
         builder.append(kWriteConcernField, _writeConcern->toBSON());
     }
@@ -165,6 +170,15 @@ StatusWith<FindAndModifyRequest> FindAndModifyRequest::parseFromBSON(NamespaceSt
     bool isRemove = cmdObj[kRemoveField].trueValue();
     bool isUpdate = cmdObj.hasField(kUpdateField);
 
+    bool allowDiskUse = false;
+    {
+        Status allowDiskUseStatus =
+            bsonExtractBooleanFieldWithDefault(cmdObj, kAllowDiskUseField, false, &allowDiskUse);
+        if (!allowDiskUseStatus.isOK()) {
+            return allowDiskUseStatus;
+        }
+    }
+
     if (!isRemove && !isUpdate) {
         return {ErrorCodes::FailedToParse, "Either an update or remove=true must be specified"};
     }
@@ -195,6 +209,9 @@ StatusWith<FindAndModifyRequest> FindAndModifyRequest::parseFromBSON(NamespaceSt
     request.setSort(sort);
     request.setCollation(collation);
     request.setArrayFilters(std::move(arrayFilters));
+    if (allowDiskUse) {
+        request.setAllowDiskUse(allowDiskUse);
+    }
 
     if (!isRemove) {
         request.setShouldReturnNew(shouldReturnNew);
@@ -223,6 +240,10 @@ void FindAndModifyRequest::setArrayFilters(const std::vector<BSONObj>& arrayFilt
     }
 }
 
+void FindAndModifyRequest::setAllowDiskUse(bool allowDiskUse) {
+    _allowDiskUse = allowDiskUse;
+}
+
 void FindAndModifyRequest::setShouldReturnNew(bool shouldReturnNew) {
     dassert(!_isRemove);
     _shouldReturnNew = shouldReturnNew;
@@ -279,4 +300,9 @@ bool FindAndModifyRequest::isUpsert() const {
 bool FindAndModifyRequest::isRemove() const {
     return _isRemove;
 }
+
+bool FindAndModifyRequest::allowDiskUse() const {
+    return _allowDiskUse.value_or(false);
+}
+
 }
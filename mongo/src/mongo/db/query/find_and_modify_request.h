@@ -76,7 +76,8 @@ public:
      *   update: <document>,
      *   new: <boolean>,
      *   fields: <document>,
-     *   upsert: <boolean>
+     *   upsert: <boolean>,
+     *   allowDiskUse: <boolean>
      * }
      *
      * Note: does not parse the writeConcern field or the findAndModify field.
@@ -100,6 +101,7 @@ public:
     bool shouldReturnNew() const;
     bool isUpsert() const;
     bool isRemove() const;
+    bool allowDiskUse() const;
 
     // Not implemented. Use extractWriteConcern() to get the setting instead.
     WriteConcernOptions getWriteConcern() const;
@@ -143,6 +145,11 @@ public:
      */
     void setArrayFilters(const std::vector<BSONObj>& arrayFilters);
 
+    /**
+     * Allows a blocking sort used to pick the document to modify to spill to disk.
+     */
+    void setAllowDiskUse(bool allowDiskUse);
+
     /**
      * Sets the write concern for this request.
      */
@@ -167,6 +174,7 @@ private:
     boost::optional<BSONObj> _collation;
     boost::optional<std::vector<BSONObj>> _arrayFilters;
     boost::optional<bool> _shouldReturnNew;
+    boost::optional<bool> _allowDiskUse;
     boost::optional<WriteConcernOptions> _writeConcern;
 
     // Flag used internally to differentiate whether this is an update or remove type request.
@@ -509,6 +509,30 @@ TEST(FindAndModifyRequest, ParseWithRemoveAndArrayFilters) {
     ASSERT_NOT_OK(parseStatus.getStatus());
 }
 
+TEST(FindAndModifyRequest, ParseWithAllowDiskUse) {
+    BSONObj cmdObj(fromjson(R"json({
+            query: { x: 1 },
+            update: { y: 1 },
+            sort: { z: -1 },
+            allowDiskUse: true
+        })json"));
+
+    auto parseStatus = FindAndModifyRequest::parseFromBSON(NamespaceString("a.b"), cmdObj);
+    ASSERT_OK(parseStatus.getStatus());
+    ASSERT_TRUE(parseStatus.getValue().allowDiskUse());
+}
+
+TEST(FindAndModifyRequest, ParseWithAllowDiskUseTypeMismatch) {
+    BSONObj cmdObj(fromjson(R"json({
+            query: { x: 1 },
+            update: { y: 1 },
+            allowDiskUse: 'yes'
+        })json"));
+
+    auto parseStatus = FindAndModifyRequest::parseFromBSON(NamespaceString("a.b"), cmdObj);
+    ASSERT_NOT_OK(parseStatus.getStatus());
+}
+
 TEST(FindAndModifyRequest, ParseWithCollationTypeMismatch) {
     BSONObj cmdObj(fromjson(R"json({
             query: { x: 1 },
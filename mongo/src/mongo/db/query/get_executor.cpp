@@ -64,6 +64,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_estimator.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -378,7 +379,22 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         unique_ptr<CachedSolution> cs(rawCS);
         QuerySolution* qs;
 		//plan cacheлȡQuerySolution
-        Status status = QueryPlanner::planFromCache(*canonicalQuery, plannerParams, *cs, &qs);
+        // Once the cached plan has been parameterized, queries of this shape skip the planner and
+        // just substitute their values into its index bounds.
+        Status status = Status::OK();
+        auto parameterized = cs->parameterizedSolution->get();
+        std::unique_ptr<QuerySolution> instantiated =
+            parameterized ? parameterized->instantiate(*canonicalQuery, plannerParams.options)
+                          : nullptr;
+        if (instantiated) {
+            qs = instantiated.release();
+        } else {
+            status = QueryPlanner::planFromCache(*canonicalQuery, plannerParams, *cs, &qs);
+            if (status.isOK() && !cs->parameterizedSolution->isSet()) {
+                cs->parameterizedSolution->set(
+                    ParameterizedSolution::make(*canonicalQuery, plannerParams.options, *qs));
+            }
+        }
 
         if (status.isOK()) {
             if ((plannerParams.options & QueryPlannerParams::IS_COUNT) && turnIxscanIntoCount(qs)) {
@@ -461,6 +477,10 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // Don't spend a trial on candidates that the collection's statistics show to be far worse
+    // than another.
+    PlanCostEstimator::pruneSolutions(opCtx, collection, *canonicalQuery, &solutions);
+
     if (1 == solutions.size()) { //ֻһplan
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
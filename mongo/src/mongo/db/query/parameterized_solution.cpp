@@ -0,0 +1,267 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parameterized_solution.h"
+
+#include <set>
+
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true for the predicates whose bounds have the same structure whatever their value.
+ */
+bool isParameterizableLeaf(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Fills 'leaves' with the predicates of 'root', in order. Returns false unless 'root' is a single
+ * parameterizable predicate or a conjunction of them on distinct paths.
+ */
+bool getLeaves(const MatchExpression* root, std::vector<const MatchExpression*>* leaves) {
+    if (root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            leaves->push_back(root->getChild(i));
+        }
+    } else {
+        leaves->push_back(root);
+    }
+
+    std::set<StringData> paths;
+    for (auto&& leaf : *leaves) {
+        if (!isParameterizableLeaf(leaf) || !paths.insert(leaf->path()).second) {
+            return false;
+        }
+    }
+    return !leaves->empty();
+}
+
+/**
+ * Returns true if none of the options of 'query' that change its solution without being part of
+ * its plan cache key are set.
+ */
+bool hasOnlyCacheKeyOptions(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    return !qr.getSkip() && !qr.getLimit() && !qr.getNToReturn() && qr.getMaxScan() == 0 &&
+        !qr.returnKey();
+}
+
+/**
+ * Returns the index scan in the tree rooted at 'node', or nullptr unless the tree is a single
+ * unfiltered index scan under any fetch, projection and shard filter.
+ */
+IndexScanNode* findIndexScan(QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_IXSCAN: {
+            auto ixscan = static_cast<IndexScanNode*>(node);
+            if (ixscan->filter || ixscan->bounds.isSimpleRange || ixscan->maxScan ||
+                ixscan->addKeyMetadata) {
+                return nullptr;
+            }
+            return ixscan;
+        }
+        case STAGE_FETCH:
+            if (node->filter) {
+                return nullptr;
+            }
+            break;
+        case STAGE_PROJECTION:
+        case STAGE_SHARDING_FILTER:
+            break;
+        default:
+            return nullptr;
+    }
+
+    if (node->children.size() != 1) {
+        return nullptr;
+    }
+    return findIndexScan(node->children[0]);
+}
+
+/**
+ * Points the nodes of the tree rooted at 'node' which refer to a query at 'query'.
+ */
+void bindToQuery(QuerySolutionNode* node, const CanonicalQuery& query) {
+    if (node->getType() == STAGE_IXSCAN) {
+        static_cast<IndexScanNode*>(node)->queryCollator = query.getCollator();
+    } else if (node->getType() == STAGE_PROJECTION) {
+        auto projection = static_cast<ProjectionNode*>(node);
+        if (projection->fullExpression) {
+            projection->fullExpression = query.root();
+        }
+    }
+
+    for (auto&& child : node->children) {
+        bindToQuery(child, query);
+    }
+}
+
+/**
+ * Fills 'bounds' for a scan of 'index' in 'direction', taking the bounds of the i-th field of the
+ * index from the predicate at 'leaves[leafForField[i]]'. Returns false if a predicate is not on
+ * its field, or can't be answered exactly by the index.
+ */
+bool buildBounds(const IndexEntry& index,
+                 int direction,
+                 const std::vector<const MatchExpression*>& leaves,
+                 const std::vector<int>& leafForField,
+                 IndexBounds* bounds) {
+    bounds->fields.resize(leafForField.size());
+
+    BSONObjIterator it(index.keyPattern);
+    for (size_t i = 0; i < leafForField.size(); ++i) {
+        BSONElement elt = it.next();
+        OrderedIntervalList* oil = &bounds->fields[i];
+        if (leafForField[i] < 0) {
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+            continue;
+        }
+
+        const MatchExpression* leaf = leaves[leafForField[i]];
+        if (leaf->path() != elt.fieldNameStringData()) {
+            return false;
+        }
+
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(leaf, elt, index, oil, &tightness);
+        if (tightness != IndexBoundsBuilder::EXACT) {
+            return false;
+        }
+    }
+
+    IndexBoundsBuilder::alignBounds(bounds, index.keyPattern, direction);
+    return true;
+}
+
+}  // namespace
+
+std::unique_ptr<ParameterizedSolution> ParameterizedSolution::make(const CanonicalQuery& query,
+                                                                   size_t plannerOptions,
+                                                                   const QuerySolution& solution) {
+    if (!solution.root || !hasOnlyCacheKeyOptions(query)) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> leaves;
+    if (!getLeaves(query.root(), &leaves)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> root(solution.root->clone());
+    IndexScanNode* ixscan = findIndexScan(root.get());
+    if (!ixscan) {
+        return nullptr;
+    }
+
+    // Every predicate must be answered by the bounds of the index field on its path.
+    std::vector<int> leafForField;
+    size_t numBoundFields = 0;
+    for (auto&& elt : ixscan->index.keyPattern) {
+        int leafIndex = -1;
+        for (size_t i = 0; i < leaves.size(); ++i) {
+            if (leaves[i]->path() == elt.fieldNameStringData()) {
+                leafIndex = i;
+                ++numBoundFields;
+                break;
+            }
+        }
+        leafForField.push_back(leafIndex);
+    }
+    if (numBoundFields != leaves.size()) {
+        return nullptr;
+    }
+
+    // Only parameterize if substituting the values of this query gives back the bounds the
+    // planner chose, so that doing the same for other queries gives what it would have chosen.
+    IndexBounds bounds;
+    if (!buildBounds(ixscan->index, ixscan->direction, leaves, leafForField, &bounds) ||
+        bounds != ixscan->bounds) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ParameterizedSolution> parameterized(new ParameterizedSolution());
+    parameterized->_root = std::move(root);
+    parameterized->_indexFilterApplied = solution.indexFilterApplied;
+    parameterized->_plannerOptions = plannerOptions;
+    parameterized->_proj = query.getQueryRequest().getProj().getOwned();
+    parameterized->_leafForField = std::move(leafForField);
+    parameterized->_numLeaves = leaves.size();
+    return parameterized;
+}
+
+ParameterizedSolution::~ParameterizedSolution() = default;
+
+std::unique_ptr<QuerySolution> ParameterizedSolution::instantiate(const CanonicalQuery& query,
+                                                                  size_t plannerOptions) const {
+    if (plannerOptions != _plannerOptions || !hasOnlyCacheKeyOptions(query) ||
+        !query.getQueryRequest().getProj().binaryEqual(_proj)) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> leaves;
+    if (!getLeaves(query.root(), &leaves) || leaves.size() != _numLeaves) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> root(_root->clone());
+    IndexScanNode* ixscan = findIndexScan(root.get());
+    invariant(ixscan);
+
+    IndexBounds bounds;
+    if (!buildBounds(ixscan->index, ixscan->direction, leaves, _leafForField, &bounds)) {
+        return nullptr;
+    }
+    ixscan->bounds = std::move(bounds);
+    bindToQuery(root.get(), query);
+
+    auto solution = stdx::make_unique<QuerySolution>();
+    solution->root = std::move(root);
+    solution->indexFilterApplied = _indexFilterApplied;
+    return solution;
+}
+
+}  // namespace mongo
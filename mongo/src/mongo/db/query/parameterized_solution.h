@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+struct QuerySolution;
+struct QuerySolutionNode;
+
+/**
+ * A query solution taken from the plan cache that can be turned into a solution for any other
+ * query of the same shape by substituting that query's values into its index bounds, without
+ * going through QueryPlanner::planFromCache().
+ *
+ * Only solutions made of a single index scan answering every predicate of the query exactly, under
+ * any fetch, projection and shard filter, are parameterized. The query must be a single comparison
+ * or a conjunction of comparisons on distinct paths, and must have no skip, limit, maxScan or
+ * returnKey, none of which are part of the plan cache key. This covers point lookups and simple
+ * ranges, the queries for which planning is the largest share of the work.
+ */
+class ParameterizedSolution {
+public:
+    /**
+     * Returns a ParameterizedSolution for 'solution', which must be what the planner produced for
+     * 'query' with 'plannerOptions', or nullptr if it can't be parameterized.
+     */
+    static std::unique_ptr<ParameterizedSolution> make(const CanonicalQuery& query,
+                                                       size_t plannerOptions,
+                                                       const QuerySolution& solution);
+
+    ~ParameterizedSolution();
+
+    /**
+     * Returns the solution for 'query', which must have the same plan cache key as the query this
+     * was made from, or nullptr if it has to be planned the usual way. This happens when the
+     * planner options differ, or when the values of 'query' can't be answered exactly by index
+     * bounds, such as equality to null or to an array.
+     */
+    std::unique_ptr<QuerySolution> instantiate(const CanonicalQuery& query,
+                                               size_t plannerOptions) const;
+
+private:
+    ParameterizedSolution() = default;
+
+    std::unique_ptr<QuerySolutionNode> _root;
+    bool _indexFilterApplied = false;
+    size_t _plannerOptions = 0;
+
+    // Projections on $-prefixed fields are left out of the plan cache key, so the projection must
+    // match exactly.
+    BSONObj _proj;
+
+    // For each field of the index, the position among the query's predicates of the one whose
+    // bounds go there, or -1 if the field is unbounded.
+    std::vector<int> _leafForField;
+    size_t _numLeaves = 0;
+};
+
+/**
+ * Where a plan cache entry keeps its ParameterizedSolution, shared with the CachedSolutions handed
+ * out for it. Thread-safe.
+ */
+class ParameterizedSolutionSlot {
+public:
+    /**
+     * Returns the solution, or nullptr if there is none.
+     */
+    std::shared_ptr<const ParameterizedSolution> get() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _solution;
+    }
+
+    /**
+     * Returns true once set() has been called, even with nullptr. Solutions that can't be
+     * parameterized are only tried once.
+     */
+    bool isSet() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _isSet;
+    }
+
+    void set(std::unique_ptr<ParameterizedSolution> solution) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _isSet = true;
+        _solution = std::move(solution);
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    bool _isSet = false;
+    std::shared_ptr<const ParameterizedSolution> _solution;
+};
+
+}  // namespace mongo
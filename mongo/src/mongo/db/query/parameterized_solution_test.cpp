@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parameterized_solution.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class ParameterizedSolutionTest : public QueryPlannerTest {
+protected:
+    void setUp() override {
+        QueryPlannerTest::setUp();
+        params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    }
+
+    /**
+     * Plans 'query', which must have a single solution, and parameterizes that solution.
+     */
+    std::unique_ptr<ParameterizedSolution> parameterize(const BSONObj& query) {
+        runQuery(query);
+        ASSERT_EQ(1U, solns.size());
+        return ParameterizedSolution::make(*cq, params.options, *solns[0]);
+    }
+
+    /**
+     * Asserts that instantiating 'parameterized' for 'query' gives the planner's only solution.
+     */
+    void assertInstantiatesAsPlanned(const ParameterizedSolution& parameterized,
+                                     const BSONObj& query) {
+        runQuery(query);
+        ASSERT_EQ(1U, solns.size());
+        auto instantiated = parameterized.instantiate(*cq, params.options);
+        ASSERT(instantiated);
+        ASSERT_EQ(solns[0]->toString(), instantiated->toString());
+    }
+};
+
+TEST_F(ParameterizedSolutionTest, InstantiatesPointLookup) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    auto parameterized = parameterize(fromjson("{a: 1, b: 2}"));
+    ASSERT(parameterized);
+    assertInstantiatesAsPlanned(*parameterized, fromjson("{a: 5, b: 7}"));
+    assertInstantiatesAsPlanned(*parameterized, fromjson("{a: 'x', b: {c: 1}}"));
+}
+
+TEST_F(ParameterizedSolutionTest, InstantiatesRangeOnDescendingIndex) {
+    addIndex(BSON("a" << 1 << "b" << -1));
+    auto parameterized = parameterize(fromjson("{a: 1, b: {$gt: 2}}"));
+    ASSERT(parameterized);
+    assertInstantiatesAsPlanned(*parameterized, fromjson("{a: 3, b: {$gt: 10}}"));
+}
+
+TEST_F(ParameterizedSolutionTest, InstantiatesPrefixOfCompoundIndex) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    auto parameterized = parameterize(fromjson("{a: {$lte: 4}}"));
+    ASSERT(parameterized);
+    assertInstantiatesAsPlanned(*parameterized, fromjson("{a: {$lte: 9}}"));
+}
+
+TEST_F(ParameterizedSolutionTest, DoesNotParameterizeResidualFilter) {
+    addIndex(BSON("a" << 1));
+    ASSERT_FALSE(parameterize(fromjson("{a: 1, b: 2}")));
+}
+
+TEST_F(ParameterizedSolutionTest, DoesNotParameterizeUnsupportedPredicates) {
+    addIndex(BSON("a" << 1));
+    ASSERT_FALSE(parameterize(fromjson("{a: {$in: [1, 2]}}")));
+    ASSERT_FALSE(parameterize(fromjson("{a: {$gt: 1, $lt: 5}}")));
+}
+
+TEST_F(ParameterizedSolutionTest, DoesNotInstantiateInexactValues) {
+    addIndex(BSON("a" << 1));
+    auto parameterized = parameterize(fromjson("{a: 1}"));
+    ASSERT(parameterized);
+
+    runQuery(fromjson("{a: [1, 2]}"));
+    ASSERT_FALSE(parameterized->instantiate(*cq, params.options));
+}
+
+TEST_F(ParameterizedSolutionTest, DoesNotInstantiateWithOtherOptions) {
+    addIndex(BSON("a" << 1));
+    auto parameterized = parameterize(fromjson("{a: 1}"));
+    ASSERT(parameterized);
+
+    runQuery(fromjson("{a: 2}"));
+    ASSERT_FALSE(parameterized->instantiate(
+        *cq, params.options | QueryPlannerParams::INCLUDE_SHARD_FILTER));
+
+    runQuerySortProjSkipNToReturn(fromjson("{a: 2}"), BSONObj(), BSONObj(), 0, 5);
+    ASSERT_FALSE(parameterized->instantiate(*cq, params.options));
+}
+
+}  // namespace
+}  // namespace mongo
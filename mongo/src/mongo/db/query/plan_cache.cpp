@@ -371,7 +371,8 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
-      decisionWorks(entry.decision->stats[0]->common.works) {
+      decisionWorks(entry.decision->stats[0]->common.works),
+      parameterizedSolution(entry.parameterizedSolution) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
     for (size_t i = 0; i < entry.plannerData.size(); ++i) {
@@ -395,7 +396,9 @@ CachedSolution::~CachedSolution() {
 
 PlanCacheEntry::PlanCacheEntry(const std::vector<QuerySolution*>& solutions,
                                PlanRankingDecision* why)
-    : plannerData(solutions.size()), decision(why) {
+    : plannerData(solutions.size()),
+      decision(why),
+      parameterizedSolution(std::make_shared<ParameterizedSolutionSlot>()) {
     invariant(why);
 
     // The caller of this constructor is responsible for ensuring
@@ -434,6 +437,7 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     entry->projection = projection.getOwned();
     entry->collation = collation.getOwned();
     entry->timeOfCreation = timeOfCreation;
+    entry->parameterizedSolution = parameterizedSolution;
 
     // Copy performance stats.
     for (size_t i = 0; i < feedback.size(); ++i) {
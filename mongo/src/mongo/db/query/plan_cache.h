@@ -35,6 +35,7 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/parameterized_solution.h"
 #include "mongo/db/query/plan_cache_indexability.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/platform/atomic_word.h"
@@ -221,6 +222,9 @@ public:
     // The number of work cycles taken to decide on a winning plan when the plan was first
     // cached.
     size_t decisionWorks;
+
+    // The entry's ParameterizedSolution, if one has been made.
+    std::shared_ptr<ParameterizedSolutionSlot> parameterizedSolution;
 };
 
 /**
@@ -277,6 +281,12 @@ public:
     // the other plans lost.
     std::unique_ptr<PlanRankingDecision> decision;
 
+    // The winning solution, parameterized so that other queries of this shape can use it without
+    // planning. Filled in on the first cache hit from what QueryPlanner::planFromCache() returns.
+    // Shared with the CachedSolutions made from this entry, so that the solution made for a hit
+    // goes to the entry that was hit even if the entry has since been replaced.
+    std::shared_ptr<ParameterizedSolutionSlot> parameterizedSolution;
+
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
@@ -0,0 +1,281 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include <algorithm>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+using Sample = CollectionStatistics::Sample;
+
+/**
+ * Returns the sample of 'collection' to estimate costs from. If there is none, or the collection
+ * has since doubled or halved in size, adds a few random documents to the new sample being
+ * gathered instead, and returns nullptr until that is complete. Also returns nullptr if the
+ * collection can't or shouldn't be sampled.
+ */
+std::shared_ptr<const Sample> getSample(OperationContext* opCtx, Collection* collection) {
+    const long long sampleSize = internalQueryPlannerStatisticsSampleSize.load();
+    const long long numRecords = collection->numRecords(opCtx);
+    if (sampleSize <= 0 || numRecords < sampleSize) {
+        return nullptr;
+    }
+
+    CollectionStatistics* statistics = collection->infoCache()->getStatistics();
+    auto sample = statistics->getSample();
+    if (sample && numRecords <= 2 * sample->numRecords && 2 * numRecords >= sample->numRecords) {
+        return sample;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return nullptr;
+    }
+
+    // Each query only reads a few documents towards the new sample, so that sampling adds a
+    // bounded amount to the time taken to plan it.
+    const long long docsPerQuery =
+        std::min(sampleSize,
+                 static_cast<long long>(internalQueryPlannerStatisticsSampleDocsPerQuery.load()));
+    std::vector<BSONObj> docs;
+    docs.reserve(docsPerQuery);
+    try {
+        while (static_cast<long long>(docs.size()) < docsPerQuery) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            docs.push_back(record->data.toBson().getOwned());
+        }
+    } catch (const WriteConflictException&) {
+        // Costs are only an optimization. Plan this query without them and sample next time.
+        return nullptr;
+    }
+
+    auto newSample = statistics->addToPendingSample(std::move(docs), numRecords, sampleSize);
+    if (newSample) {
+        LOG(2) << "Sampled " << newSample->docs.size() << " documents of " << collection->ns()
+               << " for plan cost estimation";
+    }
+    return newSample;
+}
+
+/**
+ * Estimates the cost of the solution tree rooted at each node passed to estimate().
+ */
+class SolutionCostEstimator {
+public:
+    SolutionCostEstimator(OperationContext* opCtx,
+                          Collection* collection,
+                          std::shared_ptr<const Sample> sample)
+        : _opCtx(opCtx), _collection(collection), _sample(std::move(sample)) {}
+
+    /**
+     * Returns boost::none if the cost of some part of the tree can't be estimated.
+     */
+    boost::optional<double> estimate(const QuerySolutionNode* node) {
+        switch (node->getType()) {
+            case STAGE_COLLSCAN:
+                return static_cast<double>(_sample->numRecords);
+            case STAGE_IXSCAN:
+                return estimateIndexScan(static_cast<const IndexScanNode*>(node));
+            default:
+                break;
+        }
+
+        // Any other leaf is a special kind of scan, such as a text or geo search, that the keys
+        // generated from the sample say nothing about.
+        if (node->children.empty()) {
+            return boost::none;
+        }
+
+        double cost = 0;
+        for (auto&& child : node->children) {
+            auto childCost = estimate(child);
+            if (!childCost) {
+                return boost::none;
+            }
+            cost += *childCost;
+        }
+        return cost;
+    }
+
+private:
+    boost::optional<double> estimateIndexScan(const IndexScanNode* node) {
+        // Partial indexes don't hold the keys of every sampled document, and simple ranges from
+        // min() and max() are rare enough not to bother.
+        if (node->index.filterExpr || node->bounds.isSimpleRange) {
+            return boost::none;
+        }
+
+        auto keys = getIndexKeys(node->index.name);
+        if (!keys) {
+            return boost::none;
+        }
+
+        return PlanCostEstimator::estimateIndexScanKeys(node->bounds,
+                                                        node->index.keyPattern,
+                                                        node->direction,
+                                                        *keys,
+                                                        _sample->docs.size(),
+                                                        _sample->numRecords);
+    }
+
+    std::shared_ptr<const std::vector<BSONObj>> getIndexKeys(const std::string& indexName) {
+        CollectionStatistics* statistics = _collection->infoCache()->getStatistics();
+        if (auto keys = statistics->getIndexKeys(_sample.get(), indexName)) {
+            return keys;
+        }
+
+        // Generating the keys of the whole sample costs about as much as a short query, so each
+        // query generates them for at most one index. The rest are left to later queries.
+        if (_generatedIndexKeys) {
+            return nullptr;
+        }
+        _generatedIndexKeys = true;
+
+        IndexCatalog* indexCatalog = _collection->getIndexCatalog();
+        const IndexDescriptor* desc = indexCatalog->findIndexByName(_opCtx, indexName);
+        if (!desc) {
+            return nullptr;
+        }
+        const IndexAccessMethod* iam = indexCatalog->getIndex(desc);
+
+        auto keys = std::make_shared<std::vector<BSONObj>>();
+        for (auto&& doc : _sample->docs) {
+            BSONObjSet docKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            iam->getKeys(
+                doc, IndexAccessMethod::GetKeysMode::kRelaxConstraints, &docKeys, nullptr);
+            keys->insert(keys->end(), docKeys.begin(), docKeys.end());
+        }
+
+        statistics->setIndexKeys(_sample.get(), indexName, keys);
+        return std::move(keys);
+    }
+
+    OperationContext* _opCtx;
+    Collection* _collection;
+    std::shared_ptr<const Sample> _sample;
+    bool _generatedIndexKeys = false;
+};
+
+}  // namespace
+
+double PlanCostEstimator::estimateIndexScanKeys(const IndexBounds& bounds,
+                                                const BSONObj& keyPattern,
+                                                int direction,
+                                                const std::vector<BSONObj>& sampleKeys,
+                                                size_t numSampledDocs,
+                                                long long numRecords) {
+    IndexBoundsChecker checker(&bounds, keyPattern, direction);
+    size_t keysInBounds = 0;
+    for (auto&& key : sampleKeys) {
+        if (checker.isValidKey(key)) {
+            ++keysInBounds;
+        }
+    }
+
+    // Count one key more than was found, so that an empty scan isn't estimated as free.
+    return (keysInBounds + 1.0) / (numSampledDocs + 1.0) * numRecords;
+}
+
+void PlanCostEstimator::pruneSolutions(OperationContext* opCtx,
+                                       Collection* collection,
+                                       const CanonicalQuery& query,
+                                       std::vector<QuerySolution*>* solutions) {
+    if (!internalQueryPlannerEnableCostBasedPruning.load() || solutions->size() < 2) {
+        return;
+    }
+
+    // Without a sort, every candidate has to examine everything in its bounds to produce the whole
+    // result. With one, a candidate that gets the order from an index can stop early under a
+    // limit, which only a trial reveals.
+    if (!query.getQueryRequest().getSort().isEmpty()) {
+        return;
+    }
+
+    auto sample = getSample(opCtx, collection);
+    if (!sample) {
+        return;
+    }
+
+    SolutionCostEstimator estimator(opCtx, collection, sample);
+    std::vector<double> costs;
+    for (auto&& solution : *solutions) {
+        auto cost = estimator.estimate(solution->root.get());
+        if (!cost) {
+            return;
+        }
+        costs.push_back(*cost);
+    }
+
+    // Keep every candidate estimated within the ratio of the cheapest, and always the cheapest
+    // two. A single candidate would not be multi-planned, so no plan cache entry would be written
+    // and every run of the query would be estimated again.
+    std::vector<double> sortedCosts(costs);
+    std::sort(sortedCosts.begin(), sortedCosts.end());
+    const double cheapest = sortedCosts[0];
+    const double maxCost =
+        std::max(cheapest * internalQueryPlannerPruneCostRatio.load(), sortedCosts[1]);
+
+    std::vector<QuerySolution*> kept;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        QuerySolution* solution = (*solutions)[i];
+        if (costs[i] > maxCost) {
+            LOG(2) << "Pruning candidate plan with estimated cost " << costs[i]
+                   << ", cheapest estimate is " << cheapest << ": " << redact(solution->toString());
+            delete solution;
+        } else {
+            kept.push_back(solution);
+        }
+    }
+    solutions->swap(kept);
+}
+
+}  // namespace mongo
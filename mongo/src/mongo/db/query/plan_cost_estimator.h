@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class Collection;
+class IndexBounds;
+class OperationContext;
+struct QuerySolution;
+
+/**
+ * Estimates the cost of candidate query solutions from the sampled statistics of a collection, so
+ * that candidates which are clearly worse than another can be discarded without running them in a
+ * MultiPlanStage trial.
+ *
+ * The cost of a solution is the number of index keys and documents it is expected to examine.
+ * Index scans are estimated by checking the keys the sampled documents generate for the index
+ * against the scan's bounds; collection scans examine every document.
+ */
+class PlanCostEstimator {
+public:
+    /**
+     * Estimates how many keys a scan over 'bounds' of the index with key pattern 'keyPattern'
+     * examines, given 'sampleKeys', the keys generated by 'numSampledDocs' documents sampled at
+     * random from a collection of 'numRecords' documents. Never returns zero, so that ratios
+     * between estimates stay meaningful when no sampled key is in bounds.
+     */
+    static double estimateIndexScanKeys(const IndexBounds& bounds,
+                                        const BSONObj& keyPattern,
+                                        int direction,
+                                        const std::vector<BSONObj>& sampleKeys,
+                                        size_t numSampledDocs,
+                                        long long numRecords);
+
+    /**
+     * Deletes and removes from 'solutions' every candidate whose estimated cost is more than
+     * internalQueryPlannerPruneCostRatio times that of the cheapest candidate. Samples
+     * 'collection' if its statistics are missing or stale.
+     *
+     * Leaves 'solutions' untouched if pruning is disabled, the query has a sort, the collection is
+     * too small to sample or doesn't support random cursors, or the cost of some candidate can't be
+     * estimated. Also leaves it untouched if fewer than two candidates would survive, so that the
+     * query is still multi-planned and its winning plan cached rather than sampled on every run.
+     */
+    static void pruneSolutions(OperationContext* opCtx,
+                               Collection* collection,
+                               const CanonicalQuery& query,
+                               std::vector<QuerySolution*>* solutions);
+};
+
+}  // namespace mongo
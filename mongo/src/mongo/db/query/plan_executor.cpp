@@ -49,6 +49,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
@@ -412,6 +413,7 @@ void PlanExecutor::reattachToOperationContext(OperationContext* opCtx) {
 void PlanExecutor::invalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) {
     if (!isMarkedAsKilled()) {
         _root->invalidate(opCtx, dl, type);
+        _rootResults.invalidate(_workingSet.get(), dl, type);
     }
 }
 
@@ -618,7 +620,13 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
 
         WorkingSetID id = WorkingSet::INVALID_ID;
 		//PlanStage::work
-        PlanStage::StageState code = _root->work(&id); //PlanStage::work  ִвѯƻ
+        // Results are only read ahead when the caller wants documents. Callers that want
+        // RecordIds usually act on each record before asking for the next one.
+        const int workBatchSize = internalQueryExecWorkBatchSize.load();
+        if (workBatchSize > 1 && NULL == dlOut) {
+            _rootResults.fill(_root.get(), _workingSet.get(), workBatchSize);
+        }
+        PlanStage::StageState code = _rootResults.next(_root.get(), &id); //PlanStage::work  ִвѯƻ
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -708,7 +716,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
 
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() || (_stash.empty() && _rootResults.isEOF(_root.get()));
 }
 
 void PlanExecutor::markAsKilled(string reason) {
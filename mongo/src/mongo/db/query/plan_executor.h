@@ -33,6 +33,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/util/partitioned.h"
+#include "mongo/db/exec/child_result_buffer.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
@@ -577,6 +578,10 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Results read ahead from '_root' when internalQueryExecWorkBatchSize is set. Handed out in
+    // order before any further work is done on the plan.
+    ChildResultBuffer _rootResults;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     // Set if this PlanExecutor is registered with the CursorManager.
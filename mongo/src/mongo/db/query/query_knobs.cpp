@@ -60,12 +60,25 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, tr
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableCostBasedPruning, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerStatisticsSampleSize, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerStatisticsSampleDocsPerQuery, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerPruneCostRatio, double, 10.0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWorkBatchSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelWorkers, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelMinItemsPerWorker, int, 64);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
@@ -76,6 +89,14 @@ MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxBytes,
+                              int,
+                              32 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinIndexedCollectionMaxBytes,
+                              int,
+                              1024 * 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
@@ -92,6 +92,21 @@ extern AtomicBool internalQueryPlanOrChildrenIndependently;
 // during explodeForSort?
 extern AtomicInt32 internalQueryMaxScansToExplode;
 
+// Do we discard candidate plans whose estimated cost is far above the cheapest before
+// multi-planning?
+extern AtomicBool internalQueryPlannerEnableCostBasedPruning;
+
+// How many documents do we sample from a collection to estimate plan costs? Collections with fewer
+// documents are not sampled and their plans are never pruned.
+extern AtomicInt32 internalQueryPlannerStatisticsSampleSize;
+
+// How many documents of a new sample may planning a single query read?
+extern AtomicInt32 internalQueryPlannerStatisticsSampleDocsPerQuery;
+
+// How many times the estimated cost of the cheapest candidate plan must another candidate's be for
+// it to be discarded without a trial?
+extern AtomicDouble internalQueryPlannerPruneCostRatio;
+
 // Allow the planner to generate covered whole index scans, rather than falling back to a COLLSCAN.
 extern AtomicBool internalQueryPlannerGenerateCoveredWholeIndexScans;
 
@@ -111,6 +126,17 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// If greater than 1, PlanExecutor pulls results from the root of the plan this many units of
+// work at a time through PlanStage::workBatch(). Disabled by default.
+extern AtomicInt32 internalQueryExecWorkBatchSize;
+
+// If greater than 1, the most threads, including the one running the query, that a batch of
+// results may be split over to evaluate a collection scan's filter, to build the Documents an
+// aggregation reads from its query, or to pre-aggregate the input of a $group. Each thread is
+// given at least internalQueryExecParallelMinItemsPerWorker results. Disabled by default.
+extern AtomicInt32 internalQueryExecParallelWorkers;
+extern AtomicInt32 internalQueryExecParallelMinItemsPerWorker;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -123,5 +149,14 @@ extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The largest in-memory hash table a localField/foreignField $lookup will build over its foreign
+// collection before falling back to a sub-query per input document. Zero disables hash joins.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxBytes;
+
+// A localField/foreignField $lookup whose foreign collection has an index that can answer the join
+// only builds a hash table if the collection holds at most this many bytes. Larger collections are
+// probed through the index, one sub-query per input document.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinIndexedCollectionMaxBytes;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
 }  // namespace mongo
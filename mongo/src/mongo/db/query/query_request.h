@@ -254,6 +254,14 @@ public:
         _explain = explain;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     const std::string& getComment() const {
         return _comment;
     }
@@ -503,6 +511,10 @@ private:
 
     bool _explain = false;
 
+    // Allows a blocking SORT stage to spill to disk once it exceeds
+    // internalQueryExecMaxBlockingSortBytes, rather than failing the query.
+    bool _allowDiskUse = false;
+
     std::string _comment;
 
     int _maxScan = 0;
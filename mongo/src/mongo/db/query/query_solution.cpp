@@ -873,6 +873,8 @@ QuerySolutionNode* ProjectionNode::clone() const {
     copy->fullExpression = this->fullExpression;
 
     copy->projection = this->projection;
+    copy->projType = this->projType;
+    copy->coveredKeyObj = this->coveredKeyObj;
 
     return copy;
 }
@@ -54,6 +54,12 @@ ServerStatusMetricField<Counter64> displayReadersCreated("repl.network.readersCr
 // Number of seconds for the `maxTimeMS` on the initial `find` command.
 MONGO_EXPORT_SERVER_PARAMETER(oplogInitialFindMaxSeconds, int, 60);
 
+// Name of the network message compressor (e.g. "zlib") the oplog `find` and `getMore` commands ask
+// the sync source to use. The sync source replies with the same compressor, so a compressor with a
+// better ratio than the connection default can be used for oplog traffic alone. Empty (or a name
+// not negotiated on the connection) means the connection's preferred compressor.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(oplogFetcherNetworkCompressor, std::string, "");
+
 // Number of milliseconds to add to the `find` and `getMore` timeouts to calculate the network
 // timeout for the requests.
 const Milliseconds kNetworkTimeoutBufferMS{5000};
@@ -327,7 +333,9 @@ std::unique_ptr<Fetcher> AbstractOplogFetcher::_makeFetcher(const BSONObj& findC
             &AbstractOplogFetcher::_callback, this, stdx::placeholders::_1, stdx::placeholders::_3),
         metadataObj,
         _getFindMaxTime() + kNetworkTimeoutBufferMS,
-        _getGetMoreMaxTime() + kNetworkTimeoutBufferMS);
+        _getGetMoreMaxTime() + kNetworkTimeoutBufferMS,
+        RemoteCommandRetryScheduler::makeNoRetryPolicy(),
+        oplogFetcherNetworkCompressor);
 }
 
 }  // namespace repl
@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/base/string_data.h"
@@ -39,6 +40,7 @@
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/query/killcursors_request.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_parameters.h"
@@ -68,8 +70,33 @@ MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionCountAttempts, int, 3);
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListIndexesAttempts, int, 3);
 // The number of attempts for the find command, which gets the data.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionFindAttempts, int, 3);
+// The number of times the cursors cloning a collection in _id ranges may be resumed.
+MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionCursorResumeAttempts, int, 10);
+
+bool isRetriableError(const Status& status) {
+    const auto& retriableErrors = RemoteCommandRetryScheduler::kAllRetriableErrors;
+    return std::find(retriableErrors.begin(), retriableErrors.end(), status.code()) !=
+        retriableErrors.end();
+}
+
+// Returns {_id: <value of 'id'>}.
+BSONObj makeIdObj(const BSONElement& id) {
+    BSONObjBuilder builder;
+    builder.appendAs(id, "_id");
+    return builder.obj();
+}
+
+int compareIds(const BSONElement& lhs, const BSONObj& rhs) {
+    return lhs.woCompare(rhs.firstElement(), false);
+}
+
+// The number of _ids sampled for each range when splitting a collection into ranges of its _id
+// index.
+const int kIdRangeSamplesPerCursor = 32;
 }  // namespace
 
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncCloneCollectionsInIdRanges, bool, false);
+
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
 // 'namespace' collection.
 MONGO_FP_DECLARE(initialSyncHangBeforeCollectionClone);
@@ -250,6 +277,10 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     if (_establishCollectionCursorsScheduler) {
         _establishCollectionCursorsScheduler->shutdown();
     }
+    for (auto&& scheduler : _idRangeSchedulers) {
+        scheduler->shutdown();
+    }
+    _killIdRangeCursors_inlock();
     _dbWorkTaskRunner.cancel();
 }
 
@@ -462,6 +493,38 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
 
     _collLoader = std::move(collectionBulkLoader.getValue());
 
+    MONGO_FAIL_POINT_BLOCK(initialSyncHangBeforeCollectionClone, options) {
+        const BSONObj& data = options.getData();
+        if (data["namespace"].String() == _destNss.ns()) {
+            log() << "initial sync - initialSyncHangBeforeCollectionClone fail point "
+                     "enabled. Blocking until fail point is disabled.";
+            while (MONGO_FAIL_POINT(initialSyncHangBeforeCollectionClone) && !_isShuttingDown()) {
+                mongo::sleepsecs(1);
+            }
+        }
+    }
+
+    if (initialSyncCloneCollectionsInIdRanges.load() && _canCloneInIdRanges()) {
+        // This completion guard invokes _finishCallback on destruction.
+        auto cancelRemainingWorkInLock = [this]() { _cancelRemainingWork_inlock(); };
+        auto finishCallbackFn = [this](const Status& status) { _finishCallback(status); };
+        auto onCompletionGuard =
+            std::make_shared<OnCompletionGuard>(cancelRemainingWorkInLock, finishCallbackFn);
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _cloneInIdRanges = true;
+        _idRanges.assign(1, IdRange());
+        // Split the collection into ranges holding about the same number of documents, unless
+        // there is nothing to split.
+        Status scheduleStatus = (_maxNumClonerCursors > 1 && _stats.documentToCopy > 1)
+            ? _scheduleIdRangeSplitPointsLookup_inlock(onCompletionGuard)
+            : _scheduleIdRangeCursor_inlock(0, onCompletionGuard);
+        if (!scheduleStatus.isOK()) {
+            onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, scheduleStatus);
+        }
+        return;
+    }
+
     BSONObjBuilder cmdObj;
     EstablishCursorsCommand cursorCommand;
     // The 'find' command is used when the number of cloning cursors is 1 to ensure
@@ -485,17 +548,6 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
     Client::initThreadIfNotAlready();
     auto opCtx = cc().getOperationContext();
 
-    MONGO_FAIL_POINT_BLOCK(initialSyncHangBeforeCollectionClone, options) {
-        const BSONObj& data = options.getData();
-        if (data["namespace"].String() == _destNss.ns()) {
-            log() << "initial sync - initialSyncHangBeforeCollectionClone fail point "
-                     "enabled. Blocking until fail point is disabled.";
-            while (MONGO_FAIL_POINT(initialSyncHangBeforeCollectionClone) && !_isShuttingDown()) {
-                mongo::sleepsecs(1);
-            }
-        }
-    }
-
     _establishCollectionCursorsScheduler = stdx::make_unique<RemoteCommandRetryScheduler>(
         _executor,
         RemoteCommandRequest(_source,
@@ -614,6 +666,25 @@ void CollectionCloner::_establishCollectionCursorsCallback(const RemoteCommandCa
     LOG(1) << "Collection cloner running with " << cursorResponses.size()
            << " cursors established.";
 
+    // This completion guard invokes _finishCallback on destruction.
+    auto cancelRemainingWorkInLock = [this]() { _cancelRemainingWork_inlock(); };
+    auto finishCallbackFn = [this](const Status& status) { _finishCallback(status); };
+    auto onCompletionGuard =
+        std::make_shared<OnCompletionGuard>(cancelRemainingWorkInLock, finishCallbackFn);
+
+    // Lock guard must be declared after completion guard. If there is an error in this function
+    // that will cause the destructor of the completion guard to run, the destructor must be run
+    // outside the mutex. This is a necessary condition to invoke _finishCallback.
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    Status scheduleStatus = _startArm_inlock(std::move(cursorResponses), onCompletionGuard);
+    if (!scheduleStatus.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, scheduleStatus);
+        return;
+    }
+}
+
+Status CollectionCloner::_startArm_inlock(std::vector<CursorResponse> cursorResponses,
+                                          std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
     // Initialize the 'AsyncResultsMerger'(ARM).
     std::vector<ClusterClientCursorParams::RemoteCursor> remoteCursors;
     for (auto&& cursorResponse : cursorResponses) {
@@ -631,22 +702,327 @@ void CollectionCloner::_establishCollectionCursorsCallback(const RemoteCommandCa
     _arm = stdx::make_unique<AsyncResultsMerger>(
         cc().getOperationContext(), _executor, _clusterClientCursorParams.get());
 
-    // This completion guard invokes _finishCallback on destruction.
-    auto cancelRemainingWorkInLock = [this]() { _cancelRemainingWork_inlock(); };
-    auto finishCallbackFn = [this](const Status& status) { _finishCallback(status); };
-    auto onCompletionGuard =
-        std::make_shared<OnCompletionGuard>(cancelRemainingWorkInLock, finishCallbackFn);
-
-    // Lock guard must be declared after completion guard. If there is an error in this function
-    // that will cause the destructor of the completion guard to run, the destructor must be run
-    // outside the mutex. This is a necessary condition to invoke _finishCallback.
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
     Status scheduleStatus = _scheduleNextARMResultsCallback(onCompletionGuard);
     _arm->detachFromOperationContext();
+    return scheduleStatus;
+}
+
+bool CollectionCloner::_canCloneInIdRanges() const {
+    return !_idIndexSpec.isEmpty() && !_options.capped && _options.collation.isEmpty();
+}
+
+Status CollectionCloner::_scheduleIdRangeCommand_inlock(
+    const BSONObj& cmdObj, const executor::TaskExecutor::RemoteCommandCallbackFn& callback) {
+    if (_state == State::kShuttingDown) {
+        return {ErrorCodes::CallbackCanceled, "Cloner shutting down."};
+    }
+    auto scheduler = stdx::make_unique<RemoteCommandRetryScheduler>(
+        _executor,
+        RemoteCommandRequest(_source,
+                             _sourceNss.db().toString(),
+                             cmdObj,
+                             ReadPreferenceSetting::secondaryPreferredMetadata(),
+                             nullptr,
+                             RemoteCommandRequest::kNoTimeout),
+        callback,
+        RemoteCommandRetryScheduler::makeRetryPolicy(
+            numInitialSyncCollectionFindAttempts.load(),
+            executor::RemoteCommandRequest::kNoTimeout,
+            RemoteCommandRetryScheduler::kAllRetriableErrors));
+    auto scheduleStatus = scheduler->startup();
     if (!scheduleStatus.isOK()) {
-        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, scheduleStatus);
+        return scheduleStatus;
+    }
+    _idRangeSchedulers.push_back(std::move(scheduler));
+    return Status::OK();
+}
+
+Status CollectionCloner::_scheduleIdRangeSplitPointsLookup_inlock(
+    std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    // The sample is sorted on the sync source, and every kIdRangeSamplesPerCursor-th _id of it
+    // becomes a boundary. The batch is large enough to return the whole sample at once.
+    const long long sampleSize =
+        static_cast<long long>(_maxNumClonerCursors) * kIdRangeSamplesPerCursor;
+    const BSONArray pipeline = BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                          << BSON("$project" << BSON("_id" << 1))
+                                          << BSON("$sort" << BSON("_id" << 1)));
+    const BSONObj cmdObj = BSON("aggregate" << _sourceNss.coll() << "pipeline" << pipeline
+                                            << "cursor"
+                                            << BSON("batchSize" << sampleSize + 1));
+    return _scheduleIdRangeCommand_inlock(
+        cmdObj,
+        stdx::bind(&CollectionCloner::_idRangeSplitPointsCallback,
+                   this,
+                   stdx::placeholders::_1,
+                   onCompletionGuard));
+}
+
+void CollectionCloner::_idRangeSplitPointsCallback(
+    const RemoteCommandCallbackArgs& rcbd, std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    UniqueLock lk(_mutex);
+    if (!rcbd.response.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, rcbd.response.status);
         return;
     }
+    Status commandStatus = getStatusFromCommandResult(rcbd.response.data);
+    if (commandStatus == ErrorCodes::NamespaceNotFound) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, Status::OK());
+        return;
+    }
+    if (!commandStatus.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+            lk,
+            {commandStatus.code(),
+             str::stream() << "While splitting collection '" << _sourceNss.ns()
+                           << "' into _id ranges there was an error '"
+                           << commandStatus.reason()
+                           << "'"});
+        return;
+    }
+    auto sampleResponse = CursorResponse::parseFromBSON(rcbd.response.data);
+    if (!sampleResponse.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, sampleResponse.getStatus());
+        return;
+    }
+
+    // A sample smaller than requested, for example because documents were deleted since they
+    // were counted, still splits the collection into ranges of about the same number of samples.
+    const auto& sample = sampleResponse.getValue().getBatch();
+    for (int rangeNumber = 1; rangeNumber < _maxNumClonerCursors; ++rangeNumber) {
+        const size_t sampleIndex =
+            sample.size() * rangeNumber / static_cast<size_t>(_maxNumClonerCursors);
+        if (sampleIndex == 0) {
+            continue;
+        }
+        BSONElement id = sample[sampleIndex]["_id"];
+        if (id.eoo()) {
+            onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+                lk,
+                {ErrorCodes::NoSuchKey,
+                 str::stream() << "Missing _id in document sampled from collection '"
+                               << _sourceNss.ns()
+                               << "': "
+                               << redact(sample[sampleIndex])});
+            return;
+        }
+        // Boundaries that fall on the same _id would leave an empty range in between.
+        auto& lastRange = _idRanges.back();
+        if (lastRange.min.isEmpty() || compareIds(id, lastRange.min) > 0) {
+            lastRange.max = makeIdObj(id);
+            IdRange nextRange;
+            nextRange.min = lastRange.max;
+            _idRanges.push_back(std::move(nextRange));
+        }
+    }
+    LOG(1) << "Collection cloner split collection " << _sourceNss.ns() << " into "
+           << _idRanges.size() << " ranges of the _id index from a sample of " << sample.size()
+           << " documents.";
+
+    Status scheduleStatus = _scheduleIdRangeCursor_inlock(0, onCompletionGuard);
+    if (!scheduleStatus.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, scheduleStatus);
+    }
+}
+
+size_t CollectionCloner::_nextUnfinishedIdRange_inlock(size_t rangeIndex) const {
+    while (rangeIndex < _idRanges.size() && _idRanges[rangeIndex].finished) {
+        ++rangeIndex;
+    }
+    return rangeIndex;
+}
+
+Status CollectionCloner::_scheduleIdRangeCursor_inlock(
+    size_t rangeIndex, std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    const auto& range = _idRanges[rangeIndex];
+    // The lower bound is inclusive, so the last document received is returned again when a
+    // cursor is resumed. _recordIdRangeProgress_inlock() drops it.
+    const BSONObj& min = range.lastId.isEmpty() ? range.min : range.lastId;
+
+    BSONObjBuilder cmdObj;
+    cmdObj.appendElements(makeCommandWithUUIDorCollectionName("find", _options.uuid, _sourceNss));
+    cmdObj.append("hint", _idIndexSpec.getObjectField("key"));
+    if (!min.isEmpty()) {
+        cmdObj.append("min", min);
+    }
+    if (!range.max.isEmpty()) {
+        cmdObj.append("max", range.max);
+    }
+    cmdObj.append("noCursorTimeout", true);
+    cmdObj.append("batchSize", 0);
+    return _scheduleIdRangeCommand_inlock(cmdObj.obj(),
+                                          stdx::bind(&CollectionCloner::_idRangeCursorCallback,
+                                                     this,
+                                                     stdx::placeholders::_1,
+                                                     rangeIndex,
+                                                     onCompletionGuard));
+}
+
+void CollectionCloner::_idRangeCursorCallback(
+    const RemoteCommandCallbackArgs& rcbd,
+    size_t rangeIndex,
+    std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    UniqueLock lk(_mutex);
+    if (!rcbd.response.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, rcbd.response.status);
+        return;
+    }
+    Status commandStatus = getStatusFromCommandResult(rcbd.response.data);
+    if (commandStatus == ErrorCodes::NamespaceNotFound) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, Status::OK());
+        return;
+    }
+    if (!commandStatus.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+            lk,
+            {commandStatus.code(),
+             str::stream() << "While querying collection '" << _sourceNss.ns()
+                           << "' there was an error '"
+                           << commandStatus.reason()
+                           << "'"});
+        return;
+    }
+    auto findResponse = CursorResponse::parseFromBSON(rcbd.response.data);
+    if (!findResponse.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+            lk,
+            {findResponse.getStatus().code(),
+             str::stream() << "While parsing the 'find' query against collection '"
+                           << _sourceNss.ns()
+                           << "' there was an error '"
+                           << findResponse.getStatus().reason()
+                           << "'"});
+        return;
+    }
+    _idRangeCursors.push_back(std::move(findResponse.getValue()));
+    _idRangeCursorRanges.push_back(rangeIndex);
+
+    Status scheduleStatus = Status::OK();
+    const size_t nextRangeIndex = _nextUnfinishedIdRange_inlock(rangeIndex + 1);
+    if (_state == State::kShuttingDown) {
+        scheduleStatus = {ErrorCodes::CallbackCanceled, "Cloner shutting down."};
+    } else if (nextRangeIndex < _idRanges.size()) {
+        scheduleStatus = _scheduleIdRangeCursor_inlock(nextRangeIndex, onCompletionGuard);
+    } else {
+        LOG(1) << "Collection cloner running with " << _idRangeCursors.size()
+               << " cursors established over ranges of the _id index.";
+        std::vector<CursorResponse> cursorResponses;
+        cursorResponses.swap(_idRangeCursors);
+        scheduleStatus = _startArm_inlock(std::move(cursorResponses), onCompletionGuard);
+    }
+    if (!scheduleStatus.isOK()) {
+        // Cancelling the remaining work kills the cursors too, unless it already happened before
+        // this cursor was established.
+        _killIdRangeCursors_inlock();
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, scheduleStatus);
+    }
+}
+
+void CollectionCloner::_killIdRangeCursors_inlock() {
+    for (auto&& cursorResponse : _idRangeCursors) {
+        if (cursorResponse.getCursorId() == 0) {
+            continue;
+        }
+        const BSONObj cmdObj =
+            KillCursorsRequest(cursorResponse.getNSS(), {cursorResponse.getCursorId()}).toBSON();
+        RemoteCommandRequest request(_source, _sourceNss.db().toString(), cmdObj, nullptr);
+        auto scheduleStatus = _executor->scheduleRemoteCommand(
+            request, [](const executor::TaskExecutor::RemoteCommandCallbackArgs&) {});
+        if (!scheduleStatus.isOK()) {
+            // The executor is shutting down.
+            LOG(1) << "Collection cloner could not kill cursor " << cursorResponse.getCursorId()
+                   << " on " << _source << ": " << redact(scheduleStatus.getStatus());
+        }
+    }
+    _idRangeCursors.clear();
+    _idRangeCursorRanges.clear();
+}
+
+StatusWith<bool> CollectionCloner::_recordIdRangeProgress_inlock(const BSONObj& doc) {
+    BSONElement id = doc["_id"];
+    if (id.eoo()) {
+        return Status(ErrorCodes::NoSuchKey,
+                      str::stream() << "Missing _id in document from collection '"
+                                    << _sourceNss.ns()
+                                    << "': "
+                                    << redact(doc));
+    }
+
+    // Each cursor returns its range in index order, so the last _id received from a range is
+    // the highest one.
+    auto range = _idRanges.rbegin();
+    while (!range->min.isEmpty() && compareIds(id, range->min) < 0) {
+        ++range;
+    }
+    if (!range->lastId.isEmpty() && compareIds(id, range->lastId) <= 0) {
+        return false;
+    }
+    range->lastId = makeIdObj(id);
+    return true;
+}
+
+bool CollectionCloner::_shouldResumeIdRangeCursors_inlock(const Status& status) const {
+    const auto maxResumes = numInitialSyncCollectionCursorResumeAttempts.load();
+    return _cloneInIdRanges && _state == State::kRunning && isRetriableError(status) &&
+        _stats.cursorResumes < static_cast<size_t>(maxResumes);
+}
+
+Status CollectionCloner::_resumeIdRangeCursors_inlock(
+    const Status& status, std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    ++_stats.cursorResumes;
+    log() << "Resuming the cursors cloning collection " << _sourceNss.ns() << " after error "
+          << redact(status) << "; attempt " << _stats.cursorResumes << " of "
+          << numInitialSyncCollectionCursorResumeAttempts.load();
+
+    // Ranges whose documents have all been received are not read again.
+    for (size_t remoteIndex = 0; remoteIndex < _idRangeCursorRanges.size(); ++remoteIndex) {
+        if (_arm->remoteExhaustedAndDrained(remoteIndex)) {
+            _idRanges[_idRangeCursorRanges[remoteIndex]].finished = true;
+        }
+    }
+    _idRangeCursorRanges.clear();
+
+    Client::initThreadIfNotAlready();
+    _killArmHandle = _arm->kill(cc().getOperationContext());
+    if (!_killArmHandle.isValid()) {
+        // The executor is shutting down.
+        return status;
+    }
+    return _executor
+        ->onEvent(_killArmHandle,
+                  stdx::bind(&CollectionCloner::_resumeIdRangeCursorsCallback,
+                             this,
+                             stdx::placeholders::_1,
+                             onCompletionGuard))
+        .getStatus();
+}
+
+void CollectionCloner::_resumeIdRangeCursorsCallback(
+    const executor::TaskExecutor::CallbackArgs& cbd,
+    std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    UniqueLock lk(_mutex);
+    if (!cbd.status.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, cbd.status);
+        return;
+    }
+    if (_state == State::kShuttingDown) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(
+            lk, {ErrorCodes::CallbackCanceled, "Cloner shutting down."});
+        return;
+    }
+
+    // The killed ARM is safe to destroy once its kill event has been signaled.
+    _arm.reset();
+    _clusterClientCursorParams.reset();
+    _killArmHandle = executor::TaskExecutor::EventHandle();
+
+    // The cursor whose error caused the resume did not finish its range, so at least one range is
+    // left to read.
+    const size_t rangeIndex = _nextUnfinishedIdRange_inlock(0);
+    invariant(rangeIndex < _idRanges.size());
+    Status scheduleStatus = _scheduleIdRangeCursor_inlock(rangeIndex, onCompletionGuard);
+    if (!scheduleStatus.isOK()) {
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, scheduleStatus);
+    }
 }
 
 StatusWith<std::vector<BSONElement>> CollectionCloner::_parseParallelCollectionScanResponse(
@@ -672,6 +1048,7 @@ Status CollectionCloner::_bufferNextBatchFromArm(WithLock lock) {
     while (_arm->ready()) {
         auto armResultStatus = _arm->nextReady();
         if (!armResultStatus.getStatus().isOK()) {
+            _arm->detachFromOperationContext();
             return armResultStatus.getStatus();
         }
         if (armResultStatus.getValue().isEOF()) {
@@ -679,6 +1056,16 @@ Status CollectionCloner::_bufferNextBatchFromArm(WithLock lock) {
             break;
         } else {
             auto queryResult = armResultStatus.getValue().getResult();
+            if (_cloneInIdRanges) {
+                auto isNewDocument = _recordIdRangeProgress_inlock(*queryResult);
+                if (!isNewDocument.isOK()) {
+                    _arm->detachFromOperationContext();
+                    return isNewDocument.getStatus();
+                }
+                if (!isNewDocument.getValue()) {
+                    continue;
+                }
+            }
             _documentsToInsert.push_back(std::move(*queryResult));
         }
     }
@@ -733,6 +1120,15 @@ void CollectionCloner::_handleARMResultsCallback(
     {
         UniqueLock lk(_mutex);
         auto nextBatchStatus = _bufferNextBatchFromArm(lk);
+        if (!nextBatchStatus.isOK() && _shouldResumeIdRangeCursors_inlock(nextBatchStatus)) {
+            // The documents buffered so far are inserted along with the first batch from the
+            // resumed cursors.
+            auto resumeStatus = _resumeIdRangeCursors_inlock(nextBatchStatus, onCompletionGuard);
+            if (resumeStatus.isOK()) {
+                return;
+            }
+            nextBatchStatus = resumeStatus;
+        }
         if (!nextBatchStatus.isOK()) {
             onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, nextBatchStatus);
             return;
@@ -900,6 +1296,7 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
     builder->appendNumber(kDocumentsCopiedFieldName, documentsCopied);
     builder->appendNumber("indexes", indexes);
     builder->appendNumber("fetchedBatches", fetchBatches);
+    builder->appendNumber("cursorResumes", cursorResumes);
     if (start != Date_t()) {
         builder->appendDate("start", start);
         if (end != Date_t()) {
@@ -46,6 +46,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/task_runner.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/query/async_results_merger.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
@@ -62,6 +63,11 @@ namespace repl {
 
 class StorageInterface;
 
+// When set, collections with an _id index are cloned as ranges of that index, using up to
+// 'maxNumInitialSyncCollectionClonerCursors' cursors. The cursors are resumed after the last
+// document received when they fail with a retriable error.
+extern AtomicBool initialSyncCloneCollectionsInIdRanges;
+
 class CollectionCloner : public BaseCloner {
     MONGO_DISALLOW_COPYING(CollectionCloner);
 
@@ -83,6 +89,7 @@ public:
         size_t documentsCopied{0};
         size_t indexes{0};
         size_t fetchBatches{0};
+        size_t cursorResumes{0};
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -220,6 +227,88 @@ private:
                                 std::vector<CursorResponse>* cursors,
                                 EstablishCursorsCommand cursorCommand);
 
+    /**
+     * A range of the _id index cloned by one cursor. The bounds and the last _id are objects of the
+     * form {_id: <value>}.
+     */
+    struct IdRange {
+        BSONObj min;     // Inclusive lower bound, or empty for the start of the index.
+        BSONObj max;     // Exclusive upper bound, or empty for the end of the index.
+        BSONObj lastId;  // _id of the last document received from the range, if any.
+        bool finished = false;  // Set once all of the range's documents have been received.
+    };
+
+    /**
+     * Returns true if the collection can be cloned as ranges of its _id index. Capped collections
+     * must be cloned in insertion order, and a non-simple collation changes the index order.
+     */
+    bool _canCloneInIdRanges() const;
+
+    /**
+     * Schedules a command against the sync source for range-partitioned cloning.
+     */
+    Status _scheduleIdRangeCommand_inlock(
+        const BSONObj& cmdObj, const executor::TaskExecutor::RemoteCommandCallbackFn& callback);
+
+    /**
+     * Looks up the boundaries between the _id ranges in a single pass, over a random sample of
+     * the collection's _ids that the sync source sorts.
+     */
+    Status _scheduleIdRangeSplitPointsLookup_inlock(
+        std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+    void _idRangeSplitPointsCallback(const RemoteCommandCallbackArgs& rcbd,
+                                     std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Returns the index of the first range from 'rangeIndex' on that is not finished, or the
+     * number of ranges if there is none.
+     */
+    size_t _nextUnfinishedIdRange_inlock(size_t rangeIndex) const;
+
+    /**
+     * Establishes the cursor over '_idRanges[rangeIndex]', starting after the last document
+     * already received from the range. The cursors are established one unfinished range at a
+     * time, and the 'AsyncResultsMerger' is started once all of them are.
+     */
+    Status _scheduleIdRangeCursor_inlock(size_t rangeIndex,
+                                         std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+    void _idRangeCursorCallback(const RemoteCommandCallbackArgs& rcbd,
+                                size_t rangeIndex,
+                                std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Kills the cursors in '_idRangeCursors' on the sync source without waiting for the result.
+     * They are established with noCursorTimeout, so they would otherwise stay open until the sync
+     * source restarts.
+     */
+    void _killIdRangeCursors_inlock();
+
+    /**
+     * Records 'doc' as the last document received from its _id range. Returns false if the
+     * document was already received before the cursors were resumed.
+     */
+    StatusWith<bool> _recordIdRangeProgress_inlock(const BSONObj& doc);
+
+    /**
+     * Returns true if the range cursors should be re-established after 'status'.
+     */
+    bool _shouldResumeIdRangeCursors_inlock(const Status& status) const;
+
+    /**
+     * Kills the 'AsyncResultsMerger' and re-establishes the range cursors once it has been killed.
+     */
+    Status _resumeIdRangeCursors_inlock(const Status& status,
+                                        std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+    void _resumeIdRangeCursorsCallback(const executor::TaskExecutor::CallbackArgs& cbd,
+                                       std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Creates the 'AsyncResultsMerger' over the established cursors and schedules handling of its
+     * first results.
+     */
+    Status _startArm_inlock(std::vector<CursorResponse> cursorResponses,
+                            std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
     /**
      * Calls to get the next event from the 'AsyncResultsMerger'. This schedules
      * '_handleAsyncResultsCallback' to be run when the event is signaled successfully.
@@ -304,6 +393,19 @@ private:
     // (M) Scheduler used to establish the initial cursor or set of cursors.
     std::unique_ptr<RemoteCommandRetryScheduler> _establishCollectionCursorsScheduler;
 
+    // (M) Set when the collection is cloned as ranges of its _id index.
+    bool _cloneInIdRanges = false;
+    // (M) The ranges of the _id index, in index order.
+    std::vector<IdRange> _idRanges;
+    // (M) Cursors established so far on the unfinished ranges, in the order of '_idRanges'.
+    std::vector<CursorResponse> _idRangeCursors;
+    // (M) The index in '_idRanges' of each cursor in '_idRangeCursors', which is also the order of
+    // the remotes of the 'AsyncResultsMerger' once it is started.
+    std::vector<size_t> _idRangeCursorRanges;
+    // (M) Schedulers for the range-partitioned cloning commands. They are kept until the cloner is
+    // destroyed, since a scheduler cannot be destroyed from its own callback.
+    std::vector<std::unique_ptr<RemoteCommandRetryScheduler>> _idRangeSchedulers;
+
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
     // It is possible to skip intermediate states. For example,
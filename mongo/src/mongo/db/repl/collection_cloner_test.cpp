@@ -2170,4 +2170,294 @@ TEST_F(ParallelCollectionClonerTest,
     ASSERT_EQUALS(ErrorCodes::OperationFailed, getStatus());
 }
 
+/**
+ * Clones the collection in ranges of its _id index, using up to three cursors.
+ */
+class IdRangeCollectionClonerTest : public ParallelCollectionClonerTest {
+protected:
+    void setUp() override {
+        ParallelCollectionClonerTest::setUp();
+        initialSyncCloneCollectionsInIdRanges.store(true);
+    }
+
+    void tearDown() override {
+        initialSyncCloneCollectionsInIdRanges.store(false);
+        ParallelCollectionClonerTest::tearDown();
+    }
+
+    /**
+     * Responds to the next request, which must be a 'find' command, and returns the command.
+     */
+    BSONObj respondToFind(const BSONObj& response) {
+        return respondTo("find", response);
+    }
+
+    /**
+     * Responds to the next request, which must be the 'cmdName' command, and returns the command.
+     */
+    BSONObj respondTo(const std::string& cmdName, const BSONObj& response) {
+        auto net = getNet();
+        auto request =
+            assertRemoteCommandNameEquals(cmdName, net->scheduleSuccessfulResponse(response));
+        net->runReadyNetworkOperations();
+        return request.cmdObj;
+    }
+};
+
+TEST_F(IdRangeCollectionClonerTest, SplitsCollectionIntoIdRangesWithOneCursorEach) {
+    ASSERT_OK(collectionCloner->startup());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(9));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionStats.initCalled);
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        // The boundaries between the ranges are taken from a single sorted sample of the _ids.
+        BSONArrayBuilder sample;
+        for (int i = 0; i < 9; ++i) {
+            sample.append(BSON("_id" << i));
+        }
+        auto cmdObj = respondTo("aggregate", createCursorResponse(0, sample.arr()));
+        ASSERT_BSONOBJ_EQ(BSON("$sample" << BSON("size" << 3 * 32LL)),
+                          cmdObj["pipeline"].Array()[0].Obj());
+        ASSERT_BSONOBJ_EQ(BSON("$sort" << BSON("_id" << 1)), cmdObj["pipeline"].Array()[2].Obj());
+
+        // Each range is read by its own cursor.
+        cmdObj = respondToFind(createCursorResponse(1, BSONArray()));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 1), cmdObj["hint"].Obj());
+        ASSERT_FALSE(cmdObj.hasField("min"));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 3), cmdObj["max"].Obj());
+        cmdObj = respondToFind(createCursorResponse(2, BSONArray()));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 3), cmdObj["min"].Obj());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 6), cmdObj["max"].Obj());
+        cmdObj = respondToFind(createCursorResponse(3, BSONArray()));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 6), cmdObj["min"].Obj());
+        ASSERT_FALSE(cmdObj.hasField("max"));
+
+        // Cursor N returns the documents with _ids 3 * (N - 1) up to 3 * N.
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(net->hasReadyRequests());
+            auto noi = net->getNextReadyRequest();
+            auto request = assertRemoteCommandNameEquals("getMore", noi->getRequest());
+            const long long first = 3 * (request.cmdObj["getMore"].numberLong() - 1);
+            scheduleNetworkResponse(
+                noi,
+                createFinalCursorResponse(BSON_ARRAY(BSON("_id" << first)
+                                                     << BSON("_id" << first + 1)
+                                                     << BSON("_id" << first + 2))));
+            net->runReadyNetworkOperations();
+        }
+    }
+
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(9, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+}
+
+TEST_F(IdRangeCollectionClonerTest, ResumesCursorAfterLastDocumentReceivedOnRetriableError) {
+    ASSERT_OK(collectionCloner->startup());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(0));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionStats.initCalled);
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        // There is nothing to split, so a single cursor reads the whole _id index.
+        auto cmdObj = respondToFind(createCursorResponse(1, BSONArray()));
+        ASSERT_FALSE(cmdObj.hasField("min"));
+        ASSERT_FALSE(cmdObj.hasField("max"));
+
+        assertRemoteCommandNameEquals(
+            "getMore",
+            net->scheduleSuccessfulResponse(
+                createCursorResponse(1, BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2)))));
+        net->runReadyNetworkOperations();
+
+        assertRemoteCommandNameEquals(
+            "getMore", net->scheduleErrorResponse(Status(ErrorCodes::HostUnreachable, "")));
+        net->runReadyNetworkOperations();
+
+        // The failed cursor is killed and a new one is established from the last _id received.
+        net->runReadyNetworkOperations();
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto noi = net->getNextReadyRequest();
+        if (noi->getRequest().cmdObj.firstElementFieldName() == std::string("killCursors")) {
+            net->blackHole(noi);
+            net->runReadyNetworkOperations();
+            ASSERT_TRUE(net->hasReadyRequests());
+            noi = net->getNextReadyRequest();
+        }
+        auto request = assertRemoteCommandNameEquals("find", noi->getRequest());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 2), request.cmdObj["min"].Obj());
+
+        // The resumed cursor returns the last document received again, which is not inserted
+        // twice.
+        scheduleNetworkResponse(
+            noi, createCursorResponse(2, BSON_ARRAY(BSON("_id" << 2) << BSON("_id" << 3))));
+        net->runReadyNetworkOperations();
+
+        const BSONObj lastDoc = BSON("_id" << 4);
+        assertRemoteCommandNameEquals(
+            "getMore",
+            net->scheduleSuccessfulResponse(createFinalCursorResponse(BSON_ARRAY(lastDoc))));
+        net->runReadyNetworkOperations();
+    }
+
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(4, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+    ASSERT_EQUALS(1U, collectionCloner->getStats().cursorResumes);
+}
+
+TEST_F(IdRangeCollectionClonerTest, DoesNotResumeCursorsOfRangesAlreadyReceived) {
+    ASSERT_OK(collectionCloner->startup());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(4));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionStats.initCalled);
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        // A sample of two _ids only yields one boundary, so there are two ranges.
+        respondTo("aggregate",
+                  createCursorResponse(0, BSON_ARRAY(BSON("_id" << 0) << BSON("_id" << 5))));
+        auto cmdObj = respondToFind(createCursorResponse(1, BSONArray()));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 5), cmdObj["max"].Obj());
+        cmdObj = respondToFind(createCursorResponse(2, BSONArray()));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 5), cmdObj["min"].Obj());
+
+        // The first range is received in full before the cursor of the second one fails.
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto noi = net->getNextReadyRequest();
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto failingNoi = net->getNextReadyRequest();
+        assertRemoteCommandNameEquals("getMore", noi->getRequest());
+        assertRemoteCommandNameEquals("getMore", failingNoi->getRequest());
+        if (noi->getRequest().cmdObj["getMore"].numberLong() != 1) {
+            std::swap(noi, failingNoi);
+        }
+        scheduleNetworkResponse(
+            noi, createFinalCursorResponse(BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2))));
+        net->runReadyNetworkOperations();
+        scheduleNetworkResponse(failingNoi, ErrorCodes::HostUnreachable, "");
+        net->runReadyNetworkOperations();
+
+        // Only the cursor of the second range is established again.
+        net->runReadyNetworkOperations();
+        ASSERT_TRUE(net->hasReadyRequests());
+        noi = net->getNextReadyRequest();
+        if (noi->getRequest().cmdObj.firstElementFieldName() == std::string("killCursors")) {
+            net->blackHole(noi);
+            net->runReadyNetworkOperations();
+            ASSERT_TRUE(net->hasReadyRequests());
+            noi = net->getNextReadyRequest();
+        }
+        auto request = assertRemoteCommandNameEquals("find", noi->getRequest());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 5), request.cmdObj["min"].Obj());
+        ASSERT_FALSE(request.cmdObj.hasField("max"));
+        scheduleNetworkResponse(
+            noi, createFinalCursorResponse(BSON_ARRAY(BSON("_id" << 5) << BSON("_id" << 6))));
+        net->runReadyNetworkOperations();
+        ASSERT_FALSE(net->hasReadyRequests());
+    }
+
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(4, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+    ASSERT_EQUALS(1U, collectionCloner->getStats().cursorResumes);
+}
+
+TEST_F(IdRangeCollectionClonerTest, KillsEstablishedRangeCursorsOnError) {
+    ASSERT_OK(collectionCloner->startup());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(4));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        respondTo("aggregate",
+                  createCursorResponse(0, BSON_ARRAY(BSON("_id" << 0) << BSON("_id" << 5))));
+        respondToFind(createCursorResponse(1, BSONArray()));
+        respondToFind(BSON("ok" << 0 << "errmsg"
+                                << "find failed"
+                                << "code"
+                                << ErrorCodes::OperationFailed));
+
+        // The cursor of the first range doesn't time out on the sync source, so it is killed.
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto request = assertRemoteCommandNameEquals(
+            "killCursors", net->scheduleSuccessfulResponse(BSON("ok" << 1)));
+        ASSERT_EQUALS(1LL, request.cmdObj["cursors"].Array()[0].numberLong());
+        net->runReadyNetworkOperations();
+        ASSERT_FALSE(net->hasReadyRequests());
+    }
+
+    collectionCloner->join();
+    ASSERT_EQUALS(ErrorCodes::OperationFailed, getStatus());
+    ASSERT_FALSE(collectionStats.commitCalled);
+}
+
+TEST_F(IdRangeCollectionClonerTest, KillsEstablishedRangeCursorsOnShutdown) {
+    ASSERT_OK(collectionCloner->startup());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(4));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        respondTo("aggregate",
+                  createCursorResponse(0, BSON_ARRAY(BSON("_id" << 0) << BSON("_id" << 5))));
+        respondToFind(createCursorResponse(1, BSONArray()));
+    }
+
+    // Shutting down cancels the 'find' of the second range and kills the cursor of the first.
+    collectionCloner->shutdown();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        net->runReadyNetworkOperations();
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto request = assertRemoteCommandNameEquals(
+            "killCursors", net->scheduleSuccessfulResponse(BSON("ok" << 1)));
+        ASSERT_EQUALS(1LL, request.cmdObj["cursors"].Array()[0].numberLong());
+        net->runReadyNetworkOperations();
+    }
+
+    collectionCloner->join();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, getStatus());
+}
+
 }  // namespace
@@ -140,6 +140,40 @@ public:
     }
 } exportedBatchLimitOperationsParam;
 
+/**
+ * The number of groups of independent operations that each batch is split into per writer thread.
+ * Groups are handed to writer threads as the threads become free, so a thread that is given a
+ * group with many operations doesn't leave the other threads idle until it finishes the batch.
+ */
+AtomicInt32 replWriterOpGroupsPerThread(4);
+
+class ExportedWriterOpGroupsPerThreadParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedWriterOpGroupsPerThreadParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "replWriterOpGroupsPerThread",
+              &replWriterOpGroupsPerThread) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "replWriterOpGroupsPerThread must be between 1 and 64, inclusive");
+        }
+
+        return Status::OK();
+    }
+} exportedWriterOpGroupsPerThreadParam;
+
+// When set, the next batch is written to the oplog and split up for the writer threads while the
+// current batch is being applied, rather than afterwards.
+MONGO_EXPORT_SERVER_PARAMETER(replPipelineBatchApplication, bool, false);
+
+// Failpoint which makes oplog application hang once the next batch has been written to the oplog
+// and the current one has been applied, before the current one is recorded as applied.
+MONGO_FP_DECLARE(hangAfterPreparingNextBatch);
+
 // The oplog entries applied
 Counter64 opsAppliedStats;
 ServerStatusMetricField<Counter64> displayOpsApplied("repl.apply.ops", &opsAppliedStats);
@@ -170,6 +204,14 @@ bool isCrudOpType(const char* field) {
     return false;
 }
 
+// Commands and index builds must be applied one at a time, in a batch of their own.
+bool mustBeAppliedAlone(const OplogEntry& entry) {
+    return entry.isCommand() ||
+        // Index builds are achieved through the use of an insert op, not a command op.
+        // The following line is the same as what the insert code uses to detect an index build.
+        (!entry.getNamespace().isEmpty() && entry.getNamespace().coll() == "system.indexes");
+}
+
 class ApplyBatchFinalizer {
 public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
@@ -468,13 +510,24 @@ void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
               std::vector<Status>* statusVector) {
     invariant(writerVectors.size() == statusVector->size());
     TimerHolder timer(&applyBatchStats);
+
+    // The pool hands each vector to whichever thread is free next. Scheduling the largest vectors
+    // first keeps one big vector from being left until the end while the other threads sit idle.
+    std::vector<size_t> order;
     for (size_t i = 0; i < writerVectors.size(); i++) {
         if (!writerVectors[i].empty()) {
-            writerPool->schedule([&func, &writerVectors, statusVector, i] {
-                (*statusVector)[i] = func(&writerVectors[i]);
-            });
+            order.push_back(i);
         }
     }
+    std::stable_sort(order.begin(), order.end(), [&writerVectors](size_t l, size_t r) {
+        return writerVectors[l].size() > writerVectors[r].size();
+    });
+
+    for (size_t i : order) {
+        writerPool->schedule([&func, &writerVectors, statusVector, i] {
+            (*statusVector)[i] = func(&writerVectors[i]);
+        });
+    }
 }
 
 void initializeWriterThread() {
@@ -626,7 +679,9 @@ private:
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * writerVectors - Groups of operations to apply. Operations that must be applied in order, because
+ *      they are on the same document or on a collection without document-level concurrency, end up
+ *      in the same group. Different groups may be applied concurrently, by any writer thread.
  * latestSessionRecords - Populated map of the "latest" transaction table records for each logical
  *      session id present in the given operations. Each record represents the final state of the
  *      transaction table entry for that session id after the operations are applied.
@@ -698,6 +753,54 @@ void fillWriterVectorsAndLatestSessionRecords(
     }
 }
 
+/**
+ * A batch of oplog entries and the state built up for it before the writer threads apply it.
+ * Moving a batch keeps the pointers in 'writerVectors' valid, copying one doesn't.
+ */
+struct OplogApplicationBatch {
+    MultiApplier::Operations ops;
+
+    // True once 'ops' has been written to the oplog and split into 'writerVectors'.
+    bool prepared = false;
+    std::vector<MultiApplier::OperationPtrs> writerVectors;
+    SessionRecordMap latestSessionRecords;
+};
+
+/**
+ * Makes sure the oplog doesn't go back in time or repeat an entry: a batch starting at
+ * 'firstOpTimeInBatch' may only follow operations up to 'lastOpTime'.
+ */
+void fassertOplogMovesForward(const OpTime& firstOpTimeInBatch, const OpTime& lastOpTime) {
+    if (firstOpTimeInBatch <= lastOpTime) {
+        fassert(34361,
+                Status(ErrorCodes::OplogOutOfOrder,
+                       str::stream() << "Attempted to apply an oplog entry ("
+                                     << firstOpTimeInBatch.toString()
+                                     << ") which is not greater than our last applied OpTime ("
+                                     << lastOpTime.toString()
+                                     << ")."));
+    }
+}
+
+/**
+ * Returns the next batch if one is ready, or no operations otherwise.
+ */
+using NextBatchFn = stdx::function<MultiApplier::Operations()>;
+
+/**
+ * Does the work of multiApply() for 'batch', preparing it first if that hasn't been done.
+ *
+ * If 'getNextBatch' is set, the batch it returns is prepared into 'nextBatch' while the writer
+ * threads apply 'batch', so it can be passed in as the next 'batch' without writing it to the
+ * oplog again.
+ */
+StatusWith<OpTime> applyBatch(OperationContext* opCtx,
+                              OldThreadPool* workerPool,
+                              OplogApplicationBatch* batch,
+                              const MultiApplier::ApplyOperationFn& applyOperation,
+                              const NextBatchFn& getNextBatch,
+                              OplogApplicationBatch* nextBatch);
+
 }  // namespace
 
 /**
@@ -709,14 +812,18 @@ void fillWriterVectorsAndLatestSessionRecords(
  * this batch, it will not be updated.
  */
 OpTime SyncTail::multiApply(OperationContext* opCtx, MultiApplier::Operations ops) {
-    auto applyOperation = [this](MultiApplier::OperationPtrs* ops) -> Status {
+    return fassertStatusOK(
+        34437,
+        repl::multiApply(opCtx, _writerPool.get(), std::move(ops), _makeApplyOperationFn()));
+}
+
+MultiApplier::ApplyOperationFn SyncTail::_makeApplyOperationFn() {
+    return [this](MultiApplier::OperationPtrs* ops) -> Status {
         _applyFunc(ops, this);
         // This function is used by 3.2 initial sync and steady state data replication.
         // _applyFunc() will throw or abort on error, so we return OK here.
         return Status::OK();
     };
-    return fassertStatusOK(
-        34437, repl::multiApply(opCtx, _writerPool.get(), std::move(ops), applyOperation));
 }
 
 namespace {
@@ -885,6 +992,21 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
     ReplicationConsistencyMarkers* consistencyMarkers = replProcess->getConsistencyMarkers();
     OpTime minValid;
 
+    const auto applyOperation = _makeApplyOperationFn();
+
+    // With pipelining, the batch that was written to the oplog while the previous one was being
+    // applied. It is applied before anything else is taken from the batcher.
+    OplogApplicationBatch preparedBatch;
+    bool mustShutdown = false;
+    auto takeBatchIfReady = [&]() -> MultiApplier::Operations {
+        OpQueue ops = batcher.getNextBatch(Seconds(0));
+        if (ops.mustShutdown()) {
+            // Shut down after applying the batches we already have.
+            mustShutdown = true;
+        }
+        return ops.releaseBatch();
+    };
+
     while (true) {  // Exits on message from OpQueueBatcher.
         // Use a new operation context each iteration, as otherwise we may appear to use a single
         // collection name to refer to collections with different UUIDs.
@@ -912,46 +1034,65 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
         // Transition to SECONDARY state, if possible.
         tryToGoLiveAsASecondary(&opCtx, replCoord, minValid);
 
-        long long termWhenBufferIsEmpty = replCoord->getTerm();
-        // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OpQueue ops = batcher.getNextBatch(Seconds(1));
-        if (ops.empty()) {
-            if (ops.mustShutdown()) {
+        OplogApplicationBatch batch;
+        if (preparedBatch.prepared) {
+            batch = std::move(preparedBatch);
+            preparedBatch = OplogApplicationBatch();
+        } else {
+            if (mustShutdown) {
                 // Shut down and exit oplog application loop.
                 return;
             }
-            if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
-                continue;
+
+            long long termWhenBufferIsEmpty = replCoord->getTerm();
+            // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
+            // ready in time, we'll loop again so we can do the above checks periodically.
+            OpQueue ops = batcher.getNextBatch(Seconds(1));
+            if (ops.empty()) {
+                if (ops.mustShutdown()) {
+                    // Shut down and exit oplog application loop.
+                    return;
+                }
+                if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
+                    continue;
+                }
+                // Signal drain complete if we're in Draining state and the buffer is empty.
+                replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
+                continue;  // Try again.
             }
-            // Signal drain complete if we're in Draining state and the buffer is empty.
-            replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
-            continue;  // Try again.
+            batch.ops = ops.releaseBatch();
         }
 
-        // Extract some info from ops that we'll need after releasing the batch below.
+        // Extract some info from ops that we'll need after applying the batch below.
         const auto firstOpTimeInBatch =
-            fassertStatusOK(40299, OpTime::parseFromOplogEntry(ops.front().raw));
+            fassertStatusOK(40299, OpTime::parseFromOplogEntry(batch.ops.front().raw));
         const auto lastOpTimeInBatch =
-            fassertStatusOK(28773, OpTime::parseFromOplogEntry(ops.back().raw));
-
-        // Make sure the oplog doesn't go back in time or repeat an entry.
-        if (firstOpTimeInBatch <= replCoord->getMyLastAppliedOpTime()) {
-            fassert(34361,
-                    Status(ErrorCodes::OplogOutOfOrder,
-                           str::stream() << "Attempted to apply an oplog entry ("
-                                         << firstOpTimeInBatch.toString()
-                                         << ") which is not greater than our last applied OpTime ("
-                                         << replCoord->getMyLastAppliedOpTime().toString()
-                                         << ")."));
-        }
+            fassertStatusOK(28773, OpTime::parseFromOplogEntry(batch.ops.back().raw));
+
+        // A prepared batch was already checked against the batch before it, before it was
+        // written to the oplog.
+        fassertOplogMovesForward(firstOpTimeInBatch, replCoord->getMyLastAppliedOpTime());
 
         // Don't allow the fsync+lock thread to see intermediate states of batch application.
         stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
 
-        // Apply the operations in this batch. 'multiApply' returns the optime of the last op that
+        // Preparing the next batch early requires writing it to the oplog in parallel with
+        // applying this one, and must not let the oldest timestamp move past it in between.
+        const bool pipeline = replPipelineBatchApplication.load() &&
+            opCtx.getServiceContext()->getGlobalStorageEngine()->supportsDocLocking() &&
+            serverGlobalParams.enableMajorityReadConcern && !mustShutdown &&
+            !MONGO_FAIL_POINT(rsSyncApplyStop);
+
+        // Apply the operations in this batch. 'applyBatch' returns the optime of the last op that
         // was applied, which should be the last optime in the batch.
-        auto lastOpTimeAppliedInBatch = multiApply(&opCtx, ops.releaseBatch());
+        auto lastOpTimeAppliedInBatch =
+            fassertStatusOK(40679,
+                            applyBatch(&opCtx,
+                                       _writerPool.get(),
+                                       &batch,
+                                       applyOperation,
+                                       pipeline ? NextBatchFn(takeBatchIfReady) : NextBatchFn(),
+                                       &preparedBatch));
         invariant(lastOpTimeAppliedInBatch == lastOpTimeInBatch);
 
         // In order to provide resilience in the event of a crash in the middle of batch
@@ -1048,10 +1189,7 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
     }
 
     // Check for ops that must be processed one at a time.
-    if (entry.isCommand() ||  // commands.
-        // Index builds are achieved through the use of an insert op, not a command op.
-        // The following line is the same as what the insert code uses to detect an index build.
-        (!entry.getNamespace().isEmpty() && entry.getNamespace().coll() == "system.indexes")) {
+    if (mustBeAppliedAlone(entry)) {
         if (ops->getCount() == 1) {
             // apply commands one-at-a-time
             _networkQueue->consume(opCtx);
@@ -1469,25 +1607,14 @@ Status multiInitialSyncApply_noAbort(OperationContext* opCtx,
     return Status::OK();
 }
 
-StatusWith<OpTime> multiApply(OperationContext* opCtx,
+namespace {
+StatusWith<OpTime> applyBatch(OperationContext* opCtx,
                               OldThreadPool* workerPool,
-                              MultiApplier::Operations ops,
-                              MultiApplier::ApplyOperationFn applyOperation) {
-    if (!opCtx) {
-        return {ErrorCodes::BadValue, "invalid operation context"};
-    }
-
-    if (!workerPool) {
-        return {ErrorCodes::BadValue, "invalid worker pool"};
-    }
-
-    if (ops.empty()) {
-        return {ErrorCodes::EmptyArrayOperation, "no operations provided to multiApply"};
-    }
-
-    if (!applyOperation) {
-        return {ErrorCodes::BadValue, "invalid apply operation function"};
-    }
+                              OplogApplicationBatch* batch,
+                              const MultiApplier::ApplyOperationFn& applyOperation,
+                              const NextBatchFn& getNextBatch,
+                              OplogApplicationBatch* nextBatch) {
+    auto& ops = batch->ops;
 
     const auto storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
     if (storageEngine->isMmapV1()) {
@@ -1509,7 +1636,10 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
                 "attempting to replicate ops while primary"};
     }
 
-    std::vector<Status> statusVector(workerPool->getNumThreads(), Status::OK());
+    // Split the batch into more groups than there are writer threads, so that the threads can
+    // balance the work between them.
+    const size_t numOpGroups = workerPool->getNumThreads() * replWriterOpGroupsPerThread.load();
+    std::vector<Status> statusVector;
     {
         const bool pinOldestTimestamp = !serverGlobalParams.enableMajorityReadConcern;
         std::unique_ptr<RecoveryUnit> pinningTransaction;
@@ -1541,34 +1671,68 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
             }
         });
 
-        // Write batch of ops into oplog.
-        consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
-        scheduleWritesToOplog(opCtx, workerPool, ops);
+        // Writes 'toPrepare' into the oplog and splits it up for the writer threads. The writes
+        // are only finished once the pool has been joined.
+        auto prepare = [&](OplogApplicationBatch* toPrepare) {
+            consistencyMarkers->setOplogTruncateAfterPoint(opCtx,
+                                                           toPrepare->ops.front().getTimestamp());
+            scheduleWritesToOplog(opCtx, workerPool, toPrepare->ops);
+
+            toPrepare->writerVectors.resize(numOpGroups);
+            fillWriterVectorsAndLatestSessionRecords(opCtx,
+                                                     &toPrepare->ops,
+                                                     &toPrepare->writerVectors,
+                                                     &toPrepare->latestSessionRecords);
+            toPrepare->prepared = true;
+        };
 
-        std::vector<MultiApplier::OperationPtrs> writerVectors(workerPool->getNumThreads());
-        SessionRecordMap latestSessionRecords;
-        fillWriterVectorsAndLatestSessionRecords(
-            opCtx, &ops, &writerVectors, &latestSessionRecords);
+        if (!batch->prepared) {
+            // Write batch of ops into oplog.
+            prepare(batch);
 
-        // Wait for writes to finish before applying ops.
-        workerPool->join();
+            // Wait for writes to finish before applying ops.
+            workerPool->join();
+        }
 
         // Reset consistency markers in case the node fails while applying ops.
         consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
         consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
 
-        applyOps(writerVectors, workerPool, applyOperation, &statusVector);
+        statusVector.assign(batch->writerVectors.size(), Status::OK());
+        applyOps(batch->writerVectors, workerPool, applyOperation, &statusVector);
+
+        // Prepare the next batch while this one is applied. The oplog truncate point covers its
+        // oplog entries until this batch has been applied and the next one takes over 'minValid',
+        // so a crash in between leaves the oplog ending with this batch. Batches after a command
+        // or index build aren't prepared early, since preparing looks up collection properties
+        // that the command may change.
+        if (getNextBatch && !mustBeAppliedAlone(ops.front())) {
+            invariant(nextBatch && !nextBatch->prepared);
+            nextBatch->ops = getNextBatch();
+            if (!nextBatch->ops.empty()) {
+                fassertOplogMovesForward(nextBatch->ops.front().getOpTime(),
+                                         ops.back().getOpTime());
+                prepare(nextBatch);
+            }
+        }
         workerPool->join();
 
+        if (nextBatch && nextBatch->prepared && MONGO_FAIL_POINT(hangAfterPreparingNextBatch)) {
+            log() << "hangAfterPreparingNextBatch fail point enabled. Blocking until fail point is "
+                     "disabled.";
+            while (MONGO_FAIL_POINT(hangAfterPreparingNextBatch)) {
+                sleepmillis(100);
+            }
+        }
+
         // Update the transaction table to point to the latest oplog entries for each session id.
-        scheduleTxnTableUpdates(opCtx, workerPool, latestSessionRecords);
+        scheduleTxnTableUpdates(opCtx, workerPool, batch->latestSessionRecords);
         workerPool->join();
 
         // Notify the storage engine that a replication batch has completed.
         // This means that all the writes associated with the oplog entries in the batch are
         // finished and no new writes with timestamps associated with those oplog entries will show
         // up in the future.
-        const auto storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
         storageEngine->replicationBatchIsComplete();
     }
 
@@ -1582,6 +1746,32 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
     // We have now written all database writes and updated the oplog to match.
     return ops.back().getOpTime();
 }
+}  // namespace
+
+StatusWith<OpTime> multiApply(OperationContext* opCtx,
+                              OldThreadPool* workerPool,
+                              MultiApplier::Operations ops,
+                              MultiApplier::ApplyOperationFn applyOperation) {
+    if (!opCtx) {
+        return {ErrorCodes::BadValue, "invalid operation context"};
+    }
+
+    if (!workerPool) {
+        return {ErrorCodes::BadValue, "invalid worker pool"};
+    }
+
+    if (ops.empty()) {
+        return {ErrorCodes::EmptyArrayOperation, "no operations provided to multiApply"};
+    }
+
+    if (!applyOperation) {
+        return {ErrorCodes::BadValue, "invalid apply operation function"};
+    }
+
+    OplogApplicationBatch batch;
+    batch.ops = std::move(ops);
+    return applyBatch(opCtx, workerPool, &batch, applyOperation, NextBatchFn(), nullptr);
+}
 
 }  // namespace repl
 }  // namespace mongo
@@ -234,6 +234,9 @@ protected:
 private:
     class OpQueueBatcher;
 
+    // Returns the function that applies a group of operations of a batch with _applyFunc.
+    MultiApplier::ApplyOperationFn _makeApplyOperationFn();
+
     std::string _hostname;
 
     BackgroundSync* _networkQueue;
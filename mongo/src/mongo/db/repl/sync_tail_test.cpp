@@ -574,6 +574,66 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_BSONOBJ_EQ(op2.raw, operationsWrittenToOplog[1].doc);
 }
 
+TEST_F(SyncTailTest, MultiApplySplitsBatchIntoMoreGroupsThanWriterThreads) {
+    OldThreadPool writerPool(1);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterThreadToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    // Two operations on the same document in each of several collections.
+    const int numCollections = 20;
+    MultiApplier::Operations ops;
+    for (int i = 0; i < numCollections; i++) {
+        NamespaceString nss("test.t" + std::to_string(i));
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), i), 1LL}, nss, BSON("_id" << 0 << "x" << 1)));
+    }
+    for (int i = 0; i < numCollections; i++) {
+        NamespaceString nss("test.t" + std::to_string(i));
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(2), i), 1LL}, nss, BSON("_id" << 0 << "x" << 2)));
+    }
+
+    auto lastOpTime =
+        unittest::assertGet(multiApply(_opCtx.get(), &writerPool, ops, applyOperationFn));
+    ASSERT_EQUALS(ops.back().getOpTime(), lastOpTime);
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+
+    // A single writer thread still gets the batch in several groups.
+    ASSERT_GREATER_THAN(operationsApplied.size(), 1U);
+
+    // Both operations on a document are in the same group, in their original order.
+    size_t total = 0;
+    for (auto&& group : operationsApplied) {
+        total += group.size();
+        for (size_t i = 0; i < group.size(); i++) {
+            if (group[i].getTimestamp().getSecs() != 1) {
+                continue;
+            }
+            size_t matches = 0;
+            for (size_t j = 0; j < group.size(); j++) {
+                if (group[j].getNamespace() == group[i].getNamespace() && j != i) {
+                    ASSERT_GREATER_THAN(j, i);
+                    ASSERT_EQUALS(2U, group[j].getTimestamp().getSecs());
+                    matches++;
+                }
+            }
+            ASSERT_EQUALS(1U, matches);
+        }
+    }
+    ASSERT_EQUALS(ops.size(), total);
+}
+
 TEST_F(SyncTailTest, MultiApplyUpdatesTheTransactionTable) {
     // Set up the transactions collection, which can only be done by the primary.
     ASSERT_OK(ReplicationCoordinator::get(_opCtx.get())->setFollowerMode(MemberState::RS_PRIMARY));
@@ -204,6 +204,7 @@ void updateSessionEntry(OperationContext* opCtx, const UpdateRequest& updateRequ
                                true,   // enforceQuota
                                false,  // indexesAffected = false because _id is the only index
                                nullptr,
+                               nullptr,
                                &args);
 
     wuow.commit();
@@ -32,12 +32,15 @@
 
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_btree_impl.h"
 
+#include <map>
 #include <set>
 
 #include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -71,6 +74,56 @@ BSONObj stripFieldNames(const BSONObj& query) {
 
 typedef std::set<IndexKeyEntry, IndexEntryComparison> IndexSet;
 
+// An insert or removal of an index entry by a unit of work that has not committed yet. The entry
+// stays in the index until the unit of work ends, so that a rollback never has to put it back.
+struct PendingChange {
+    const RecoveryUnit* owner;
+    bool committedPresent;  // Whether other units of work see the entry.
+    bool present;           // Whether 'owner' sees the entry.
+};
+
+typedef std::map<IndexKeyEntry, PendingChange, IndexEntryComparison> PendingChanges;
+
+// This is the "persistent" data of an index, shared by every SortedDataInterface opened on it.
+struct IndexData {
+    explicit IndexData(const Ordering& ordering)
+        : keys(IndexEntryComparison(ordering)), pendingChanges(IndexEntryComparison(ordering)) {}
+
+    /**
+     * Returns whether the unit of work of 'reader' sees 'entry', which must be in 'keys'.
+     */
+    bool isVisible_inlock(const RecoveryUnit* reader, const IndexKeyEntry& entry) const {
+        PendingChanges::const_iterator pending = pendingChanges.find(entry);
+        if (pending == pendingChanges.end())
+            return true;
+        return pending->second.owner == reader ? pending->second.present
+                                               : pending->second.committedPresent;
+    }
+
+    /**
+     * Forgets the pending change to 'entry' once its unit of work commits or rolls back, and
+     * drops the entry from 'keys' if it no longer exists afterwards.
+     */
+    void endPendingChange_inlock(const IndexKeyEntry& entry, bool committed) {
+        PendingChanges::iterator pending = pendingChanges.find(entry);
+        invariant(pending != pendingChanges.end());
+        const bool present =
+            committed ? pending->second.present : pending->second.committedPresent;
+        pendingChanges.erase(pending);
+        if (!present)
+            keys.erase(entry);
+        generation++;
+    }
+
+    stdx::mutex mutex;
+    IndexSet keys;
+    PendingChanges pendingChanges;
+
+    // Bumped on every change to 'keys'. Cursors take the mutex per call rather than for their
+    // lifetime, and re-find their position when this has moved since they were positioned.
+    uint64_t generation = 0;
+};
+
 // taken from btree_logic.cpp
 Status dupKeyError(const BSONObj& key) {
     StringBuilder sb;
@@ -80,13 +133,32 @@ Status dupKeyError(const BSONObj& key) {
     return Status(ErrorCodes::DuplicateKey, sb.str());
 }
 
-bool isDup(const IndexSet& data, const BSONObj& key, RecordId loc) {
-    const IndexSet::const_iterator it = data.find(IndexKeyEntry(key, RecordId()));
-    if (it == data.end())
-        return false;
-
-    // Not a dup if the entry is for the same loc.
-    return it->loc != loc;
+/**
+ * Returns whether the unit of work of 'reader' sees an entry for 'key' other than the one for
+ * 'loc'. Throws WriteConflictException if another unit of work has an uncommitted change to an
+ * entry for 'key', since whether that is a duplicate depends on how the other unit of work ends.
+ */
+bool isDup_inlock(const IndexData& index,
+                  const RecoveryUnit* reader,
+                  const BSONObj& key,
+                  const RecordId& loc) {
+    const IndexKeyEntry anyLoc(key, RecordId());
+    for (IndexSet::const_iterator it = index.keys.lower_bound({key, RecordId::min()});
+         it != index.keys.end() && index.keys.value_comp().compare(*it, anyLoc) == 0;
+         ++it) {
+        // Not a dup if the entry is for the same loc.
+        if (it->loc == loc)
+            continue;
+
+        PendingChanges::const_iterator pending = index.pendingChanges.find(*it);
+        if (pending == index.pendingChanges.end())
+            return true;
+        if (pending->second.owner != reader)
+            throw WriteConflictException();
+        if (pending->second.present)
+            return true;
+    }
+    return false;
 }
 
 class EphemeralForTestBtreeBuilderImpl : public SortedDataBuilderInterface {
@@ -138,7 +210,8 @@ private:
 
 class EphemeralForTestBtreeImpl : public SortedDataInterface {
 public:
-    EphemeralForTestBtreeImpl(IndexSet* data, bool isUnique) : _data(data), _isUnique(isUnique) {
+    EphemeralForTestBtreeImpl(IndexData* index, bool isUnique)
+        : _index(index), _data(&index->keys), _isUnique(isUnique) {
         _currentKeySize = 0;
     }
 
@@ -160,15 +233,30 @@ public:
             return Status(ErrorCodes::KeyTooLong, msg);
         }
 
+        IndexKeyEntry entry(key.getOwned(), loc);
+        RecoveryUnit* ru = opCtx->recoveryUnit();
+        stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+
         // TODO optimization: save the iterator from the dup-check to speed up insert
-        if (!dupsAllowed && isDup(*_data, key, loc))
+        if (!dupsAllowed && isDup_inlock(*_index, ru, key, loc))
             return dupKeyError(key);
 
-        IndexKeyEntry entry(key.getOwned(), loc);
-        if (_data->insert(entry).second) {
-            _currentKeySize += key.objsize();
-            opCtx->recoveryUnit()->registerChange(new IndexChange(_data, entry, true));
+        PendingChanges::iterator pending = _index->pendingChanges.find(entry);
+        if (pending == _index->pendingChanges.end()) {
+            if (!_data->insert(entry).second)
+                return Status::OK();  // Already committed.
+            _index->pendingChanges.emplace(entry, PendingChange{ru, false, true});
+            ru->registerChange(new IndexChange(_index, entry));
+        } else {
+            if (pending->second.owner != ru)
+                throw WriteConflictException();
+            if (pending->second.present)
+                return Status::OK();
+            pending->second.present = true;
         }
+
+        _index->generation++;
+        _currentKeySize += key.objsize();
         return Status::OK();
     }
 
@@ -180,19 +268,38 @@ public:
         invariant(!hasFieldNames(key));
 
         IndexKeyEntry entry(key.getOwned(), loc);
-        const size_t numDeleted = _data->erase(entry);
-        invariant(numDeleted <= 1);
-        if (numDeleted == 1) {
-            _currentKeySize -= key.objsize();
-            opCtx->recoveryUnit()->registerChange(new IndexChange(_data, entry, false));
+        RecoveryUnit* ru = opCtx->recoveryUnit();
+        stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+
+        // The entry stays in '_data' until the unit of work ends, hidden from its own cursors.
+        PendingChanges::iterator pending = _index->pendingChanges.find(entry);
+        if (pending == _index->pendingChanges.end()) {
+            if (_data->find(entry) == _data->end())
+                return;
+            _index->pendingChanges.emplace(entry, PendingChange{ru, true, false});
+            ru->registerChange(new IndexChange(_index, entry));
+        } else {
+            if (pending->second.owner != ru)
+                throw WriteConflictException();
+            if (!pending->second.present)
+                return;
+            pending->second.present = false;
         }
+
+        _index->generation++;
+        _currentKeySize -= key.objsize();
     }
 
     virtual void fullValidate(OperationContext* opCtx,
                               long long* numKeysOut,
                               ValidateResults* fullResults) const {
         // TODO check invariants?
-        *numKeysOut = _data->size();
+        stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+        *numKeysOut = 0;
+        for (const IndexKeyEntry& entry : *_data) {
+            if (_index->isVisible_inlock(opCtx->recoveryUnit(), entry))
+                ++*numKeysOut;
+        }
     }
 
     virtual bool appendCustomStats(OperationContext* opCtx,
@@ -202,18 +309,25 @@ public:
     }
 
     virtual long long getSpaceUsedBytes(OperationContext* opCtx) const {
+        stdx::lock_guard<stdx::mutex> lk(_index->mutex);
         return _currentKeySize + (sizeof(IndexKeyEntry) * _data->size());
     }
 
     virtual Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& loc) {
         invariant(!hasFieldNames(key));
-        if (isDup(*_data, key, loc))
+        stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+        if (isDup_inlock(*_index, opCtx->recoveryUnit(), key, loc))
             return dupKeyError(key);
         return Status::OK();
     }
 
     virtual bool isEmpty(OperationContext* opCtx) {
-        return _data->empty();
+        stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+        for (const IndexKeyEntry& entry : *_data) {
+            if (_index->isVisible_inlock(opCtx->recoveryUnit(), entry))
+                return false;
+        }
+        return true;
     }
 
     virtual Status touch(OperationContext* opCtx) const {
@@ -223,14 +337,18 @@ public:
 
     class Cursor final : public SortedDataInterface::Cursor {
     public:
-        Cursor(OperationContext* opCtx, const IndexSet& data, bool isForward, bool isUnique)
+        Cursor(OperationContext* opCtx, IndexData& index, bool isForward, bool isUnique)
             : _opCtx(opCtx),
-              _data(data),
+              _index(index),
+              _data(index.keys),
               _forward(isForward),
               _isUnique(isUnique),
-              _it(data.end()) {}
+              _it(_data.end()) {}
 
         boost::optional<IndexKeyEntry> next(RequestedInfo parts) override {
+            stdx::lock_guard<stdx::mutex> lk(_index.mutex);
+            refreshPosition();
+
             if (_lastMoveWasRestore) {
                 // Return current position rather than advancing.
                 _lastMoveWasRestore = false;
@@ -239,13 +357,18 @@ public:
                 if (atEndPoint())
                     _isEOF = true;
             }
+            skipInvisible();
 
+            notePosition();
             if (_isEOF)
                 return {};
-            return *_it;
+            return _position;
         }
 
         void setEndPosition(const BSONObj& key, bool inclusive) override {
+            stdx::lock_guard<stdx::mutex> lk(_index.mutex);
+            refreshPosition();
+
             if (key.isEmpty()) {
                 // This means scan to end of index.
                 _endState = boost::none;
@@ -262,40 +385,51 @@ public:
         boost::optional<IndexKeyEntry> seek(const BSONObj& key,
                                             bool inclusive,
                                             RequestedInfo parts) override {
+            stdx::lock_guard<stdx::mutex> lk(_index.mutex);
+            refreshPosition();
+
             if (key.isEmpty()) {
                 _it = inclusive ? _data.begin() : _data.end();
                 _isEOF = (_it == _data.end());
+                skipInvisible();
+                notePosition();
                 if (_isEOF) {
                     return {};
                 }
             } else {
                 const BSONObj query = stripFieldNames(key);
                 locate(query, _forward == inclusive ? RecordId::min() : RecordId::max());
+                skipInvisible();
                 _lastMoveWasRestore = false;
+                notePosition();
                 if (_isEOF)
                     return {};
                 dassert(inclusive ? compareKeys(_it->key, query) >= 0
                                   : compareKeys(_it->key, query) > 0);
             }
 
-            return *_it;
+            return _position;
         }
 
         boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
                                             RequestedInfo parts) override {
             // Query encodes exclusive case so it can be treated as an inclusive query.
             const BSONObj query = IndexEntryComparison::makeQueryObject(seekPoint, _forward);
+            stdx::lock_guard<stdx::mutex> lk(_index.mutex);
+            refreshPosition();
+
             locate(query, _forward ? RecordId::min() : RecordId::max());
+            skipInvisible();
             _lastMoveWasRestore = false;
+            notePosition();
             if (_isEOF)
                 return {};
             dassert(compareKeys(_it->key, query) >= 0);
-            return *_it;
+            return _position;
         }
 
         void save() override {
             // Keep original position if we haven't moved since the last restore.
-            _opCtx = nullptr;
             if (_lastMoveWasRestore)
                 return;
 
@@ -304,9 +438,11 @@ public:
                 return;
             }
 
+            // Use the remembered position since _it may already have been invalidated by another
+            // operation.
             _savedAtEnd = false;
-            _savedKey = _it->key.getOwned();
-            _savedLoc = _it->loc;
+            _savedKey = _position.key.getOwned();
+            _savedLoc = _position.loc;
             // Doing nothing with end cursor since it will do full reseek on restore.
         }
 
@@ -316,18 +452,35 @@ public:
         }
 
         void restore() override {
-            // Always do a full seek on restore. We cannot use our last position since index
-            // entries may have been inserted closer to our endpoint and we would need to move
-            // over them.
-            seekEndCursor();
+            stdx::lock_guard<stdx::mutex> lk(_index.mutex);
 
             if (_savedAtEnd) {
+                seekEndCursor();
                 _isEOF = true;
+                notePosition();
                 return;
             }
 
+            restorePosition(_savedKey, _savedLoc);
+        }
+
+        void detachFromOperationContext() final {
+            _opCtx = nullptr;
+        }
+
+        void reattachToOperationContext(OperationContext* opCtx) final {
+            _opCtx = opCtx;
+        }
+
+    private:
+        void restorePosition(const BSONObj& savedKey, const RecordId& savedLoc) {
+            // Always do a full seek on restore. We cannot use our last position since index
+            // entries may have been inserted closer to our endpoint and we would need to move
+            // over them.
+            seekEndCursor();
+
             // Need to find our position from the root.
-            locate(_savedKey, _savedLoc);
+            locate(savedKey, savedLoc);
 
             _lastMoveWasRestore = _isEOF;  // We weren't EOF but now are.
             if (!_lastMoveWasRestore) {
@@ -337,21 +490,46 @@ public:
                 // Cursors for unique indices should never return the same key twice, so we don't
                 // consider the restore as having moved the cursor position if the record id
                 // changes. In this case we use a null record id so that only the keys are compared.
-                auto savedLocToUse = _isUnique ? RecordId() : _savedLoc;
+                auto savedLocToUse = _isUnique ? RecordId() : savedLoc;
                 _lastMoveWasRestore =
-                    (_data.value_comp().compare(*_it, {_savedKey, savedLocToUse}) != 0);
+                    (_data.value_comp().compare(*_it, {savedKey, savedLocToUse}) != 0);
             }
+            notePosition();
         }
 
-        void detachFromOperationContext() final {
-            _opCtx = nullptr;
+        // Remembers the entry _it is on, so that we can find our way back if another operation
+        // changes the index and invalidates _it.
+        void notePosition() {
+            _generation = _index.generation;
+            if (!_isEOF)
+                _position = *_it;
         }
 
-        void reattachToOperationContext(OperationContext* opCtx) final {
-            _opCtx = opCtx;
+        // If the index has changed since we were positioned, _it and the end cursor may be
+        // invalid. Re-find them the same way restore() would, keeping any pending restore.
+        void refreshPosition() {
+            if (_generation == _index.generation)
+                return;
+
+            if (_isEOF) {
+                seekEndCursor();
+                notePosition();
+                return;
+            }
+
+            const bool lastMoveWasRestore = _lastMoveWasRestore;
+            const IndexKeyEntry position = _position;
+            restorePosition(position.key, position.loc);
+            _lastMoveWasRestore = _lastMoveWasRestore || lastMoveWasRestore;
+        }
+
+        // Moves past entries that the unit of work of the cursor's operation does not see: entries
+        // it removed and entries other units of work inserted without committing yet.
+        void skipInvisible() {
+            while (!_isEOF && !_index.isVisible_inlock(_opCtx->recoveryUnit(), *_it))
+                advance();
         }
 
-    private:
         bool atEndPoint() const {
             return _endState && _it == _endState->it;
         }
@@ -445,12 +623,17 @@ public:
         }
 
         OperationContext* _opCtx;  // not owned
+        IndexData& _index;
         const IndexSet& _data;
         const bool _forward;
         const bool _isUnique;
         bool _isEOF = true;
         IndexSet::const_iterator _it;
 
+        // The entry _it is on as of _generation. Only meaningful if !_isEOF.
+        IndexKeyEntry _position{BSONObj(), RecordId()};
+        uint64_t _generation = 0;
+
         struct EndState {
             EndState(BSONObj key, RecordId loc) : query(std::move(key), loc) {}
 
@@ -472,7 +655,7 @@ public:
 
     virtual std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* opCtx,
                                                                    bool isForward) const {
-        return stdx::make_unique<Cursor>(opCtx, *_data, isForward, _isUnique);
+        return stdx::make_unique<Cursor>(opCtx, *_index, isForward, _isUnique);
     }
 
     virtual Status initAsEmpty(OperationContext* opCtx) {
@@ -481,25 +664,28 @@ public:
     }
 
 private:
+    // Ends the pending change to an entry. Only the first change to an entry in a unit of work
+    // registers one.
     class IndexChange : public RecoveryUnit::Change {
     public:
-        IndexChange(IndexSet* data, const IndexKeyEntry& entry, bool insert)
-            : _data(data), _entry(entry), _insert(insert) {}
+        IndexChange(IndexData* index, const IndexKeyEntry& entry) : _index(index), _entry(entry) {}
+
+        virtual void commit() {
+            stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+            _index->endPendingChange_inlock(_entry, true);
+        }
 
-        virtual void commit() {}
         virtual void rollback() {
-            if (_insert)
-                _data->erase(_entry);
-            else
-                _data->insert(_entry);
+            stdx::lock_guard<stdx::mutex> lk(_index->mutex);
+            _index->endPendingChange_inlock(_entry, false);
         }
 
     private:
-        IndexSet* _data;
+        IndexData* _index;
         const IndexKeyEntry _entry;
-        const bool _insert;
     };
 
+    IndexData* _index;
     IndexSet* _data;
     long long _currentKeySize;
     const bool _isUnique;
@@ -513,9 +699,9 @@ SortedDataInterface* getEphemeralForTestBtreeImpl(const Ordering& ordering,
                                                   std::shared_ptr<void>* dataInOut) {
     invariant(dataInOut);
     if (!*dataInOut) {
-        *dataInOut = std::make_shared<IndexSet>(IndexEntryComparison(ordering));
+        *dataInOut = std::make_shared<IndexData>(ordering);
     }
-    return new EphemeralForTestBtreeImpl(static_cast<IndexSet*>(dataInOut->get()), isUnique);
+    return new EphemeralForTestBtreeImpl(static_cast<IndexData*>(dataInOut->get()), isUnique);
 }
 
 }  // namespace mongo
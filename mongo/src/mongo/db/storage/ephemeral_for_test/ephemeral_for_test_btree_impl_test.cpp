@@ -32,6 +32,8 @@
 
 
 #include "mongo/base/init.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 #include "mongo/stdx/memory.h"
@@ -67,5 +69,81 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+long long numKeys(OperationContext* opCtx, SortedDataInterface* sorted) {
+    long long numKeys = 0;
+    sorted->fullValidate(opCtx, &numKeys, nullptr);
+    return numKeys;
+}
+
+TEST(EphemeralForTestBtreeImplTest, UncommittedInsertOfUniqueKeyConflicts) {
+    EphemeralForBtreeImplTestHarnessHelper harness;
+    auto sorted = harness.newSortedDataInterface(true);
+    auto otherClient = harness.serviceContext()->makeClient("other");
+    const BSONObj key = BSON("" << 1);
+
+    auto opCtx = harness.newOperationContext();
+    auto otherOpCtx = harness.newOperationContext(otherClient.get());
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(sorted->insert(opCtx.get(), key, RecordId(1), false));
+
+        // Whether the other insert is a duplicate depends on whether the first one commits.
+        WriteUnitOfWork otherWuow(otherOpCtx.get());
+        ASSERT_THROWS(sorted->insert(otherOpCtx.get(), key, RecordId(2), false),
+                      WriteConflictException);
+        ASSERT_THROWS(sorted->dupKeyCheck(otherOpCtx.get(), key, RecordId(2)),
+                      WriteConflictException);
+
+        // Only the writer sees its entry.
+        ASSERT(sorted->newCursor(opCtx.get())->seek(key, true));
+        ASSERT_FALSE(sorted->newCursor(otherOpCtx.get())->seek(key, true));
+        ASSERT_EQUALS(0, numKeys(otherOpCtx.get(), sorted.get()));
+        wuow.commit();
+    }
+
+    WriteUnitOfWork otherWuow(otherOpCtx.get());
+    ASSERT_EQUALS(ErrorCodes::DuplicateKey,
+                  sorted->insert(otherOpCtx.get(), key, RecordId(2), false));
+    ASSERT_EQUALS(1, numKeys(otherOpCtx.get(), sorted.get()));
+}
+
+TEST(EphemeralForTestBtreeImplTest, RolledBackUnindexDoesNotDuplicateUniqueKey) {
+    EphemeralForBtreeImplTestHarnessHelper harness;
+    auto sorted = harness.newSortedDataInterface(true);
+    auto otherClient = harness.serviceContext()->makeClient("other");
+    const BSONObj key = BSON("" << 1);
+
+    auto opCtx = harness.newOperationContext();
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(sorted->insert(opCtx.get(), key, RecordId(1), false));
+        wuow.commit();
+    }
+
+    auto otherOpCtx = harness.newOperationContext(otherClient.get());
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        sorted->unindex(opCtx.get(), key, RecordId(1), false);
+        ASSERT_FALSE(sorted->newCursor(opCtx.get())->seek(key, true));
+        ASSERT(sorted->newCursor(otherOpCtx.get())->seek(key, true));
+
+        WriteUnitOfWork otherWuow(otherOpCtx.get());
+        ASSERT_THROWS(sorted->insert(otherOpCtx.get(), key, RecordId(2), false),
+                      WriteConflictException);
+
+        // Roll back.
+    }
+
+    ASSERT_EQUALS(1, numKeys(opCtx.get(), sorted.get()));
+    WriteUnitOfWork otherWuow(otherOpCtx.get());
+    ASSERT_EQUALS(ErrorCodes::DuplicateKey,
+                  sorted->insert(otherOpCtx.get(), key, RecordId(2), false));
+    auto cursor = sorted->newCursor(otherOpCtx.get());
+    auto entry = cursor->seek(key, true);
+    ASSERT(entry);
+    ASSERT_EQUALS(RecordId(1), entry->loc);
+    ASSERT_FALSE(cursor->next());
+}
 }  // namespace
 }  // namespace mongo
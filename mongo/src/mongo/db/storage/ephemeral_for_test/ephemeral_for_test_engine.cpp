@@ -36,17 +36,29 @@
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_btree_impl.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
 
+namespace {
+
+// Lets the query layer run with document-level locking on top of in-memory storage, e.g. to
+// benchmark it without I/O. Records and index entries are then written concurrently, with write
+// conflicts detected per record.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ephemeralForTestDocumentLocking, bool, false);
+
+}  // namespace
+
 RecoveryUnit* EphemeralForTestEngine::newRecoveryUnit() {
-    return new EphemeralForTestRecoveryUnit([this]() {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        JournalListener::Token token = _journalListener->getToken();
-        _journalListener->onDurable(token);
-    });
+    return new EphemeralForTestRecoveryUnit(
+        [this]() {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            JournalListener::Token token = _journalListener->getToken();
+            _journalListener->onDurable(token);
+        },
+        ephemeralForTestDocumentLocking);
 }
 
 Status EphemeralForTestEngine::createRecordStore(OperationContext* opCtx,
@@ -99,6 +111,10 @@ Status EphemeralForTestEngine::dropIdent(OperationContext* opCtx, StringData ide
     return Status::OK();
 }
 
+bool EphemeralForTestEngine::supportsDocLocking() const {
+    return ephemeralForTestDocumentLocking;
+}
+
 int64_t EphemeralForTestEngine::getIdentSize(OperationContext* opCtx, StringData ident) {
     return 1;
 }
@@ -71,9 +71,11 @@ public:
 
     virtual Status dropIdent(OperationContext* opCtx, StringData ident);
 
-    virtual bool supportsDocLocking() const {
-        return false;
-    }
+    /**
+     * Collection-level locking is the default. Document-level locking is enabled at startup with
+     * the ephemeralForTestDocumentLocking server parameter.
+     */
+    virtual bool supportsDocLocking() const;
 
     virtual bool supportsDirectoryPerDB() const {
         return false;
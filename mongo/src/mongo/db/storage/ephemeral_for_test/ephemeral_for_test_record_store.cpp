@@ -33,9 +33,11 @@
 
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/stdx/memory.h"
@@ -47,11 +49,24 @@ namespace mongo {
 
 using std::shared_ptr;
 
+namespace {
+
+// Returns null for recovery units of other engines, such as devnull, that keep their oplog here.
+EphemeralForTestRecoveryUnit* getEphemeralRecoveryUnit(OperationContext* opCtx) {
+    return dynamic_cast<EphemeralForTestRecoveryUnit*>(opCtx->recoveryUnit());
+}
+
+}  // namespace
+
 class EphemeralForTestRecordStore::InsertChange : public RecoveryUnit::Change {
 public:
     InsertChange(OperationContext* opCtx, Data* data, RecordId loc)
         : _opCtx(opCtx), _data(data), _loc(loc) {}
-    virtual void commit() {}
+    virtual void commit() {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
+        _data->markCommitted_inlock(_opCtx, _loc);
+        _data->endPendingWrite_inlock(_loc);
+    }
     virtual void rollback() {
         stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
 
@@ -59,7 +74,9 @@ public:
         if (it != _data->records.end()) {
             _data->dataSize -= it->second.size;
             _data->records.erase(it);
+            _data->eraseGeneration++;
         }
+        _data->endPendingWrite_inlock(_loc);
     }
 
 private:
@@ -74,10 +91,18 @@ public:
     RemoveChange(OperationContext* opCtx,
                  Data* data,
                  RecordId loc,
-                 const EphemeralForTestRecord& rec)
-        : _opCtx(opCtx), _data(data), _loc(loc), _rec(rec) {}
+                 const EphemeralForTestRecord& rec,
+                 bool endsPendingWrite)
+        : _opCtx(opCtx), _data(data), _loc(loc), _rec(rec), _endsPendingWrite(endsPendingWrite) {}
 
-    virtual void commit() {}
+    virtual void commit() {
+        if (!_endsPendingWrite)
+            return;
+
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
+        _data->markCommitted_inlock(_opCtx, _loc);
+        _data->endPendingWrite_inlock(_loc);
+    }
     virtual void rollback() {
         stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
 
@@ -88,6 +113,9 @@ public:
 
         _data->dataSize += _rec.size;
         _data->records[_loc] = _rec;
+
+        if (_endsPendingWrite)
+            _data->endPendingWrite_inlock(_loc);
     }
 
 private:
@@ -95,6 +123,11 @@ private:
     Data* const _data;
     const RecordId _loc;
     const EphemeralForTestRecord _rec;
+
+    // Only the change for the first write to a record in a unit of work ends the pending write,
+    // since rolling back later writes must not let other units of work in before this one is
+    // done restoring the record.
+    const bool _endsPendingWrite;
 };
 
 class EphemeralForTestRecordStore::TruncateChange : public RecoveryUnit::Change {
@@ -105,6 +138,7 @@ public:
         stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
         swap(_dataSize, _data->dataSize);
         swap(_records, _data->records);
+        _data->eraseGeneration++;
     }
 
     virtual void commit() {}
@@ -114,6 +148,7 @@ public:
         stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
         swap(_dataSize, _data->dataSize);
         swap(_records, _data->records);
+        _data->eraseGeneration++;
     }
 
 private:
@@ -123,37 +158,77 @@ private:
     Records _records;
 };
 
+/**
+ * Cursors take the records mutex for each call rather than for their lifetime, so other
+ * operations may write to the store between calls. Inserting into a std::map invalidates no
+ * iterators, but erasing does, so the cursors remember the id they are positioned on and re-find
+ * it whenever Data::eraseGeneration has moved.
+ */
 class EphemeralForTestRecordStore::Cursor final : public SeekableRecordCursor {
 public:
     Cursor(OperationContext* opCtx, const EphemeralForTestRecordStore& rs)
-        : _records(rs._data->records), _isCapped(rs.isCapped()) {}
+        : _opCtx(opCtx),
+          _data(*rs._data),
+          _records(rs._data->records),
+          _isCapped(rs.isCapped()),
+          _it(_records.end()) {}
 
     boost::optional<Record> next() final {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data.recordsMutex);
+
+        Records::const_iterator it;
         if (_needFirstSeek) {
-            _needFirstSeek = false;
-            _it = _records.begin();
-        } else if (!_lastMoveWasRestore && _it != _records.end()) {
-            ++_it;
+            it = _records.begin();
+        } else {
+            refreshPosition();
+            it = _it;
+            if (!_lastMoveWasRestore && it != _records.end())
+                ++it;
         }
+
+        const EphemeralForTestRecord* rec = nullptr;
+        for (; it != _records.end(); ++it) {
+            if (_isCapped && _data.isUncommittedInsert_inlock(_opCtx->recoveryUnit(), it)) {
+                // Capped cursors must not skip over a record that may still commit, since readers
+                // such as oplog tailers rely on seeing records in order. Report EOF without moving
+                // so that the next call tries again from here.
+                return {};
+            }
+            if ((rec = _data.visibleVersion_inlock(_opCtx->recoveryUnit(), it)))
+                break;
+        }
+
+        _needFirstSeek = false;
         _lastMoveWasRestore = false;
+        setPosition(it);
 
-        if (_it == _records.end())
+        if (it == _records.end())
             return {};
-        return {{_it->first, _it->second.toRecordData()}};
+        return {{it->first, rec->toRecordData()}};
     }
 
     boost::optional<Record> seekExact(const RecordId& id) final {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data.recordsMutex);
+
         _lastMoveWasRestore = false;
         _needFirstSeek = false;
-        _it = _records.find(id);
-        if (_it == _records.end())
+
+        Records::const_iterator it = _records.find(id);
+        const EphemeralForTestRecord* rec = it == _records.end()
+            ? nullptr
+            : _data.visibleVersion_inlock(_opCtx->recoveryUnit(), it);
+        if (!rec) {
+            setPosition(_records.end());
             return {};
-        return {{_it->first, _it->second.toRecordData()}};
+        }
+
+        setPosition(it);
+        return {{it->first, rec->toRecordData()}};
     }
 
     void save() final {
         if (!_needFirstSeek && !_lastMoveWasRestore)
-            _savedId = _it == _records.end() ? RecordId() : _it->first;
+            _savedId = _id;
     }
 
     void saveUnpositioned() final {
@@ -161,72 +236,125 @@ public:
     }
 
     bool restore() final {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data.recordsMutex);
+
         if (_savedId.isNull()) {
-            _it = _records.end();
+            setPosition(_records.end());
             return true;
         }
 
-        _it = _records.lower_bound(_savedId);
-        _lastMoveWasRestore = _it == _records.end() || _it->first != _savedId;
+        Records::const_iterator it = _records.lower_bound(_savedId);
+        setPosition(it);
+        _lastMoveWasRestore = it == _records.end() || it->first != _savedId;
 
         // Capped iterators die on invalidation rather than advancing.
         return !(_isCapped && _lastMoveWasRestore);
     }
 
-    void detachFromOperationContext() final {}
-    void reattachToOperationContext(OperationContext* opCtx) final {}
+    void detachFromOperationContext() final {
+        _opCtx = nullptr;
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _opCtx = opCtx;
+    }
 
 private:
+    void setPosition(Records::const_iterator it) {
+        _it = it;
+        _id = it == _records.end() ? RecordId() : it->first;
+        _generation = _data.eraseGeneration;
+    }
+
+    // Re-finds _it if records have been erased since it was positioned. If the record it was on
+    // is gone, moves to the following one and treats it like a restore to a new position.
+    void refreshPosition() {
+        if (_generation == _data.eraseGeneration)
+            return;
+
+        const RecordId id = _id;
+        if (id.isNull()) {
+            setPosition(_records.end());
+            return;
+        }
+
+        setPosition(_records.lower_bound(id));
+        if (_id != id)
+            _lastMoveWasRestore = true;
+    }
+
+    OperationContext* _opCtx;
+    Data& _data;
+    const EphemeralForTestRecordStore::Records& _records;
+    const bool _isCapped;
+
     Records::const_iterator _it;
+    RecordId _id;  // The id _it is on. Null means EOF.
+    uint64_t _generation = 0;
     bool _needFirstSeek = true;
     bool _lastMoveWasRestore = false;
     RecordId _savedId;  // Location to restore() to. Null means EOF.
-
-    const EphemeralForTestRecordStore::Records& _records;
-    const bool _isCapped;
 };
 
 class EphemeralForTestRecordStore::ReverseCursor final : public SeekableRecordCursor {
 public:
     ReverseCursor(OperationContext* opCtx, const EphemeralForTestRecordStore& rs)
-        : _records(rs._data->records), _isCapped(rs.isCapped()) {}
+        : _opCtx(opCtx),
+          _data(*rs._data),
+          _records(rs._data->records),
+          _isCapped(rs.isCapped()),
+          _it(_records.end()) {}
 
     boost::optional<Record> next() final {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data.recordsMutex);
+
+        Records::const_iterator it;
         if (_needFirstSeek) {
-            _needFirstSeek = false;
-            _it = _records.rbegin();
-        } else if (!_lastMoveWasRestore && _it != _records.rend()) {
-            ++_it;
+            it = _records.empty() ? _records.end() : std::prev(_records.end());
+        } else {
+            refreshPosition();
+            it = _it;
+            if (!_lastMoveWasRestore && it != _records.end())
+                it = previous(it);
         }
+
+        const EphemeralForTestRecord* rec = nullptr;
+        for (; it != _records.end(); it = previous(it)) {
+            if ((rec = _data.visibleVersion_inlock(_opCtx->recoveryUnit(), it)))
+                break;
+        }
+
+        _needFirstSeek = false;
         _lastMoveWasRestore = false;
+        setPosition(it);
 
-        if (_it == _records.rend())
+        if (it == _records.end())
             return {};
-        return {{_it->first, _it->second.toRecordData()}};
+        return {{it->first, rec->toRecordData()}};
     }
 
     boost::optional<Record> seekExact(const RecordId& id) final {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data.recordsMutex);
+
         _lastMoveWasRestore = false;
         _needFirstSeek = false;
 
-        auto forwardIt = _records.find(id);
-        if (forwardIt == _records.end()) {
-            _it = _records.rend();
+        Records::const_iterator it = _records.find(id);
+        const EphemeralForTestRecord* rec = it == _records.end()
+            ? nullptr
+            : _data.visibleVersion_inlock(_opCtx->recoveryUnit(), it);
+        if (!rec) {
+            setPosition(_records.end());
             return {};
         }
 
-        // The reverse_iterator will point to the preceding element, so increment the base
-        // iterator to make it point past the found element.
-        ++forwardIt;
-        _it = Records::const_reverse_iterator(forwardIt);
-        dassert(_it != _records.rend());
-        dassert(_it->first == id);
-        return {{_it->first, _it->second.toRecordData()}};
+        setPosition(it);
+        return {{it->first, rec->toRecordData()}};
     }
 
     void save() final {
         if (!_needFirstSeek && !_lastMoveWasRestore)
-            _savedId = _it == _records.rend() ? RecordId() : _it->first;
+            _savedId = _id;
     }
 
     void saveUnpositioned() final {
@@ -234,33 +362,113 @@ public:
     }
 
     bool restore() final {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data.recordsMutex);
+
         if (_savedId.isNull()) {
-            _it = _records.rend();
+            setPosition(_records.end());
             return true;
         }
 
-        // Note: upper_bound returns the first entry > _savedId and reverse_iterators
-        // dereference to the element before their base iterator. This combine to make this
-        // dereference to the first element <= _savedId which is what we want here.
-        _it = Records::const_reverse_iterator(_records.upper_bound(_savedId));
-        _lastMoveWasRestore = _it == _records.rend() || _it->first != _savedId;
+        // upper_bound returns the first entry > _savedId, so the entry before it is the first
+        // one <= _savedId in the direction of the scan.
+        Records::const_iterator it = previous(_records.upper_bound(_savedId));
+        setPosition(it);
+        _lastMoveWasRestore = it == _records.end() || it->first != _savedId;
 
         // Capped iterators die on invalidation rather than advancing.
         return !(_isCapped && _lastMoveWasRestore);
     }
 
-    void detachFromOperationContext() final {}
-    void reattachToOperationContext(OperationContext* opCtx) final {}
+    void detachFromOperationContext() final {
+        _opCtx = nullptr;
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _opCtx = opCtx;
+    }
 
 private:
-    Records::const_reverse_iterator _it;
+    // Returns the record before 'it', using end() as the position before the first record. Unlike
+    // a reverse_iterator, the result stays on the same record when another operation inserts
+    // after it.
+    Records::const_iterator previous(Records::const_iterator it) const {
+        if (it == _records.begin())
+            return _records.end();
+        return std::prev(it);
+    }
+
+    void setPosition(Records::const_iterator it) {
+        _it = it;
+        _id = it == _records.end() ? RecordId() : it->first;
+        _generation = _data.eraseGeneration;
+    }
+
+    // Re-finds _it if records have been erased since it was positioned. If the record it was on
+    // is gone, moves to the preceding one and treats it like a restore to a new position.
+    void refreshPosition() {
+        if (_generation == _data.eraseGeneration)
+            return;
+
+        const RecordId id = _id;
+        if (id.isNull()) {
+            setPosition(_records.end());
+            return;
+        }
+
+        setPosition(previous(_records.upper_bound(id)));
+        if (_id != id)
+            _lastMoveWasRestore = true;
+    }
+
+    OperationContext* _opCtx;
+    Data& _data;
+    const EphemeralForTestRecordStore::Records& _records;
+    const bool _isCapped;
+
+    Records::const_iterator _it;
+    RecordId _id;  // The id _it is on. Null means EOF.
+    uint64_t _generation = 0;
     bool _needFirstSeek = true;
     bool _lastMoveWasRestore = false;
     RecordId _savedId;  // Location to restore() to. Null means EOF.
-    const EphemeralForTestRecordStore::Records& _records;
-    const bool _isCapped;
 };
 
+//
+// Data
+//
+
+const EphemeralForTestRecordStore::EphemeralForTestRecord*
+EphemeralForTestRecordStore::Data::visibleVersion_inlock(const RecoveryUnit* reader,
+                                                         Records::const_iterator it) const {
+    PendingWrites::const_iterator pending = pendingWrites.find(it->first);
+    if (pending == pendingWrites.end() || pending->second.owner == reader)
+        return &it->second;
+    return pending->second.committed.get_ptr();
+}
+
+bool EphemeralForTestRecordStore::Data::isUncommittedInsert_inlock(
+    const RecoveryUnit* reader, Records::const_iterator it) const {
+    PendingWrites::const_iterator pending = pendingWrites.find(it->first);
+    return pending != pendingWrites.end() && pending->second.owner != reader &&
+        !pending->second.committed;
+}
+
+void EphemeralForTestRecordStore::Data::endPendingWrite_inlock(const RecordId& loc) {
+    if (pendingWrites.erase(loc))
+        pendingWriteEnded.notify_all();
+}
+
+void EphemeralForTestRecordStore::Data::markCommitted_inlock(OperationContext* opCtx,
+                                                             const RecordId& loc) {
+    EphemeralForTestRecoveryUnit* ru = getEphemeralRecoveryUnit(opCtx);
+    if (!ru)
+        return;
+
+    Records::iterator it = records.find(loc);
+    if (it != records.end())
+        it->second.committedAt = ru->getCommitNumber();
+}
+
 
 //
 // RecordStore
@@ -299,7 +507,25 @@ const char* EphemeralForTestRecordStore::name() const {
 RecordData EphemeralForTestRecordStore::dataFor(OperationContext* opCtx,
                                                 const RecordId& loc) const {
     stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
-    return recordFor(loc)->toRecordData();
+
+    Records::const_iterator it = _data->records.find(loc);
+    if (it == _data->records.end()) {
+        // Another unit of work may have deleted the record without committing yet.
+        PendingWrites::const_iterator pending = _data->pendingWrites.find(loc);
+        if (pending != _data->pendingWrites.end() &&
+            pending->second.owner != opCtx->recoveryUnit() && pending->second.committed) {
+            return pending->second.committed->toRecordData();
+        }
+        return recordFor(loc)->toRecordData();
+    }
+
+    const EphemeralForTestRecord* rec = _data->visibleVersion_inlock(opCtx->recoveryUnit(), it);
+    if (!rec) {
+        // The record was inserted by another unit of work that has not committed yet, so it
+        // must not be handed out until that unit of work ends.
+        throw WriteConflictException();
+    }
+    return rec->toRecordData();
 }
 
 const EphemeralForTestRecordStore::EphemeralForTestRecord* EphemeralForTestRecordStore::recordFor(
@@ -333,7 +559,12 @@ bool EphemeralForTestRecordStore::findRecord(OperationContext* opCtx,
     if (it == _data->records.end()) {
         return false;
     }
-    *rd = it->second.toRecordData();
+
+    const EphemeralForTestRecord* rec = _data->visibleVersion_inlock(opCtx->recoveryUnit(), it);
+    if (!rec) {
+        return false;
+    }
+    *rd = rec->toRecordData();
     return true;
 }
 
@@ -345,10 +576,44 @@ void EphemeralForTestRecordStore::deleteRecord(OperationContext* opCtx, const Re
 
 void EphemeralForTestRecordStore::deleteRecord_inlock(OperationContext* opCtx,
                                                       const RecordId& loc) {
-    EphemeralForTestRecord* rec = recordFor(loc);
-    opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *rec));
+    EphemeralForTestRecord* rec = recordForWrite_inlock(opCtx, loc);
+    const bool endsPendingWrite = beginWrite_inlock(opCtx, loc, *rec);
+    opCtx->recoveryUnit()->registerChange(
+        new RemoveChange(opCtx, _data, loc, *rec, endsPendingWrite));
     _data->dataSize -= rec->size;
     invariant(_data->records.erase(loc) == 1);
+    _data->eraseGeneration++;
+}
+
+bool EphemeralForTestRecordStore::beginWrite_inlock(OperationContext* opCtx,
+                                                    const RecordId& loc,
+                                                    const EphemeralForTestRecord& committed) {
+    PendingWrites::const_iterator pending = _data->pendingWrites.find(loc);
+    if (pending != _data->pendingWrites.end()) {
+        if (pending->second.owner != opCtx->recoveryUnit())
+            throw WriteConflictException();
+        return false;
+    }
+
+    // The unit of work may have read the record before another one committed a newer version,
+    // so writing it now would lose that update.
+    EphemeralForTestRecoveryUnit* ru = getEphemeralRecoveryUnit(opCtx);
+    if (ru && ru->detectsWriteConflicts() && committed.committedAt > ru->getSnapshotCommitNumber())
+        throw WriteConflictException();
+
+    _data->pendingWrites.emplace(loc, PendingWrite{opCtx->recoveryUnit(), committed});
+    return true;
+}
+
+EphemeralForTestRecordStore::EphemeralForTestRecord*
+EphemeralForTestRecordStore::recordForWrite_inlock(OperationContext* opCtx, const RecordId& loc) {
+    // Without write conflict detection, callers hold locks that keep the record from going away.
+    EphemeralForTestRecoveryUnit* ru = getEphemeralRecoveryUnit(opCtx);
+    if (ru && ru->detectsWriteConflicts() &&
+        _data->records.find(loc) == _data->records.end()) {
+        throw WriteConflictException();
+    }
+    return recordFor(loc);
 }
 
 bool EphemeralForTestRecordStore::cappedAndNeedDelete_inlock(OperationContext* opCtx) const {
@@ -420,6 +685,7 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(
     }
 
     opCtx->recoveryUnit()->registerChange(new InsertChange(opCtx, _data, loc));
+    _data->pendingWrites.emplace(loc, PendingWrite{opCtx->recoveryUnit(), boost::none});
     _data->dataSize += len;
     _data->records[loc] = rec;
 
@@ -457,6 +723,7 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
         }
 
         opCtx->recoveryUnit()->registerChange(new InsertChange(opCtx, _data, loc));
+        _data->pendingWrites.emplace(loc, PendingWrite{opCtx->recoveryUnit(), boost::none});
         _data->dataSize += len;
         _data->records[loc] = rec;
 
@@ -476,17 +743,21 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* opCtx,
                                                  bool enforceQuota,
                                                  UpdateNotifier* notifier) {
     stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
-    EphemeralForTestRecord* oldRecord = recordFor(loc);
+    EphemeralForTestRecord* oldRecord = recordForWrite_inlock(opCtx, loc);
     int oldLen = oldRecord->size;
 
     // Documents in capped collections cannot change size. We check that above the storage layer.
     invariant(!_isCapped || len == oldLen);
 
+    const bool endsPendingWrite = beginWrite_inlock(opCtx, loc, *oldRecord);
+
     if (notifier) {
-        // The in-memory KV engine uses the invalidation framework (does not support
-        // doc-locking), and therefore must notify that it is updating a document.
+        // Unless document-level locking is enabled, the in-memory KV engine uses the
+        // invalidation framework, and therefore must notify that it is updating a document.
         Status callbackStatus = notifier->recordStoreGoingToUpdateInPlace(opCtx, loc);
         if (!callbackStatus.isOK()) {
+            if (endsPendingWrite)
+                _data->endPendingWrite_inlock(loc);
             return callbackStatus;
         }
     }
@@ -494,7 +765,8 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* opCtx,
     EphemeralForTestRecord newRecord(len);
     memcpy(newRecord.data.get(), data, len);
 
-    opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *oldRecord));
+    opCtx->recoveryUnit()->registerChange(
+        new RemoveChange(opCtx, _data, loc, *oldRecord, endsPendingWrite));
     _data->dataSize += len - oldLen;
     *oldRecord = newRecord;
 
@@ -515,17 +787,14 @@ StatusWith<RecordData> EphemeralForTestRecordStore::updateWithDamages(
 
     stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
 
-    EphemeralForTestRecord* oldRecord = recordFor(loc);
+    EphemeralForTestRecord* oldRecord = recordForWrite_inlock(opCtx, loc);
     const int len = oldRecord->size;
 
     EphemeralForTestRecord newRecord(len);
     memcpy(newRecord.data.get(), oldRecord->data.get(), len);
 
-    opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *oldRecord));
-    *oldRecord = newRecord;
-
-    cappedDeleteAsNeeded_inlock(opCtx);
-
+    // Apply the damages before publishing the new version, since readers may pick it up as soon
+    // as it is in the map.
     char* root = newRecord.data.get();
     mutablebson::DamageVector::const_iterator where = damages.begin();
     const mutablebson::DamageVector::const_iterator end = damages.end();
@@ -535,8 +804,13 @@ StatusWith<RecordData> EphemeralForTestRecordStore::updateWithDamages(
         std::memcpy(targetPtr, sourcePtr, where->size);
     }
 
+    const bool endsPendingWrite = beginWrite_inlock(opCtx, loc, *oldRecord);
+    opCtx->recoveryUnit()->registerChange(
+        new RemoveChange(opCtx, _data, loc, *oldRecord, endsPendingWrite));
     *oldRecord = newRecord;
 
+    cappedDeleteAsNeeded_inlock(opCtx);
+
     return newRecord.toRecordData();
 }
 
@@ -568,9 +842,12 @@ void EphemeralForTestRecordStore::cappedTruncateAfter(OperationContext* opCtx,
             uassertStatusOK(_cappedCallback->aboutToDeleteCapped(opCtx, id, record.toRecordData()));
         }
 
-        opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, id, record));
+        const bool endsPendingWrite = beginWrite_inlock(opCtx, id, record);
+        opCtx->recoveryUnit()->registerChange(
+            new RemoveChange(opCtx, _data, id, record, endsPendingWrite));
         _data->dataSize -= record.size;
         _data->records.erase(it++);
+        _data->eraseGeneration++;
     }
 }
 
@@ -641,6 +918,27 @@ RecordId EphemeralForTestRecordStore::allocateLoc() {
     return out;
 }
 
+void EphemeralForTestRecordStore::waitForAllEarlierOplogWritesToBeVisible(
+    OperationContext* opCtx) const {
+    stdx::unique_lock<stdx::recursive_mutex> lock(_data->recordsMutex);
+    if (_data->records.empty())
+        return;
+
+    // Wait until every insert that was in flight when we were called has committed or rolled
+    // back. Our own uncommitted inserts are already visible to us.
+    const RecordId lastId = _data->records.rbegin()->first;
+    const RecoveryUnit* ru = opCtx->recoveryUnit();
+    _data->pendingWriteEnded.wait(lock, [&] {
+        for (auto&& pending : _data->pendingWrites) {
+            if (pending.first > lastId)
+                break;
+            if (pending.second.owner != ru && !pending.second.committed)
+                return false;
+        }
+        return true;
+    });
+}
+
 boost::optional<RecordId> EphemeralForTestRecordStore::oplogStartHack(
     OperationContext* opCtx, const RecordId& startingPosition) const {
     if (!_data->isOplog)
@@ -30,19 +30,29 @@
 
 #pragma once
 
-#include <boost/shared_array.hpp>
+#include <boost/optional.hpp>
 #include <map>
 
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
 /**
  * A RecordStore that stores all data in-memory.
  *
+ * Writes are tracked per record until their unit of work commits or rolls back, so that the
+ * store can be used with document-level locking: a second unit of work writing the same record
+ * gets a WriteConflictException, and readers in other units of work see the last committed
+ * version of a record rather than an uncommitted one. When the recovery unit detects write
+ * conflicts, so does a unit of work writing a record that was committed after its snapshot.
+ * Records are kept in reference-counted buffers, so RecordData handed out to readers stays valid
+ * after the record is overwritten.
+ *
  * @param cappedMaxSize - required if isCapped. limit uses dataSize() in this impl.
  */
 class EphemeralForTestRecordStore : public RecordStore {
@@ -112,17 +122,19 @@ public:
                                 int infoLevel = 0) const;
 
     virtual long long dataSize(OperationContext* opCtx) const {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
         return _data->dataSize;
     }
 
     virtual long long numRecords(OperationContext* opCtx) const {
+        stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
         return _data->records.size();
     }
 
     virtual boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
                                                      const RecordId& startingPosition) const;
 
-    void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const override {}
+    void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const override;
 
     virtual void updateStatsAfterRepair(OperationContext* opCtx,
                                         long long numRecords,
@@ -134,14 +146,21 @@ public:
 protected:
     struct EphemeralForTestRecord {
         EphemeralForTestRecord() : size(0) {}
-        EphemeralForTestRecord(int size) : size(size), data(new char[size]) {}
+        EphemeralForTestRecord(int size) : size(size), data(SharedBuffer::allocate(size)) {}
 
+        /**
+         * The returned RecordData shares ownership of the buffer, so it remains valid even if a
+         * concurrent writer replaces or deletes the record.
+         */
         RecordData toRecordData() const {
-            return RecordData(data.get(), size);
+            return RecordData(data, size);
         }
 
         int size;
-        boost::shared_array<char> data;
+        SharedBuffer data;
+
+        // The number of the commit that wrote this version, or zero if it is not known.
+        uint64_t committedAt = 0;
     };
 
     virtual const EphemeralForTestRecord* recordFor(const RecordId& loc) const;
@@ -171,6 +190,22 @@ private:
 
     StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len) const;
 
+    /**
+     * Records that the unit of work of 'opCtx' is about to overwrite or delete 'loc', whose
+     * current version is 'committed'. Throws WriteConflictException if another unit of work has
+     * an uncommitted write to the same record. Returns true if this is the first write to 'loc'
+     * in this unit of work, in which case the caller's change must end the pending write.
+     */
+    bool beginWrite_inlock(OperationContext* opCtx,
+                           const RecordId& loc,
+                           const EphemeralForTestRecord& committed);
+
+    /**
+     * Returns the record at 'loc' for the unit of work of 'opCtx' to overwrite or delete. Throws
+     * WriteConflictException if write conflicts are detected and another unit of work deleted it.
+     */
+    EphemeralForTestRecord* recordForWrite_inlock(OperationContext* opCtx, const RecordId& loc);
+
     RecordId allocateLoc();
     bool cappedAndNeedDelete_inlock(OperationContext* opCtx) const;
     void cappedDeleteAsNeeded_inlock(OperationContext* opCtx);
@@ -182,16 +217,60 @@ private:
     const int64_t _cappedMaxDocs;
     CappedCallback* _cappedCallback;
 
+    // A write to a record by a unit of work that has not committed yet.
+    struct PendingWrite {
+        const RecoveryUnit* owner;
+
+        // The version other units of work should see, or none if 'owner' inserted the record.
+        boost::optional<EphemeralForTestRecord> committed;
+    };
+
+    typedef std::map<RecordId, PendingWrite> PendingWrites;
+
     // This is the "persistent" data.
     struct Data {
         Data(StringData ns, bool isOplog)
             : dataSize(0), recordsMutex(), nextId(1), isOplog(isOplog) {}
 
+        /**
+         * Returns the version of the record at 'it' that the unit of work of 'reader' may see,
+         * or nullptr if it was inserted by another unit of work that has not committed yet.
+         */
+        const EphemeralForTestRecord* visibleVersion_inlock(const RecoveryUnit* reader,
+                                                            Records::const_iterator it) const;
+
+        /**
+         * Returns true if the record at 'it' was inserted by a unit of work other than the one of
+         * 'reader' that has not committed yet.
+         */
+        bool isUncommittedInsert_inlock(const RecoveryUnit* reader,
+                                        Records::const_iterator it) const;
+
+        /**
+         * Forgets the pending write to 'loc' once its unit of work commits or rolls back.
+         */
+        void endPendingWrite_inlock(const RecordId& loc);
+
+        /**
+         * Stamps the record at 'loc', if it still exists, with the number of the commit of the
+         * unit of work of 'opCtx'.
+         */
+        void markCommitted_inlock(OperationContext* opCtx, const RecordId& loc);
+
         int64_t dataSize;
         stdx::recursive_mutex recordsMutex;
         Records records;
         int64_t nextId;
         const bool isOplog;
+
+        PendingWrites pendingWrites;
+
+        // Signaled whenever a pending write ends.
+        stdx::condition_variable_any pendingWriteEnded;
+
+        // Bumped whenever records are erased, so that cursors know to re-find their position
+        // rather than use an iterator that may have been invalidated by another operation.
+        uint64_t eraseGeneration = 0;
     };
 
     Data* const _data;
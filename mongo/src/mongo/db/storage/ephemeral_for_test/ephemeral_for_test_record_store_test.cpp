@@ -33,6 +33,8 @@
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 
 #include "mongo/base/init.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/stdx/memory.h"
@@ -84,5 +86,211 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+RecordId insertString(OperationContext* opCtx, RecordStore* rs, const std::string& str) {
+    return uassertStatusOK(rs->insertRecord(opCtx, str.c_str(), str.size() + 1, Timestamp(), false));
+}
+
+// Gives 'opCtx' a recovery unit like the ones of an engine running with document-level locking.
+void detectWriteConflicts(OperationContext* opCtx) {
+    opCtx->setRecoveryUnit(new EphemeralForTestRecoveryUnit(nullptr, true),
+                           OperationContext::kNotInUnitOfWork);
+}
+
+TEST(EphemeralForTestRecordStoreTest, WritesFromBeforeAnotherCommitConflict) {
+    EphemeralForTestHarnessHelper harness;
+    auto rs = harness.newNonCappedRecordStore();
+    auto otherClient = harness.serviceContext()->makeClient("other");
+
+    auto opCtx = harness.newOperationContext();
+    detectWriteConflicts(opCtx.get());
+    std::vector<RecordId> locs;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        locs.push_back(insertString(opCtx.get(), rs.get(), "a"));
+        locs.push_back(insertString(opCtx.get(), rs.get(), "a"));
+        wuow.commit();
+    }
+
+    // Both operations read the records, then the first one changes them.
+    auto otherOpCtx = harness.newOperationContext(otherClient.get());
+    detectWriteConflicts(otherOpCtx.get());
+    const SnapshotId otherSnapshotId = otherOpCtx->recoveryUnit()->getSnapshotId();
+    ASSERT_EQUALS(std::string("a"), rs->dataFor(otherOpCtx.get(), locs[0]).data());
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(opCtx.get(), locs[0], "b", 2, false, nullptr));
+        rs->deleteRecord(opCtx.get(), locs[1]);
+        wuow.commit();
+    }
+
+    // Writing what the second operation read would lose the first one's update.
+    {
+        WriteUnitOfWork otherWuow(otherOpCtx.get());
+        ASSERT_THROWS(rs->updateRecord(otherOpCtx.get(), locs[0], "c", 2, false, nullptr),
+                      WriteConflictException);
+        ASSERT_THROWS(rs->deleteRecord(otherOpCtx.get(), locs[0]), WriteConflictException);
+        ASSERT_THROWS(rs->deleteRecord(otherOpCtx.get(), locs[1]), WriteConflictException);
+    }
+
+    // A new snapshot includes the first operation's commit.
+    otherOpCtx->recoveryUnit()->abandonSnapshot();
+    ASSERT(otherSnapshotId != otherOpCtx->recoveryUnit()->getSnapshotId());
+    WriteUnitOfWork otherWuow(otherOpCtx.get());
+    ASSERT_OK(rs->updateRecord(otherOpCtx.get(), locs[0], "c", 2, false, nullptr));
+    otherWuow.commit();
+    ASSERT_EQUALS(std::string("c"), rs->dataFor(opCtx.get(), locs[0]).data());
+}
+
+TEST(EphemeralForTestRecordStoreTest, ConcurrentUpdatesOfOneRecordConflict) {
+    EphemeralForTestHarnessHelper harness;
+    auto rs = harness.newNonCappedRecordStore();
+    auto otherClient = harness.serviceContext()->makeClient("other");
+
+    auto opCtx = harness.newOperationContext();
+    RecordId loc;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        loc = insertString(opCtx.get(), rs.get(), "a");
+        wuow.commit();
+    }
+
+    auto otherOpCtx = harness.newOperationContext(otherClient.get());
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(opCtx.get(), loc, "b", 2, false, nullptr));
+
+        WriteUnitOfWork otherWuow(otherOpCtx.get());
+        ASSERT_THROWS(rs->updateRecord(otherOpCtx.get(), loc, "c", 2, false, nullptr),
+                      WriteConflictException);
+        ASSERT_THROWS(rs->deleteRecord(otherOpCtx.get(), loc), WriteConflictException);
+
+        // Writing the same record again in the same unit of work is fine.
+        ASSERT_OK(rs->updateRecord(opCtx.get(), loc, "d", 2, false, nullptr));
+        wuow.commit();
+    }
+
+    WriteUnitOfWork otherWuow(otherOpCtx.get());
+    ASSERT_OK(rs->updateRecord(otherOpCtx.get(), loc, "c", 2, false, nullptr));
+    otherWuow.commit();
+    ASSERT_EQUALS(std::string("c"), rs->dataFor(opCtx.get(), loc).data());
+}
+
+TEST(EphemeralForTestRecordStoreTest, UncommittedWritesAreOnlyVisibleToTheirWriter) {
+    EphemeralForTestHarnessHelper harness;
+    auto rs = harness.newNonCappedRecordStore();
+    auto otherClient = harness.serviceContext()->makeClient("other");
+
+    auto opCtx = harness.newOperationContext();
+    RecordId updated;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        updated = insertString(opCtx.get(), rs.get(), "a");
+        wuow.commit();
+    }
+
+    auto otherOpCtx = harness.newOperationContext(otherClient.get());
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(rs->updateRecord(opCtx.get(), updated, "b", 2, false, nullptr));
+        RecordId inserted = insertString(opCtx.get(), rs.get(), "c");
+
+        // The writer sees its own writes.
+        ASSERT_EQUALS(std::string("b"), rs->dataFor(opCtx.get(), updated).data());
+        ASSERT(rs->getCursor(opCtx.get())->seekExact(inserted));
+
+        // Everyone else sees the last committed versions.
+        RecordData rd;
+        ASSERT(rs->findRecord(otherOpCtx.get(), updated, &rd));
+        ASSERT_EQUALS(std::string("a"), rd.data());
+        ASSERT_FALSE(rs->findRecord(otherOpCtx.get(), inserted, &rd));
+        ASSERT_THROWS(rs->dataFor(otherOpCtx.get(), inserted), WriteConflictException);
+
+        auto cursor = rs->getCursor(otherOpCtx.get());
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQUALS(updated, record->id);
+        ASSERT_EQUALS(std::string("a"), record->data.data());
+        ASSERT_FALSE(cursor->next());
+
+        auto reverseCursor = rs->getCursor(otherOpCtx.get(), false);
+        record = reverseCursor->next();
+        ASSERT(record);
+        ASSERT_EQUALS(updated, record->id);
+        ASSERT_FALSE(reverseCursor->next());
+
+        // Roll back.
+    }
+
+    ASSERT_EQUALS(std::string("a"), rs->dataFor(otherOpCtx.get(), updated).data());
+    ASSERT_EQUALS(1, rs->numRecords(otherOpCtx.get()));
+}
+
+TEST(EphemeralForTestRecordStoreTest, CursorsSurviveConcurrentDeletes) {
+    EphemeralForTestHarnessHelper harness;
+    auto rs = harness.newNonCappedRecordStore();
+    auto otherClient = harness.serviceContext()->makeClient("other");
+
+    auto opCtx = harness.newOperationContext();
+    std::vector<RecordId> locs;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        for (int i = 0; i < 4; i++) {
+            locs.push_back(insertString(opCtx.get(), rs.get(), "a"));
+        }
+        wuow.commit();
+    }
+
+    auto forward = rs->getCursor(opCtx.get(), true);
+    auto reverse = rs->getCursor(opCtx.get(), false);
+    ASSERT_EQUALS(locs[0], forward->next()->id);
+    ASSERT_EQUALS(locs[3], reverse->next()->id);
+
+    // Another operation deletes the records the cursors are on and the ones they would visit
+    // next, without either cursor being saved.
+    {
+        auto otherOpCtx = harness.newOperationContext(otherClient.get());
+        WriteUnitOfWork wuow(otherOpCtx.get());
+        rs->deleteRecord(otherOpCtx.get(), locs[0]);
+        rs->deleteRecord(otherOpCtx.get(), locs[1]);
+        rs->deleteRecord(otherOpCtx.get(), locs[3]);
+        wuow.commit();
+    }
+
+    ASSERT_EQUALS(locs[2], forward->next()->id);
+    ASSERT_FALSE(forward->next());
+    ASSERT_EQUALS(locs[2], reverse->next()->id);
+    ASSERT_FALSE(reverse->next());
+}
+
+TEST(EphemeralForTestRecordStoreTest, CappedCursorsStopAtUncommittedInserts) {
+    EphemeralForTestHarnessHelper harness;
+    auto rs = harness.newCappedRecordStore(1024 * 1024, -1);
+    auto otherClient = harness.serviceContext()->makeClient("other");
+
+    auto opCtx = harness.newOperationContext();
+    RecordId first;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        first = insertString(opCtx.get(), rs.get(), "a");
+        wuow.commit();
+    }
+
+    auto otherOpCtx = harness.newOperationContext(otherClient.get());
+    auto cursor = rs->getCursor(otherOpCtx.get(), true);
+    RecordId second;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        second = insertString(opCtx.get(), rs.get(), "b");
+
+        ASSERT_EQUALS(first, cursor->next()->id);
+        ASSERT_FALSE(cursor->next());
+        wuow.commit();
+    }
+
+    // Once the insert commits, the cursor picks up where it stopped.
+    ASSERT_EQUALS(second, cursor->next()->id);
+    ASSERT_FALSE(cursor->next());
+}
 }  // namespace
 }  // namespace mongo
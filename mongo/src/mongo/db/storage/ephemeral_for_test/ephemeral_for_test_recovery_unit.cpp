@@ -32,21 +32,62 @@
 
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 
+#include <set>
+
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
+namespace {
+
+AtomicUInt64 nextSnapshotId(1);
+
+// Commit numbers are handed out in order, but commits finish in any order. A snapshot may only
+// include a commit once every commit numbered up to it has finished, or a writer could read a
+// record's old version and still have a snapshot at or after the commit that replaced it.
+stdx::mutex commitNumbersMutex;
+uint64_t lastCommitNumber = 0;
+std::set<uint64_t> commitsInProgress;
+
+uint64_t beginCommit() {
+    stdx::lock_guard<stdx::mutex> lk(commitNumbersMutex);
+    commitsInProgress.insert(++lastCommitNumber);
+    return lastCommitNumber;
+}
+
+void endCommit(uint64_t commitNumber) {
+    stdx::lock_guard<stdx::mutex> lk(commitNumbersMutex);
+    commitsInProgress.erase(commitNumber);
+}
+
+uint64_t lastVisibleCommitNumber() {
+    stdx::lock_guard<stdx::mutex> lk(commitNumbersMutex);
+    return commitsInProgress.empty() ? lastCommitNumber : *commitsInProgress.begin() - 1;
+}
+
+}  // namespace
+
+void EphemeralForTestRecoveryUnit::_openSnapshot() {
+    _mySnapshotId = nextSnapshotId.fetchAndAdd(1);
+    _snapshotCommitNumber = lastVisibleCommitNumber();
+}
 
 void EphemeralForTestRecoveryUnit::commitUnitOfWork() {
     try {
+        _commitNumber = beginCommit();
         for (Changes::iterator it = _changes.begin(), end = _changes.end(); it != end; ++it) {
             (*it)->commit();
         }
         _changes.clear();
+        endCommit(_commitNumber);
+        _commitNumber = 0;
     } catch (...) {
         std::terminate();
     }
+    _openSnapshot();
 
     // This ensures that the journal listener gets called on each commit.
     // SERVER-22575: Remove this once we add a generic mechanism to periodically wait
@@ -66,6 +107,7 @@ void EphemeralForTestRecoveryUnit::abortUnitOfWork() {
     } catch (...) {
         std::terminate();
     }
+    _openSnapshot();
 }
 
 Status EphemeralForTestRecoveryUnit::setReadFromMajorityCommittedSnapshot() {
@@ -40,10 +40,20 @@ namespace mongo {
 
 class SortedDataInterface;
 
+/**
+ * Every unit of work has a snapshot, which is the number of the last commit that was fully visible
+ * when it was opened. Committed writes are stamped with the number of their commit. If
+ * 'detectWriteConflicts' is set, which document-level locking needs, the record store makes a
+ * writer whose snapshot predates the last commit to a record get a WriteConflictException (first
+ * committer wins). Reads are not isolated: they see the latest committed version of a record.
+ */
 class EphemeralForTestRecoveryUnit : public RecoveryUnit {
 public:
-    EphemeralForTestRecoveryUnit(stdx::function<void()> cb = nullptr)
-        : _waitUntilDurableCallback(cb) {}
+    EphemeralForTestRecoveryUnit(stdx::function<void()> cb = nullptr,
+                                 bool detectWriteConflicts = false)
+        : _waitUntilDurableCallback(cb), _detectWriteConflicts(detectWriteConflicts) {
+        _openSnapshot();
+    }
 
     void beginUnitOfWork(OperationContext* opCtx) final{};
     void commitUnitOfWork() final;
@@ -56,7 +66,9 @@ public:
         return true;
     }
 
-    virtual void abandonSnapshot() {}
+    virtual void abandonSnapshot() {
+        _openSnapshot();
+    }
 
     Status setReadFromMajorityCommittedSnapshot() final;
 
@@ -71,15 +83,42 @@ public:
     virtual void setRollbackWritesDisabled() {}
 
     virtual SnapshotId getSnapshotId() const {
-        return SnapshotId();
+        return SnapshotId(_mySnapshotId);
+    }
+
+    bool detectsWriteConflicts() const {
+        return _detectWriteConflicts;
+    }
+
+    /**
+     * Returns the number of the last commit that was fully visible when the current snapshot was
+     * opened. Records stamped with a higher number changed after the snapshot.
+     */
+    uint64_t getSnapshotCommitNumber() const {
+        return _snapshotCommitNumber;
+    }
+
+    /**
+     * Returns the number of the commit in progress, for changes to stamp what they commit with.
+     * Zero outside of commitUnitOfWork().
+     */
+    uint64_t getCommitNumber() const {
+        return _commitNumber;
     }
 
 private:
+    void _openSnapshot();
+
     typedef std::shared_ptr<Change> ChangePtr;
     typedef std::vector<ChangePtr> Changes;
 
     Changes _changes;
     stdx::function<void()> _waitUntilDurableCallback;
+    const bool _detectWriteConflicts;
+
+    uint64_t _mySnapshotId;
+    uint64_t _snapshotCommitNumber;
+    uint64_t _commitNumber = 0;
 };
 
 }  // namespace mongo
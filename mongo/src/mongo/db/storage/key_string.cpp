@@ -225,14 +225,37 @@ const uint8_t kEnd = 0x4;
 // the encoding of NUL bytes in strings as "\x00\xff".
 const uint8_t kLess = 1;
 const uint8_t kGreater = 254;
+
+// In V2, a date is a header byte followed by 0 to 8 bytes. The high 4 bits of the header are a
+// length code that orders dates by magnitude: codes 8 to 14 hold non-negative values in 4 + 8 * k
+// bits, where k = code - 8 is the number of bytes that follow, and codes 7 down to 1 hold negative
+// values biased by 2**(4 + 8 * k), where k = 7 - code. The low 4 bits of the header are the
+// highest bits of the value. Dates too large for that are code 15 or 0, followed by all 8 bytes
+// of the value. Since dates near now need 41 bits, they take 6 bytes instead of 8.
+const uint8_t kCompactDateMaxExtraBytes = 6;
+const uint8_t kCompactDateFullNegative = 0x00;
+const uint8_t kCompactDateFullPositive = 0xf0;
+
+int compactDateValueBits(uint8_t extraBytes) {
+    return 4 + 8 * extraBytes;
+}
 }  // namespace
 
 // some utility functions
 namespace {
+// Descending keys and inverted strings flip every byte they copy, so this works a word at a time,
+// which compilers turn into vector instructions. 'dst' may be the same as 'src'.
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+    for (; end - input >= static_cast<ptrdiff_t>(sizeof(uint64_t));
+         input += sizeof(uint64_t), output += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+    }
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -247,6 +270,24 @@ T readType(BufReader* reader, bool inverted) {
     return t;
 }
 
+int64_t readCompactDate(BufReader* reader, bool inverted) {
+    const uint8_t header = readType<uint8_t>(reader, inverted);
+    const uint8_t lengthCode = header >> 4;
+    if (lengthCode == kCompactDateFullNegative >> 4 || lengthCode == kCompactDateFullPositive >> 4) {
+        return static_cast<int64_t>(endian::bigToNative(readType<uint64_t>(reader, inverted)));
+    }
+
+    const bool isNegative = lengthCode < 8;
+    const uint8_t extraBytes = isNegative ? 7 - lengthCode : lengthCode - 8;
+    uint64_t value = header & 0xf;
+    for (uint8_t i = 0; i < extraBytes; ++i) {
+        value = (value << 8) | readType<uint8_t>(reader, inverted);
+    }
+
+    return isNegative ? static_cast<int64_t>(value) - (1LL << compactDateValueBits(extraBytes))
+                      : static_cast<int64_t>(value);
+}
+
 StringData readCString(BufReader* reader) {
     const char* start = static_cast<const char*>(reader->pos());
     const char* end = static_cast<const char*>(memchr(start, 0x0, reader->remaining()));
@@ -284,10 +325,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     invariant(end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -314,9 +353,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
+    memcpy_flipBits(&out[0], out.data(), out.size());
 
     return out;
 }
@@ -444,12 +481,41 @@ void KeyString::_appendBool(bool val, bool invert) {
 
 void KeyString::_appendDate(Date_t val, bool invert) {
     _append(CType::kDate, invert);
+    if (version == Version::V2) {
+        _appendCompactDate(val.asInt64(), invert);
+        return;
+    }
+
     // see: http://en.wikipedia.org/wiki/Offset_binary
     uint64_t encoded = static_cast<uint64_t>(val.asInt64());
     encoded ^= (1LL << 63);  // flip highest bit (equivalent to bias encoding)
     _append(endian::nativeToBig(encoded), invert);
 }
 
+void KeyString::_appendCompactDate(int64_t millis, bool invert) {
+    const bool isNegative = millis < 0;
+    for (uint8_t extraBytes = 0; extraBytes <= kCompactDateMaxExtraBytes; ++extraBytes) {
+        const int64_t limit = 1LL << compactDateValueBits(extraBytes);
+        if (isNegative ? millis < -limit : millis >= limit) {
+            continue;
+        }
+
+        const uint64_t value = static_cast<uint64_t>(isNegative ? millis + limit : millis);
+        const uint8_t lengthCode = isNegative ? 7 - extraBytes : 8 + extraBytes;
+        _append(static_cast<uint8_t>((lengthCode << 4) | (value >> (8 * extraBytes))), invert);
+        if (extraBytes) {
+            const uint64_t bigEndian = endian::nativeToBig(value);
+            _appendBytes(reinterpret_cast<const char*>(&bigEndian) + sizeof(bigEndian) - extraBytes,
+                         extraBytes,
+                         invert);
+        }
+        return;
+    }
+
+    _append(isNegative ? kCompactDateFullNegative : kCompactDateFullPositive, invert);
+    _append(endian::nativeToBig(static_cast<uint64_t>(millis)), invert);
+}
+
 void KeyString::_appendTimestamp(Timestamp val, bool invert) {
     _append(CType::kTimestamp, invert);
     _append(endian::nativeToBig(val.asLL()), invert);
@@ -1158,6 +1224,10 @@ void toBsonValue(uint8_t ctype,
             break;
 
         case CType::kDate:
+            if (version == KeyString::Version::V2) {
+                *stream << Date_t::fromMillisSinceEpoch(readCompactDate(reader, inverted));
+                break;
+            }
             *stream << Date_t::fromMillisSinceEpoch(
                 endian::bigToNative(readType<uint64_t>(reader, inverted)) ^ (1LL << 63));
             break;
@@ -1302,7 +1372,7 @@ void toBsonValue(uint8_t ctype,
             if (type == TypeBits::kDouble) {
                 *stream << std::numeric_limits<double>::quiet_NaN();
             } else {
-                invariant(type == TypeBits::kDecimal && version == KeyString::Version::V1);
+                invariant(type == TypeBits::kDecimal && version != KeyString::Version::V0);
                 *stream << Decimal128::kPositiveNaN;
             }
             break;
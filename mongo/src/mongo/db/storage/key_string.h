@@ -40,6 +40,7 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -47,10 +48,20 @@ class KeyString {
 public:
     /**
      * Selects version of KeyString to use. V0 and V1 differ in their encoding of numeric values.
+     * V2 is V1 with a shorter, variable-length encoding of dates. It is only used by indexes
+     * created on a node that is configured to store compact keys.
      */
-    enum class Version : uint8_t { V0 = 0, V1 = 1 };
+    enum class Version : uint8_t { V0 = 0, V1 = 1, V2 = 2 };
     static StringData versionToString(Version version) {
-        return version == Version::V0 ? "V0" : "V1";
+        switch (version) {
+            case Version::V0:
+                return "V0";
+            case Version::V1:
+                return "V1";
+            case Version::V2:
+                return "V2";
+        }
+        MONGO_UNREACHABLE;
     }
 
     /**
@@ -364,6 +375,7 @@ private:
 
     void _appendBool(bool val, bool invert);
     void _appendDate(Date_t val, bool invert);
+    void _appendCompactDate(int64_t millis, bool invert);
     void _appendTimestamp(Timestamp val, bool invert);
     void _appendOID(OID val, bool invert);
     void _appendString(StringData val, bool invert);
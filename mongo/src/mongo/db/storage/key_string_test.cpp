@@ -75,6 +75,8 @@ public:
             base->run();
             version = KeyString::Version::V1;
             base->run();
+            version = KeyString::Version::V2;
+            base->run();
         } catch (...) {
             log() << "exception while testing KeyString version "
                   << mongo::KeyString::versionToString(version);
@@ -522,6 +524,58 @@ TEST_F(KeyStringTest, Timestamp) {
     }
 }
 
+TEST_F(KeyStringTest, Dates) {
+    const long long kLimits[] = {1LL << 4, 1LL << 12, 1LL << 44, 1LL << 52};
+    std::vector<long long> millis = {std::numeric_limits<long long>::min(),
+                                     std::numeric_limits<long long>::max(),
+                                     0,
+                                     1510000000000LL,
+                                     -1510000000000LL};
+    for (long long limit : kLimits) {
+        for (long long delta : {-1LL, 0LL, 1LL}) {
+            millis.push_back(limit + delta);
+            millis.push_back(-limit + delta);
+        }
+    }
+    std::sort(millis.begin(), millis.end());
+
+    for (auto ord : {ONE_ASCENDING, ONE_DESCENDING}) {
+        for (size_t i = 0; i < millis.size(); ++i) {
+            BSONObj a = BSON("" << Date_t::fromMillisSinceEpoch(millis[i]));
+            ROUNDTRIP_ORDER(version, a, ord);
+            if (i + 1 < millis.size()) {
+                BSONObj b = BSON("" << Date_t::fromMillisSinceEpoch(millis[i + 1]));
+                ASSERT_EQ(KeyString(version, a, ord).compare(KeyString(version, b, ord)) < 0,
+                          a.woCompare(b, ord) < 0);
+            }
+        }
+    }
+}
+
+TEST_F(KeyStringTest, DescendingStringsOfAllLengths) {
+    // Inverted bytes are flipped a word at a time, so cover lengths around the word size and
+    // embedded NULs in each position.
+    for (size_t length = 0; length < 40; ++length) {
+        std::string str(length, 'x');
+        for (size_t i = 0; i < length; ++i) {
+            str[i] = static_cast<char>('a' + i % 26);
+        }
+        ROUNDTRIP_ORDER(version, BSON("" << str), ONE_DESCENDING);
+        for (size_t nul = 0; nul < length; ++nul) {
+            std::string withNul = str;
+            withNul[nul] = '\0';
+            ROUNDTRIP_ORDER(version, BSON("" << withNul), ONE_DESCENDING);
+        }
+    }
+}
+
+TEST(KeyStringV2Test, RecentDatesAreShorter) {
+    BSONObj date = BSON("" << Date_t::fromMillisSinceEpoch(1510000000000LL));
+    KeyString v1(KeyString::Version::V1, date, ALL_ASCENDING);
+    KeyString v2(KeyString::Version::V2, date, ALL_ASCENDING);
+    ASSERT_EQ(v1.getSize() - 2, v2.getSize());
+}
+
 TEST_F(KeyStringTest, AllTypesRoundtrip) {
     for (int i = 1; i <= JSTypeMax; i++) {
         {
@@ -1170,7 +1224,9 @@ typedef std::vector<BSONObj> Numbers;
  * Evaluates ROUNDTRIP on all items in Numbers a sufficient number of times to take at least
  * kMinPerfMicros microseconds. Logs the elapsed time per ROUNDTRIP evaluation.
  */
-void perfTest(KeyString::Version version, const Numbers& numbers) {
+void perfTest(KeyString::Version version,
+              const Numbers& numbers,
+              Ordering ordering = ALL_ASCENDING) {
     uint64_t micros = 0;
     uint64_t iters;
     // Ensure at least 16 iterations are done and at least 50 milliseconds is timed
@@ -1182,8 +1238,8 @@ void perfTest(KeyString::Version version, const Numbers& numbers) {
             for (auto item : numbers) {
                 // Assuming there are sufficient invariants in the to/from KeyString methods
                 // that calls will not be optimized away.
-                const KeyString ks(version, item, ALL_ASCENDING);
-                const BSONObj& converted = toBson(ks, ALL_ASCENDING);
+                const KeyString ks(version, item, ordering);
+                const BSONObj& converted = toBson(ks, ordering);
                 invariant(converted.binaryEqual(item));
             }
 
@@ -1313,3 +1369,64 @@ TEST_F(KeyStringTest, DecimalFromUniformDoublePerf) {
     }
     perfTest(version, numbers);
 }
+
+namespace {
+std::string randomString(std::mt19937& gen, size_t length) {
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string str(length, '\0');
+    for (auto& c : str) {
+        c = static_cast<char>(letter(gen));
+    }
+    return str;
+}
+}  // namespace
+
+TEST_F(KeyStringTest, CommonStringPerf) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<size_t> length(1, 64);
+
+    std::vector<BSONObj> strings;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        strings.push_back(BSON("" << randomString(gen, length(gen))));
+
+    perfTest(version, strings);
+    perfTest(version, strings, ONE_DESCENDING);
+}
+
+TEST_F(KeyStringTest, OIDPerf) {
+    std::vector<BSONObj> oids;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        oids.push_back(BSON("" << OID::gen()));
+
+    perfTest(version, oids);
+    perfTest(version, oids, ONE_DESCENDING);
+}
+
+TEST_F(KeyStringTest, DatePerf) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<long long> recentMillis(1400000000000LL, 1600000000000LL);
+
+    std::vector<BSONObj> dates;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        dates.push_back(BSON("" << Date_t::fromMillisSinceEpoch(recentMillis(gen))));
+
+    perfTest(version, dates);
+}
+
+TEST_F(KeyStringTest, CompoundKeyPerf) {
+    // Shaped like an index on {tenant: 1, status: 1, ts: -1}.
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<size_t> tenant(0, 99);
+    std::uniform_int_distribution<size_t> status(0, 3);
+    std::uniform_int_distribution<long long> recentMillis(1400000000000LL, 1600000000000LL);
+    const std::string statuses[] = {"new", "active", "suspended", "closed"};
+
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        keys.push_back(BSON("" << ("tenant" + std::to_string(tenant(gen))) << ""
+                               << statuses[status(gen)]
+                               << ""
+                               << Date_t::fromMillisSinceEpoch(recentMillis(gen))));
+
+    perfTest(version, keys, Ordering::make(BSON("tenant" << 1 << "status" << 1 << "ts" << -1)));
+}
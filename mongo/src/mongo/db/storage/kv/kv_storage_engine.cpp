@@ -355,6 +355,23 @@ void KVStorageEngine::endBackup(OperationContext* opCtx) {
     _inBackupMode = false;
 }
 
+StatusWith<std::vector<std::string>> KVStorageEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    // The storage engine can only have one backup cursor open at a time.
+    if (_inBackupMode)
+        return Status(ErrorCodes::BadValue, "Already in Backup Mode");
+    auto swFiles = _engine->beginNonBlockingBackup(opCtx);
+    if (swFiles.isOK())
+        _inBackupMode = true;
+    return swFiles;
+}
+
+void KVStorageEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    invariant(_inBackupMode);
+    _engine->endNonBlockingBackup(opCtx);
+    _inBackupMode = false;
+}
+
 bool KVStorageEngine::isDurable() const {
     return _engine->isDurable();
 }
@@ -176,6 +176,13 @@ public:
                       "this storage engine does not support touch");
     }
 
+    /**
+     * Return true if 'this' index stores its entries in a format that 3.4 binaries can't read.
+     */
+    virtual bool requiresFeatureCompatibilityVersion36() const {
+        return false;
+    }
+
     /**
      * Return the number of entries in 'this' index.
      *
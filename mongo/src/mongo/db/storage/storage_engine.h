@@ -261,6 +261,28 @@ public:
         return;
     }
 
+    /**
+     * Opens a backup cursor so the data files can be copied while writes continue.
+     *
+     * On success, returns the files, relative to the dbpath, that make up the last checkpoint and
+     * the journal needed to recover it. Those files are not removed or truncated by the storage
+     * engine until endNonBlockingBackup() is called; a node started on a copy of them recovers to
+     * a consistent state as of when the backup cursor was opened.
+     *
+     * Like beginBackup(), only one backup may be in progress at a time.
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine doesn't support a non-blocking backup");
+    }
+
+    /**
+     * Closes the backup cursor opened by a successful beginNonBlockingBackup().
+     */
+    virtual void endNonBlockingBackup(OperationContext* opCtx) {
+        return;
+    }
+
     /**
      * Recover as much data as possible from a potentially corrupt RecordStore.
      * This only recovers the record data, not indexes or anything else.
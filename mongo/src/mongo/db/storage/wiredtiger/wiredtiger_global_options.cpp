@@ -102,6 +102,12 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            moe::Bool,
                            "use prefix compression on row-store leaf pages")
         .setDefault(moe::Value(true));
+    wiredTigerOptions
+        .addOptionChaining("storage.wiredTiger.indexConfig.compactKeys",
+                           "wiredTigerIndexCompactKeys",
+                           moe::Bool,
+                           "store the keys of new indexes in a more compact format")
+        .setDefault(moe::Value(false));
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.indexConfig.configString",
                            "wiredTigerIndexConfigString",
@@ -123,6 +129,7 @@ storage:
          blockCompressor: <string>
       indexConfig:
          prefixCompression: <boolean>
+         compactKeys: <boolean>
 */
 //mongo.confļеwiredTiger:صϢ
 Status WiredTigerGlobalOptions::store(const moe::Environment& params,
@@ -170,6 +177,10 @@ Status WiredTigerGlobalOptions::store(const moe::Environment& params,
         wiredTigerGlobalOptions.useIndexPrefixCompression =
             params["storage.wiredTiger.indexConfig.prefixCompression"].as<bool>();
     }
+    if (params.count("storage.wiredTiger.indexConfig.compactKeys")) {
+        wiredTigerGlobalOptions.useIndexCompactKeys =
+            params["storage.wiredTiger.indexConfig.compactKeys"].as<bool>();
+    }
     if (params.count("storage.wiredTiger.indexConfig.configString")) {
         wiredTigerGlobalOptions.indexConfig =
             params["storage.wiredTiger.indexConfig.configString"].as<std::string>();
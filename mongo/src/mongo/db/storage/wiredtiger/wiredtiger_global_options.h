@@ -45,7 +45,8 @@ public:
           statisticsLogDelaySecs(0),
           directoryForIndexes(false),
           useCollectionPrefixCompression(false),
-          useIndexPrefixCompression(false){};
+          useIndexPrefixCompression(false),
+          useIndexCompactKeys(false){};
 
     Status add(moe::OptionSection* options);
     Status store(const moe::Environment& params, const std::vector<std::string>& args);
@@ -61,6 +62,7 @@ public:
     std::string indexBlockCompressor;
     bool useCollectionPrefixCompression;
     bool useIndexPrefixCompression;
+    bool useIndexCompactKeys;
     std::string collectionConfig;
     std::string indexConfig;
 };
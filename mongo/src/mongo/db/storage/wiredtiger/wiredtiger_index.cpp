@@ -43,6 +43,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/storage_options.h"
@@ -89,8 +90,9 @@ static const WiredTigerItem emptyItem(NULL, 0);
 // Keystring format 7 was used in 3.3.6 - 3.3.8 development releases.
 static const int kKeyStringV0Version = 6;
 static const int kKeyStringV1Version = 8;
+static const int kKeyStringV2Version = 9;
 static const int kMinimumIndexVersion = kKeyStringV0Version;
-static const int kMaximumIndexVersion = kKeyStringV1Version;
+static const int kMaximumIndexVersion = kKeyStringV2Version;
 
 bool hasFieldNames(const BSONObj& obj) {
     BSONForEach(e, obj) {
@@ -193,8 +195,8 @@ StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string&
     BSONElement storageEngineElement = desc.getInfoElement("storageEngine");
     if (storageEngineElement.isABSONObj()) {
         BSONObj storageEngine = storageEngineElement.Obj();
-        StatusWith<std::string> parseStatus =
-            parseIndexOptions(storageEngine.getObjectField(engineName));
+        BSONObj engineOptions = storageEngine.getObjectField(engineName);
+        StatusWith<std::string> parseStatus = parseIndexOptions(engineOptions);
         if (!parseStatus.isOK()) {
             return parseStatus;
         }
@@ -215,10 +217,18 @@ StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string&
     }
     ss << ",value_format=u";   //WT_ITEM *
 
-    // Index versions greater than 2 use KeyString version 1.
-    const int keyStringVersion = desc.version() >= IndexDescriptor::IndexVersion::kV2
-        ? kKeyStringV1Version
-        : kKeyStringV0Version;
+    // Index versions greater than 2 use KeyString version 1, or version 2 if this node is
+    // configured to. The KeyString version is local to this node and isn't part of the index spec,
+    // so members of a replica set may differ. 3.4 binaries can't open version 2 indexes, which is
+    // why they are only created once the featureCompatibilityVersion is 3.6.
+    int keyStringVersion = kKeyStringV0Version;
+    if (desc.version() >= IndexDescriptor::IndexVersion::kV2) {
+        keyStringVersion = wiredTigerGlobalOptions.useIndexCompactKeys &&
+                serverGlobalParams.featureCompatibility.getVersion() ==
+                    ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36
+            ? kKeyStringV2Version
+            : kKeyStringV1Version;
+    }
 
     // Index metadata
     ss << ",app_metadata=("
@@ -285,8 +295,17 @@ WiredTigerIndex::WiredTigerIndex(OperationContext* ctx,
                           << " instructions on how to handle this error.");
         fassertFailedWithStatusNoTrace(28579, indexVersionStatus);
     }
-    _keyStringVersion =
-        version.getValue() == kKeyStringV1Version ? KeyString::Version::V1 : KeyString::Version::V0;
+    switch (version.getValue()) {
+        case kKeyStringV2Version:
+            _keyStringVersion = KeyString::Version::V2;
+            break;
+        case kKeyStringV1Version:
+            _keyStringVersion = KeyString::Version::V1;
+            break;
+        default:
+            _keyStringVersion = KeyString::Version::V0;
+            break;
+    }
 
     if (!isReadOnly) {
         uassertStatusOK(WiredTigerUtil::setTableLogging(
@@ -295,6 +314,9 @@ WiredTigerIndex::WiredTigerIndex(OperationContext* ctx,
             WiredTigerUtil::useTableLogging(NamespaceString(desc->parentNS()),
                                             getGlobalReplSettings().usingReplSets())));
     }
+
+    // Nothing above opens the table itself, only the WiredTiger metadata. The table is opened by
+    // the first cursor on it, so indexes that are never used after startup are never opened.
 }
 
 //ݲ(Ԫļ_mdb_catalog.wtͨļ)WiredTigerRecordStore::_insertRecordsWiredTigerIndex::insert
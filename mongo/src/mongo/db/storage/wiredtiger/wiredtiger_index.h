@@ -108,6 +108,10 @@ public:
 
     virtual long long getSpaceUsedBytes(OperationContext* opCtx) const;
 
+    virtual bool requiresFeatureCompatibilityVersion36() const {
+        return _keyStringVersion == KeyString::Version::V2;
+    }
+
     virtual Status initAsEmpty(OperationContext* opCtx);
 
     virtual Status compact(OperationContext* opCtx);
@@ -94,5 +94,12 @@ TEST(WiredTigerIndexTest, GenerateCreateStringValidConfigStringOption) {
     ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), std::string("prefix_compression=true,"));
 }
 
+// Compact keys are a per-node setting; older binaries reject the option in an index spec, and
+// so does this one.
+TEST(WiredTigerIndexTest, GenerateCreateStringCompactKeysIsNotAnIndexOption) {
+    BSONObj spec = fromjson("{compactKeys: true}");
+    ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), ErrorCodes::InvalidOptions);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -66,6 +66,8 @@ public:
                                   const StorageEngineLockFile* lockFile) const {
         if (lockFile && lockFile->createdByUncleanShutdown()) {
             warning() << "Recovering data from the last clean checkpoint.";
+            warning() << "Collection counts and sizes may be inaccurate until the collections "
+                         "are validated.";
         }
 
 #if defined(__linux__)
@@ -171,6 +171,14 @@ public:
             const Timestamp initialDataTimestamp(_initialDataTimestamp.load());
             const bool keepOldBehavior = true;
 
+            // Write out the collection sizes with every checkpoint to narrow how far the sizes a
+            // restart trusts can drift from the data. They are written in their own transaction
+            // rather than as part of the checkpoint, so after an unclean shutdown they may still
+            // be off by the writes that raced this sync. validate() corrects them.
+            if (auto engine = _sessionCache->getKVEngine()) {
+                engine->syncSizeInfo(false);
+            }
+
             try {
                 if (keepOldBehavior) {
                     UniqueWiredTigerSession session = _sessionCache->getSession();
@@ -724,6 +732,51 @@ void WiredTigerKVEngine::endBackup(OperationContext* opCtx) {
     _backupSession.reset();
 }
 
+StatusWith<std::vector<std::string>> WiredTigerKVEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    invariant(!_backupSession);
+
+    if (_ephemeral) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The inMemory storage engine has no data files to back up");
+    }
+
+    // While the backup cursor is open WiredTiger keeps the files of its checkpoint and the log
+    // files needed to recover it, so they can be copied while writes continue.
+    auto session = stdx::make_unique<WiredTigerSession>(_conn);
+    WT_CURSOR* c = NULL;
+    WT_SESSION* s = session->getSession();
+    int ret = WT_OP_CHECK(s->open_cursor(s, "backup:", NULL, NULL, &c));
+    if (ret != 0) {
+        return wtRCToStatus(ret);
+    }
+
+    std::vector<std::string> files;
+    while ((ret = c->next(c)) == 0) {
+        const char* filename;
+        ret = c->get_key(c, &filename);
+        if (ret != 0) {
+            return wtRCToStatus(ret);
+        }
+        // Log files are named relative to the log path, which is the journal directory.
+        std::string name(filename);
+        if (name.find("WiredTigerLog.") == 0) {
+            name = "journal/" + name;
+        }
+        files.push_back(std::move(name));
+    }
+    if (ret != WT_NOTFOUND) {
+        return wtRCToStatus(ret);
+    }
+
+    _backupSession = std::move(session);
+    return std::move(files);
+}
+
+void WiredTigerKVEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    _backupSession.reset();
+}
+
 //οhttp://www.mongoing.com/archives/5476  ͬڴеsize
 //WiredTigerKVEngine::haveDropsQueued  WiredTigerKVEngine::flushAllFilesе
 void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
@@ -33,11 +33,17 @@
 
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/base/init.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
 namespace mongo {
@@ -65,6 +71,10 @@ public:
         return _engine.get();
     }
 
+    const std::string& getPath() const {
+        return _dbpath.path();
+    }
+
 private:
     const std::unique_ptr<ClockSource> _cs = stdx::make_unique<ClockSourceMock>();
     unittest::TempDir _dbpath;
@@ -80,5 +90,36 @@ MONGO_INITIALIZER(RegisterKVHarnessFactory)(InitializerContext*) {
     return Status::OK();
 }
 
+TEST(WiredTigerKVEngineTest, NonBlockingBackupListsCheckpointFiles) {
+    WiredTigerKVHarnessHelper helper;
+    KVEngine* engine = helper.getEngine();
+
+    const std::string ident = "collection-backup";
+    {
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        ASSERT_OK(engine->createRecordStore(&opCtx, "a.b", ident, CollectionOptions()));
+    }
+    {
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        engine->flushAllFiles(&opCtx, true);
+    }
+
+    OperationContextNoop opCtx(engine->newRecoveryUnit());
+    auto swFiles = engine->beginNonBlockingBackup(&opCtx);
+    ASSERT_OK(swFiles.getStatus());
+    const auto& files = swFiles.getValue();
+    ASSERT_FALSE(files.empty());
+    ASSERT(std::find(files.begin(), files.end(), ident + ".wt") != files.end());
+    for (const auto& file : files) {
+        ASSERT(boost::filesystem::exists(boost::filesystem::path(helper.getPath()) / file))
+            << file;
+    }
+    engine->endNonBlockingBackup(&opCtx);
+
+    // The backup cursor was closed, so another backup can be taken.
+    ASSERT_OK(engine->beginNonBlockingBackup(&opCtx).getStatus());
+    engine->endNonBlockingBackup(&opCtx);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -87,6 +88,55 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 MONGO_FP_DECLARE(WTWriteConflictException);
 MONGO_FP_DECLARE(WTWriteConflictExceptionForReads);
 
+AtomicInt32 oplogMinRetentionSeconds(0);
+AtomicInt32 oplogMaxRetentionSeconds(0);
+
+namespace {
+
+/**
+ * Rejects negative retention windows and a minimum that is longer than the maximum. Zero leaves a
+ * bound unset.
+ */
+class ExportedOplogRetentionParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedOplogRetentionParameter(const std::string& name, AtomicInt32* value, bool isMinimum)
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(), name, value),
+          _isMinimum(isMinimum) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << name() << " must be greater than or equal to 0");
+        }
+
+        const int minRetention = _isMinimum ? potentialNewValue : oplogMinRetentionSeconds.load();
+        const int maxRetention = _isMinimum ? oplogMaxRetentionSeconds.load() : potentialNewValue;
+        if (minRetention > 0 && maxRetention > 0 && minRetention > maxRetention) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "oplogMinRetentionSeconds (" << minRetention
+                                        << ") must not be greater than oplogMaxRetentionSeconds ("
+                                        << maxRetention
+                                        << ")");
+        }
+
+        return Status::OK();
+    }
+
+private:
+    const bool _isMinimum;
+};
+
+ExportedOplogRetentionParameter oplogMinRetentionSecondsParam("oplogMinRetentionSeconds",
+                                                              &oplogMinRetentionSeconds,
+                                                              true);
+ExportedOplogRetentionParameter oplogMaxRetentionSecondsParam("oplogMaxRetentionSeconds",
+                                                              &oplogMaxRetentionSeconds,
+                                                              false);
+
+}  // namespace
+
 const std::string kWiredTigerEngineName = "wiredTiger";
 
 class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
@@ -130,6 +180,7 @@ public:
 
         stdx::lock_guard<stdx::mutex> lk(_oplogStones->_mutex);
         _oplogStones->_stones.clear();
+        _oplogStones->_persistStones_inlock();
     }
 
     void rollback() final {}
@@ -154,7 +205,10 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
-    _calculateStones(opCtx, numStonesToKeep);
+    if (!_loadPersistedStones(opCtx)) {
+        _calculateStones(opCtx, numStonesToKeep);
+        _persistStones_inlock();
+    }
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
@@ -182,10 +236,42 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
                 break;
             }
         }
-        _oplogReclaimCv.wait(lock);
+        if (oplogMinRetentionSeconds.load() > 0 || oplogMaxRetentionSeconds.load() > 0) {
+            // Stones move into and out of the retention windows as time passes, even when nothing
+            // is inserted to wake us up.
+            _oplogReclaimCv.wait_for(lock, Seconds(1).toSystemDuration());
+        } else {
+            _oplogReclaimCv.wait(lock);
+        }
     }
 }
 
+bool WiredTigerRecordStore::OplogStones::hasExcessStones_inlock() const {
+    if (_stones.empty()) {
+        return false;
+    }
+
+    const long long now = durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+    const long long oldestStoneSecs = Timestamp(_stones.front().lastRecord.repr()).getSecs();
+
+    const int maxRetentionSeconds = oplogMaxRetentionSeconds.load();
+    if (maxRetentionSeconds > 0 && oldestStoneSecs < now - maxRetentionSeconds) {
+        return true;
+    }
+
+    int64_t total_bytes = 0;
+    for (std::deque<OplogStones::Stone>::const_iterator it = _stones.begin(); it != _stones.end();
+         ++it) {
+        total_bytes += it->bytes;
+    }
+    if (total_bytes <= _rs->cappedMaxSize()) {
+        return false;
+    }
+
+    const int minRetentionSeconds = oplogMinRetentionSeconds.load();
+    return minRetentionSeconds <= 0 || oldestStoneSecs < now - minRetentionSeconds;
+}
+
 boost::optional<WiredTigerRecordStore::OplogStones::Stone>
 WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -200,6 +286,7 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stones.pop_front();
+    _persistStones_inlock();
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
@@ -225,6 +312,7 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRec
     LOG(2) << "create new oplogStone, current stones:" << _stones.size();
     OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), lastRecord};
     _stones.push_back(stone);
+    _persistStones_inlock();
 
     _pokeReclaimThreadIfNeeded();
 }
@@ -264,6 +352,7 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     // Remove the stones corresponding to the records that were deleted.
     int64_t offset = _stones.size() - numStonesToRemove;
     _stones.erase(_stones.begin() + offset, _stones.end());
+    _persistStones_inlock();
 
     // Account for any remaining records from a partially truncated stone in the stone currently
     // being filled.
@@ -281,6 +370,101 @@ void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
     _minBytesPerStone = size;
 }
 
+bool WiredTigerRecordStore::OplogStones::_loadPersistedStones(OperationContext* opCtx) {
+    if (!_rs->_sizeStorer) {
+        return false;
+    }
+
+    BSONObj persisted = _rs->_sizeStorer->loadOplogStonesFromCache(_rs->getURI());
+    if (persisted["stones"].type() != Array) {
+        return false;
+    }
+
+    RecordId oldestRecord;
+    RecordId newestRecord;
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/true)->next();
+        if (!record) {
+            return false;
+        }
+        oldestRecord = record->id;
+    }
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/false)->next();
+        if (!record) {
+            return false;
+        }
+        newestRecord = record->id;
+    }
+
+    std::deque<OplogStones::Stone> stones;
+    int64_t recordsInStones = 0;
+    int64_t bytesInStones = 0;
+    RecordId previousRecord;
+    BSONForEach(elem, persisted["stones"].Obj()) {
+        if (elem.type() != Object) {
+            log() << "Ignoring malformed persisted oplog stone " << redact(elem);
+            return false;
+        }
+        BSONObj obj = elem.Obj();
+        OplogStones::Stone stone = {obj["records"].safeNumberLong(),
+                                    obj["bytes"].safeNumberLong(),
+                                    RecordId(obj["lastRecord"].safeNumberLong())};
+
+        if (stone.records < 0 || stone.bytes < 0 || !stone.lastRecord.isNormal() ||
+            stone.lastRecord <= previousRecord || stone.lastRecord > newestRecord) {
+            // The oplog was changed after the stones were last saved, e.g. by an unclean
+            // shutdown or a rollback.
+            log() << "The persisted oplog stones don't match the contents of the oplog, "
+                  << "ignoring them";
+            return false;
+        }
+        previousRecord = stone.lastRecord;
+
+        if (stone.lastRecord < oldestRecord) {
+            // The stone was truncated after the stones were last saved.
+            continue;
+        }
+
+        stones.push_back(stone);
+        recordsInStones += stone.records;
+        bytesInStones += stone.bytes;
+    }
+
+    long long numRecords = _rs->numRecords(opCtx);
+    long long dataSize = _rs->dataSize(opCtx);
+    if (recordsInStones > numRecords || bytesInStones > dataSize) {
+        log() << "The persisted oplog stones cover more than the size storer reports, "
+              << "ignoring them";
+        return false;
+    }
+
+    log() << "Loaded " << stones.size() << " oplog stones saved by the previous run";
+
+    _stones.swap(stones);
+    _currentRecords.store(numRecords - recordsInStones);
+    _currentBytes.store(dataSize - bytesInStones);
+    return true;
+}
+
+void WiredTigerRecordStore::OplogStones::_persistStones_inlock() {
+    if (!_rs->_sizeStorer) {
+        return;
+    }
+
+    BSONObjBuilder builder;
+    {
+        BSONArrayBuilder stonesBuilder(builder.subarrayStart("stones"));
+        for (auto&& stone : _stones) {
+            BSONObjBuilder stoneBuilder(stonesBuilder.subobjStart());
+            stoneBuilder.append("records", static_cast<long long>(stone.records));
+            stoneBuilder.append("bytes", static_cast<long long>(stone.bytes));
+            stoneBuilder.append("lastRecord", static_cast<long long>(stone.lastRecord.repr()));
+        }
+    }
+    _rs->_sizeStorer->storeOplogStonesToCache(_rs->getURI(), builder.obj());
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCtx,
                                                           size_t numStonesToKeep) {
     long long numRecords = _rs->numRecords(opCtx);
@@ -684,37 +868,41 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
 }
 
 void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
-    // Find the largest RecordId currently in use and estimate the number of records.
-    std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
-    if (auto record = cursor->next()) {
-        int64_t max = record->id.repr();
-        _nextIdNum.store(1 + max);
-
-        if (_sizeStorer) {
-            long long numRecords;
-            long long dataSize;
-            _sizeStorer->loadFromCache(_uri, &numRecords, &dataSize);
-            _numRecords.store(numRecords);
-            _dataSize.store(dataSize);
-            _sizeStorer->onCreate(this, numRecords, dataSize);
-        } else {
-            LOG(1) << "Doing scan of collection " << ns() << " to get size and count info";
+    long long numRecords;
+    long long dataSize;
+    if (_sizeStorer && _sizeStorer->loadFromCache(_uri, &numRecords, &dataSize)) {
+        // Trust the sizes saved by the previous run, as before. They are not crash-consistent
+        // with the table and may be slightly off after an unclean shutdown. Opening the table is
+        // put off until an insert needs the largest RecordId in use, so that startup doesn't
+        // touch every collection.
+        _numRecords.store(numRecords);
+        _dataSize.store(dataSize);
+        _sizeStorer->onCreate(this, numRecords, dataSize);
+    } else {
+        // The size storer doesn't know about this table, e.g. because it was created shortly
+        // before an unclean shutdown, so count the records. Such tables are still opened and
+        // scanned at startup.
+        std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
+        _numRecords.store(0);
+        _dataSize.store(0);
+        if (auto record = cursor->next()) {
+            int64_t max = record->id.repr();
+            _nextIdNum.store(1 + max);
 
-            _numRecords.store(0);
-            _dataSize.store(0);
+            LOG(1) << "Doing scan of collection " << ns() << " to get size and count info";
 
             do {
                 _numRecords.fetchAndAdd(1);
                 _dataSize.fetchAndAdd(record->data.size());
             } while ((record = cursor->next()));
+        } else {
+            // Need to start at 1 so we are always higher than RecordId::min()
+            _nextIdNum.store(1);
         }
-    } else {
-        _dataSize.store(0);
-        _numRecords.store(0);
-        // Need to start at 1 so we are always higher than RecordId::min()
-        _nextIdNum.store(1);
+        _nextIdNumInitialized.store(true);
+
         if (_sizeStorer)
-            _sizeStorer->onCreate(this, 0, 0);
+            _sizeStorer->onCreate(this, _numRecords.load(), _dataSize.load());
     }
 
     if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns())) {
@@ -1199,9 +1387,9 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 return status.getStatus();
             record.id = status.getValue();
         } else if (_isCapped) { //̶
-            record.id = _nextId();
+            record.id = _nextId(opCtx);
         } else {
-            record.id = _nextId();
+            record.id = _nextId(opCtx);
         }
         dassert(record.id > highestId);
         highestId = record.id;
@@ -1609,8 +1797,21 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     }
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
     invariant(!_isOplog);
+    if (!_nextIdNumInitialized.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_nextIdNumMutex);
+        if (!_nextIdNumInitialized.load()) {
+            // Find the largest RecordId currently in use. Every insert waits for this, so no
+            // uncommitted records can be hiding past it.
+            std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
+            auto record = cursor->next();
+            // Need to start at 1 so we are always higher than RecordId::min()
+            _nextIdNum.store(record ? 1 + record->id.repr() : 1);
+            _nextIdNumInitialized.store(true);
+        }
+    }
+
     RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
     invariant(out.isNormal());
     return out;
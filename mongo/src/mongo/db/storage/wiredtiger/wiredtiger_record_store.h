@@ -296,7 +296,7 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    RecordId _nextId(OperationContext* opCtx);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
@@ -329,7 +329,11 @@ private:
     int _cappedDeleteCheckCount;
     mutable stdx::timed_mutex _cappedDeleterMutex;
 
+    // Set from the largest RecordId in the table the first time an insert needs it, unless
+    // postConstructorInit() already had to open the table.
     AtomicInt64 _nextIdNum;
+    AtomicBool _nextIdNumInitialized{false};
+    stdx::mutex _nextIdNumMutex;
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
 
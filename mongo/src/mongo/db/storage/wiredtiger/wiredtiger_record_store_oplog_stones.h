@@ -41,6 +41,14 @@ namespace mongo {
 class OperationContext;
 class RecordId;
 
+// Oplog entries younger than this many seconds are kept even when the oplog is over its size
+// limit. 0 disables the window.
+extern AtomicInt32 oplogMinRetentionSeconds;
+
+// Oplog entries older than this many seconds are truncated even when the oplog is under its size
+// limit. 0 disables the window.
+extern AtomicInt32 oplogMaxRetentionSeconds;
+
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
 // grows beyond its desired maximum size.
 class WiredTigerRecordStore::OplogStones {
@@ -57,15 +65,10 @@ public:
 
     void kill();
 
-    bool hasExcessStones_inlock() const {
-        int64_t total_bytes = 0;
-        for (std::deque<OplogStones::Stone>::const_iterator it = _stones.begin();
-             it != _stones.end();
-             ++it) {
-            total_bytes += it->bytes;
-        }
-        return total_bytes > _rs->cappedMaxSize();
-    }
+    // True if the oldest stone should be truncated, either because the stones exceed the size of
+    // the oplog and it is outside of the minimum retention window, or because it has fallen out of
+    // the maximum retention window.
+    bool hasExcessStones_inlock() const;
 
     void awaitHasExcessStonesOrDead();
 
@@ -117,6 +120,13 @@ private:
     class InsertChange;
     class TruncateChange;
 
+    // Restores the stones saved in the size storer by a previous run. Returns false, leaving the
+    // stones untouched, if there are none or they don't match the contents of the oplog.
+    bool _loadPersistedStones(OperationContext* opCtx);
+
+    // Saves the stones to the size storer so the next startup doesn't need to recompute them.
+    void _persistStones_inlock();
+
     void _calculateStones(OperationContext* opCtx, size_t size);
     void _calculateStonesByScanning(OperationContext* opCtx);
     void _calculateStonesBySampling(OperationContext* opCtx,
@@ -853,5 +853,193 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+// Verify that oplog stones older than oplogMaxRetentionSeconds are reclaimed even when
+// cappedMaxSize isn't exceeded.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesPastMaxRetention) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 50), RecordId(1, 3));
+
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_EQ(1, oplogStones->currentRecords());
+        ASSERT_EQ(50, oplogStones->currentBytes());
+    }
+
+    // No-op while there's no maximum retention window.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+
+    // The stones were created in 1970, so they fall out of a one hour window.
+    oplogMaxRetentionSeconds.store(60 * 60);
+    ON_BLOCK_EXIT([] { oplogMaxRetentionSeconds.store(0); });
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(50, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(0U, oplogStones->numStones());
+        ASSERT_EQ(1, oplogStones->currentRecords());
+        ASSERT_EQ(50, oplogStones->currentBytes());
+    }
+}
+
+// Verify that oplog stones younger than oplogMinRetentionSeconds are kept even when cappedMaxSize
+// is exceeded.
+TEST(WiredTigerRecordStoreTest, OplogStones_KeepStonesInMinRetention) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 230U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    const unsigned now = durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 1), 100),
+                  RecordId(now, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 2), 110),
+                  RecordId(now, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 3), 120),
+                  RecordId(now, 3));
+
+        ASSERT_EQ(330, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    oplogMinRetentionSeconds.store(60 * 60);
+    ON_BLOCK_EXIT([] { oplogMinRetentionSeconds.store(0); });
+
+    // The oplog is over cappedMaxSize, but every stone is inside of the minimum retention window.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(330, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // Size-based truncation resumes once the window no longer covers the stones.
+    oplogMinRetentionSeconds.store(0);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(230, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+}
+
+// Verify that the oplog stones are saved in the size storer and restored from it instead of being
+// recomputed.
+TEST(WiredTigerRecordStoreTest, OplogStones_PersistStones) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    WT_CONNECTION* conn;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        conn = WiredTigerRecoveryUnit::get(opCtx.get())->getSessionCache()->conn();
+    }
+    const std::string sizeStorerUri = "table:oplogStonesSizeStorer";
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(conn, sizeStorerUri, enableWtLogging);
+    wtrs->setSizeStorer(&ss);
+    ON_BLOCK_EXIT([&] { rs.reset(); });  // The record store has to be deleted before 'ss'.
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 50), RecordId(1, 3));
+
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        // Starting with a stone past the end of the oplog falls back to scanning, which places no
+        // stones with the default 'minBytesPerStone'.
+        BSONObj stone = BSON("records" << 1 << "bytes" << 100 << "lastRecord"
+                                       << RecordId(2, 1).repr());
+        ss.storeOplogStonesToCache(wtrs->getURI(), BSON("stones" << BSON_ARRAY(stone)));
+        WiredTigerRecordStore::OplogStones scanned(opCtx.get(), wtrs);
+        ASSERT_EQ(0U, scanned.numStones());
+        ASSERT_EQ(3, scanned.currentRecords());
+        ASSERT_EQ(260, scanned.currentBytes());
+    }
+
+    // Use stones that are distinguishable from ones computed by scanning the oplog.
+    const BSONObj persisted = BSON("stones" << BSON_ARRAY(BSON("records" << 2 << "bytes" << 210
+                                                                         << "lastRecord"
+                                                                         << RecordId(1, 2).repr())));
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ss.storeOplogStonesToCache(wtrs->getURI(), persisted);
+        WiredTigerRecordStore::OplogStones restored(opCtx.get(), wtrs);
+        ASSERT_EQ(1U, restored.numStones());
+        ASSERT_EQ(1, restored.currentRecords());
+        ASSERT_EQ(50, restored.currentBytes());
+    }
+
+    // The stones survive a round trip through the size storer table.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ss.syncCache(true);
+
+        WiredTigerSizeStorer ss2(conn, sizeStorerUri, enableWtLogging);
+        ss2.fillCache();
+        ASSERT_BSONOBJ_EQ(persisted, ss2.loadOplogStonesFromCache(wtrs->getURI()));
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -35,16 +35,23 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/bits.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 /*
@@ -235,6 +242,49 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
 namespace {
 AtomicUInt64 nextTableId(1);
+
+// How long the thread that flushes the journal for waitUntilDurable holds off, so that writers
+// committing at about the same time share one flush. 0 flushes right away.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerJournalCommitDelayMicros, int, 0);
+
+// Once this many threads are waiting for durability, the flush starts without waiting out the
+// rest of the delay. 0 means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerJournalCommitBatchSize, int, 0);
+
+template <size_t N>
+void recordInHistogram(std::array<AtomicUInt64, N>* histogram, uint64_t value) {
+    const int bucket = value == 0 ? 0 : 64 - countLeadingZeros64(value);
+    (*histogram)[std::min(bucket, static_cast<int>(histogram->size()) - 1)].fetchAndAdd(1);
+}
+
+template <size_t N>
+void appendHistogram(const std::array<AtomicUInt64, N>& histogram,
+                     const char* key,
+                     const char* boundName,
+                     BSONObjBuilder* builder) {
+    BSONArrayBuilder arrayBuilder(builder->subarrayStart(key));
+    for (size_t i = 0; i < histogram.size(); i++) {
+        const uint64_t count = histogram[i].load();
+        if (count == 0)
+            continue;
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append(boundName, i == 0 ? 0LL : 1LL << (i - 1));
+        entryBuilder.append("count", static_cast<long long>(count));
+        entryBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+}
+
+// One shard per core, rounded up to a power of two so that a shard can be picked with a mask.
+size_t numSessionCacheShards() {
+    const size_t kMaxShards = 128;
+    const size_t cores = std::max(1u, stdx::thread::hardware_concurrency());
+    size_t shards = 1;
+    while (shards < cores && shards < kMaxShards) {
+        shards *= 2;
+    }
+    return shards;
+}
 }
 // static   WiredTigerIndex::WiredTigerIndex
 uint64_t WiredTigerSession::genTableId() {
@@ -244,10 +294,20 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 //WiredTigerKVEngine::WiredTigerKVEngineеù
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _numShards(numSessionCacheShards()),
+      _shards(new SessionShard[_numShards]) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _numShards(numSessionCacheShards()),
+      _shards(new SessionShard[_numShards]) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -338,6 +398,21 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    Timer waitTimer;
+    const int batchSize = wiredTigerJournalCommitBatchSize.load();
+    const uint32_t waiters = _durabilityWaiters.addAndFetch(1);
+    if (batchSize > 0 && waiters >= static_cast<uint32_t>(batchSize)) {
+        // Let a flusher that is holding off for more waiters know the batch is full.
+        stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+        _groupCommitCondVar.notify_one();
+    }
+    ON_BLOCK_EXIT([&] {
+        _durabilityWaiters.subtractAndFetch(1);
+        const uint64_t waitMicros = waitTimer.micros();
+        recordInHistogram(&_durabilityWaitMicros, waitMicros);
+        _totalDurabilityWaitMicros.fetchAndAdd(waitMicros);
+    });
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -347,9 +422,21 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
-    _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    // Nobody has synched yet, so we have to sync ourselves. Threads that arrive from here on
+    // queue up on _lastSyncMutex having read the old _lastSyncTime, so the flush below covers
+    // them as well. Optionally give more of them a chance to arrive first.
+    const int delayMicros = wiredTigerJournalCommitDelayMicros.load();
+    if (delayMicros > 0) {
+        auto batchIsFull = [&] {
+            return batchSize > 0 && _durabilityWaiters.load() >= static_cast<uint32_t>(batchSize);
+        };
+        stdx::unique_lock<stdx::mutex> gl(_groupCommitMutex);
+        _groupCommitCondVar.wait_for(gl, stdx::chrono::microseconds(delayMicros), batchIsFull);
+    }
+
+    _lastSyncTime.store(current + 1);
+    recordInHistogram(&_flushBatchSizes, _durabilityWaiters.load());
 
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
@@ -376,36 +463,48 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
 }
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri); //WiredTigerSession::closeAllCursors
+    for (size_t shard = 0; shard < _numShards; shard++) {
+        stdx::lock_guard<stdx::mutex> lock(_shards[shard].lock);
+        for (WiredTigerSession* session : _shards[shard].sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
+size_t WiredTigerSessionCache::_shardForCurrentThread() const {
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) & (_numShards - 1);
+}
+
 //WiredTigerSessionCache::releaseSession   WiredTigerKVEngine::dropIdent
 void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine); //WiredTigerSession::closeCursorsForQueuedDrops
+    for (size_t shard = 0; shard < _numShards; shard++) {
+        stdx::lock_guard<stdx::mutex> lock(_shards[shard].lock);
+        for (WiredTigerSession* session : _shards[shard].sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 //ɾWiredTigerSession _sessions      WiredTigerSessionCache::shuttingDown
 void WiredTigerSessionCache::closeAll() {
     // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Sessions released after this see the new epoch and are deleted rather than cached, so
+    // emptying each shard afterwards catches every session from the old epoch.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (size_t shard = 0; shard < _numShards; shard++) {
+        SessionCache swap;
+        {
+            stdx::lock_guard<stdx::mutex> lock(_shards[shard].lock);
+            _shards[shard].sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
@@ -435,14 +534,17 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) { //WiredTigerSession _sessionsΪգֱȡһ
+    // Prefer the shard this thread released its last session to, then steal from the others.
+    const size_t home = _shardForCurrentThread();
+    for (size_t i = 0; i < _numShards; i++) {
+        SessionShard& shard = _shards[(home + i) & (_numShards - 1)];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        if (!shard.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones  
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back(); //WiredTigerSessionCache._sessions
-            return UniqueWiredTigerSession(cachedSession); 
+            // discarding older ones
+            WiredTigerSession* cachedSession = shard.sessions.back();
+            shard.sessions.pop_back();
+            return UniqueWiredTigerSession(cachedSession);
         }
     }
 
@@ -539,10 +641,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 
 	//Ѹsessioncacheûֱdrop
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        SessionShard& shard = _shards[_shardForCurrentThread()];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
-            returnedToCache = true; //
-            _sessions.push_back(session);
+            returnedToCache = true;
+            shard.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -555,6 +658,15 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents(); //WiredTigerKVEngine::dropSomeQueuedIdents
 }
 
+void WiredTigerSessionCache::appendGroupCommitStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder groupCommit(builder->subobjStart("groupCommit"));
+    appendHistogram(_flushBatchSizes, "flushBatchSizes", "waiters", &groupCommit);
+    appendHistogram(_durabilityWaitMicros, "waitMicros", "micros", &groupCommit);
+    groupCommit.append("totalWaitMicros",
+                       static_cast<long long>(_totalDurabilityWaitMicros.load()));
+    groupCommit.doneFast();
+}
+
 //WiredTigerKVEngine::setJournalListenerе
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
@@ -31,19 +31,24 @@
 
 #pragma once
 
+#include <array>
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -200,6 +205,12 @@ public:
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
+    /**
+     * Appends histograms of how many waitUntilDurable callers each journal flush covered and of
+     * how long those callers waited, for serverStatus.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder) const;
+
     WT_CONNECTION* conn() const {
         return _conn;
     }
@@ -232,13 +243,26 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-
-    //WiredTigerSessionCache::releaseSessionиֵ 
-    //WiredTigerRecoveryUnit::_ensureSession()ֵWiredTigerRecoveryUnit._session
+    // Idle sessions are spread over shards so that operations on different threads do not all
+    // contend on one mutex. A thread returns its session to, and looks for one in, the shard its
+    // id hashes to, so that it usually gets back the same session, along with the cursors cached
+    // in it. When that shard is empty it steals from the others before opening a new session.
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions; 
-    
+
+    static const size_t kCacheLineSize = 64;
+
+    struct SessionShard {
+        stdx::mutex lock;
+        SessionCache sessions;
+
+        // Keeps the shards on separate cache lines.
+        char padding[kCacheLineSize];
+    };
+
+    size_t _shardForCurrentThread() const;
+
+    const size_t _numShards;
+    std::unique_ptr<SessionShard[]> _shards;
 
     // Bumped when all open sessions need to be closed
     //WiredTigerSessionCache::closeAll
@@ -251,6 +275,20 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // Number of threads in waitUntilDurable waiting for the journal to be flushed. The thread
+    // that flushes may hold off for up to wiredTigerJournalCommitDelayMicros, or until this
+    // reaches wiredTigerJournalCommitBatchSize, so that one flush covers more waiters.
+    AtomicUInt32 _durabilityWaiters;
+    stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _groupCommitCondVar;
+
+    // Power-of-two histograms: bucket i counts values in [2^(i-1), 2^i), with bucket 0 for 0.
+    static const int kGroupCommitBuckets = 32;
+    typedef std::array<AtomicUInt64, kGroupCommitBuckets> GroupCommitHistogram;
+    GroupCommitHistogram _flushBatchSizes;
+    GroupCommitHistogram _durabilityWaitMicros;
+    AtomicUInt64 _totalDurabilityWaitMicros;
+
     // Protects _journalListener.
     stdx::mutex _journalListenerMutex;
     // Notified when we commit to the journal.
@@ -182,7 +182,7 @@ void WiredTigerSizeStorer::storeToCache(StringData uri, long long numRecords, lo
 //WiredTigerSizeStorer::storeToCacheWiredTigerSizeStorer::loadFromCacheӦ
 //ȡ_entries[uri]ݷ  WiredTigerRecordStore::postConstructorInitе
 //db.coll.count()ҲֻǶڴݡʵϾǵøýӿ
-void WiredTigerSizeStorer::loadFromCache(StringData uri,
+bool WiredTigerSizeStorer::loadFromCache(StringData uri,
                                          long long* numRecords,
                                          long long* dataSize) const {
     _checkMagic();
@@ -191,10 +191,29 @@ void WiredTigerSizeStorer::loadFromCache(StringData uri,
     if (it == _entries.end()) {
         *numRecords = 0;
         *dataSize = 0;
-        return;
+        return false;
     }
     *numRecords = it->second.numRecords;
     *dataSize = it->second.dataSize;
+    return true;
+}
+
+void WiredTigerSizeStorer::storeOplogStonesToCache(StringData uri, const BSONObj& oplogStones) {
+    _checkMagic();
+    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+    Entry& entry = _entries[uri.toString()];
+    entry.oplogStones = oplogStones.getOwned();
+    entry.dirty = true;
+}
+
+BSONObj WiredTigerSizeStorer::loadOplogStonesFromCache(StringData uri) const {
+    _checkMagic();
+    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+    Map::const_iterator it = _entries.find(uri.toString());
+    if (it == _entries.end()) {
+        return BSONObj();
+    }
+    return it->second.oplogStones;
 }
 
 void WiredTigerSizeStorer::fillCache() {
@@ -225,6 +244,9 @@ void WiredTigerSizeStorer::fillCache() {
             Entry& e = m[uriKey];
             e.numRecords = data["numRecords"].safeNumberLong();
             e.dataSize = data["dataSize"].safeNumberLong();
+            if (data["oplogStones"].type() == Object) {
+                e.oplogStones = data["oplogStones"].Obj().getOwned();
+            }
             e.dirty = false;
             e.rs = NULL;
         }
@@ -281,6 +303,9 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
             BSONObjBuilder b;
             b.append("numRecords", entry.numRecords);
             b.append("dataSize", entry.dataSize);
+            if (!entry.oplogStones.isEmpty()) {
+                b.append("oplogStones", entry.oplogStones);
+            }
             data = b.obj();
         }
 
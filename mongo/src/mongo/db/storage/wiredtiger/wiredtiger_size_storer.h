@@ -37,6 +37,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -53,6 +54,15 @@ mongodbʹ
 cacheڴΪdirtydb.coll.count()ҲֻǶڴݡ
 */ 
 //WiredTigerKVEngine._sizeStorer(Աtable:sizeStorer)   WiredTigerRecordStore._sizeStorer(ÿһWiredTigerRecordStore࣬_sizeStorerΪͳϢ)
+/**
+ * Caches the number of records and data size of every record store, and writes them to the
+ * 'storageUri' table when synced, which the checkpoint thread does before each checkpoint.
+ *
+ * The sizes are written in their own transaction, not with the writes that change them, so they
+ * are not crash-consistent: after an unclean shutdown a collection's sizes may be off by the
+ * writes since the last sync, until validate() corrects them. Record stores nonetheless trust them
+ * at startup instead of counting, so that startup doesn't have to open every table.
+ */
 class WiredTigerSizeStorer {
 public:
     WiredTigerSizeStorer(WT_CONNECTION* conn,
@@ -66,7 +76,18 @@ public:
 
     void storeToCache(StringData uri, long long numRecords, long long dataSize);
 
-    void loadFromCache(StringData uri, long long* numRecords, long long* dataSize) const;
+    /**
+     * Returns false, and zero sizes, if nothing has been stored for 'uri'.
+     */
+    bool loadFromCache(StringData uri, long long* numRecords, long long* dataSize) const;
+
+    /**
+     * Remembers the truncation markers of the oplog at 'uri' so they are written out along with
+     * its sizes. Returns an empty object from loadOplogStonesFromCache() if none were stored.
+     */
+    void storeOplogStonesToCache(StringData uri, const BSONObj& oplogStones);
+
+    BSONObj loadOplogStonesFromCache(StringData uri) const;
 
     /**
      * Loads from the underlying table.
@@ -85,6 +106,7 @@ private:
         Entry() : numRecords(0), dataSize(0), dirty(false), rs(NULL) {}
         long long numRecords;
         long long dataSize;
+        BSONObj oplogStones;  // Empty unless the entry belongs to an oplog.
         bool dirty; //Ƿdirtyݣsynְ̺λfalse
         WiredTigerRecordStore* rs;  // not owned  ӦļWiredTigerRecordStore.uri
     };
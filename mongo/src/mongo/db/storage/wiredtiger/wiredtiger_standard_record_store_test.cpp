@@ -296,6 +296,73 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// Sizes found in the size storer are used without counting the records, while tables it doesn't
+// know about are counted. Either way new records get RecordIds past the existing ones.
+TEST(WiredTigerRecordStoreTest, SizeStorerTrustedOnReopen) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 3; i++) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false).getStatus());
+        }
+        uow.commit();
+    }
+    rs.reset(NULL);
+
+    string indexUri = "table:myindex";
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(harnessHelper->conn(), indexUri, enableWtLogging);
+
+    auto reopen = [&] {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = "a.b"_sd;
+        params.uri = uri;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = &ss;
+
+        auto ret = new StandardWiredTigerRecordStore(nullptr, opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        rs.reset(ret);
+    };
+
+    // The size storer has no entry for the table, so the records are counted.
+    reopen();
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQUALS(6, rs->dataSize(opCtx.get()));
+    }
+    rs.reset(NULL);
+
+    // Now there is an entry, which is believed even though it's wrong.
+    ss.storeToCache(uri, 100, 1000);
+    reopen();
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(100, rs->numRecords(opCtx.get()));
+        ASSERT_EQUALS(1000, rs->dataSize(opCtx.get()));
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_EQUALS(RecordId(4), res.getValue());
+        uow.commit();
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
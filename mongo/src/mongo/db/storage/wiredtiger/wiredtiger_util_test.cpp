@@ -40,6 +40,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
@@ -360,4 +361,54 @@ TEST(WiredTigerUtilTest, GetStatisticsValueAsUInt8) {
     ASSERT_EQUALS(static_cast<uint8_t>(100), resultInt16.getValue());
 }
 
+TEST(WiredTigerSessionCacheTest, ReleasedSessionIsReusedOnSameThread) {
+    WiredTigerUtilHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    WiredTigerSession* released = nullptr;
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        released = session.get();
+    }
+
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    ASSERT_EQUALS(released, session.get());
+}
+
+TEST(WiredTigerSessionCacheTest, SessionReleasedOnOtherThreadIsReused) {
+    WiredTigerUtilHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Whichever shard the other thread released to, an empty shard for this thread must steal
+    // the session rather than open a new one.
+    WiredTigerSession* released = nullptr;
+    stdx::thread otherThread([&] {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        released = session.get();
+    });
+    otherThread.join();
+
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    ASSERT_EQUALS(released, session.get());
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllEmptiesEveryShard) {
+    WiredTigerUtilHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&] { sessionCache->getSession(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    // The threads released their sessions into whichever shards they hash to. closeAll must
+    // free all of them, and the cache must keep working afterwards.
+    sessionCache->closeAll();
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    ASSERT(session->getSession());
+}
+
 }  // namespace mongo
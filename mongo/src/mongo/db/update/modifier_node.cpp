@@ -192,6 +192,9 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
     if (!applyParams.indexData ||
         !applyParams.indexData->mightBeIndexed(applyParams.pathTaken->dottedField())) {
         applyResult.indexesAffected = false;
+    } else if (applyParams.modifiedIndexedPaths) {
+        applyParams.modifiedIndexedPaths->push_back(
+            applyParams.pathTaken->dottedField().toString());
     }
 
     if (applyParams.validateForStorage) {
@@ -286,11 +289,13 @@ UpdateNode::ApplyResult ModifierNode::applyToNonexistentElement(ApplyParams appl
         // an index {"a.b": 1}, and we set "a.1.c" and implicitly create an array element in "a",
         // then we may need to add a null key to the index, even though "a.1.c" does not appear to
         // affect the index.
-        if (!applyParams.indexData ||
-            !applyParams.indexData->mightBeIndexed(applyParams.element.getType() != BSONType::Array
-                                                       ? fullPath
-                                                       : applyParams.pathTaken->dottedField())) {
+        const StringData pathForIndexCheck = applyParams.element.getType() != BSONType::Array
+            ? StringData(fullPath)
+            : applyParams.pathTaken->dottedField();
+        if (!applyParams.indexData || !applyParams.indexData->mightBeIndexed(pathForIndexCheck)) {
             applyResult.indexesAffected = false;
+        } else if (applyParams.modifiedIndexedPaths) {
+            applyParams.modifiedIndexedPaths->push_back(pathForIndexCheck.toString());
         }
 
         if (applyParams.logBuilder) {
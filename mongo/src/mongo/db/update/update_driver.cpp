@@ -339,6 +339,7 @@ Status UpdateDriver::update(StringData matchedField,
     // TODO: assert that update() is called at most once in a !_multi case.
 
     _affectIndices = (isDocReplacement() && (_indexedFields != NULL));
+    _modifiedIndexedPaths.clear();
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -352,6 +353,7 @@ Status UpdateDriver::update(StringData matchedField,
         applyParams.fromOplogApplication = _modOptions.fromOplogApplication;
         applyParams.validateForStorage = validateForStorage;
         applyParams.indexData = _indexedFields;
+        applyParams.modifiedIndexedPaths = &_modifiedIndexedPaths;
         if (_logOp && logOpRec) {
             applyParams.logBuilder = &logBuilder;
         }
@@ -420,14 +422,18 @@ Status UpdateDriver::update(StringData matchedField,
                 // This is necessary because if there is an index {"a.b": 1}, and we set "a.1.c" and
                 // implicitly create an array element in "a", then we may need to add a null key to
                 // the index {"a.b": 1}, even though "a.1.c" does not appear to affect the index.
-                if (!_affectIndices && !execInfo.noOp && _indexedFields) {
+                if (!execInfo.noOp && _indexedFields) {
                     auto pathLengthForIndexCheck = execInfo.indexOfArrayWithNewElement[i]
                         ? *execInfo.indexOfArrayWithNewElement[i] + 1
                         : execInfo.fieldRef[i]->numParts();
-                    if (_indexedFields->mightBeIndexed(
-                            execInfo.fieldRef[i]->dottedSubstring(0, pathLengthForIndexCheck))) {
-                        _affectIndices = true;
-                        doc->disableInPlaceUpdates();
+                    auto pathForIndexCheck =
+                        execInfo.fieldRef[i]->dottedSubstring(0, pathLengthForIndexCheck);
+                    if (_indexedFields->mightBeIndexed(pathForIndexCheck)) {
+                        if (!_affectIndices) {
+                            _affectIndices = true;
+                            doc->disableInPlaceUpdates();
+                        }
+                        _modifiedIndexedPaths.push_back(pathForIndexCheck.toString());
                     }
                 }
             }
@@ -549,6 +555,10 @@ bool UpdateDriver::modsAffectIndices() const {
     return _affectIndices;
 }
 
+const std::vector<std::string>* UpdateDriver::modifiedIndexedPaths() const {
+    return isDocReplacement() ? nullptr : &_modifiedIndexedPaths;
+}
+
 void UpdateDriver::refreshIndexKeys(const UpdateIndexData* indexedFields) {
     _indexedFields = indexedFields;
 }
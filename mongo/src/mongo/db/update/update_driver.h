@@ -129,6 +129,14 @@ public:
     static bool isDocReplacement(const BSONObj& updateExpr);
 
     bool modsAffectIndices() const;
+
+    /**
+     * Returns the paths that the last call to update() modified and that might be indexed, so
+     * that indexes over none of them can keep their keys. Returns nullptr if any indexed path may
+     * have changed, as when the whole document is replaced. Only meaningful if
+     * modsAffectIndices() is true.
+     */
+    const std::vector<std::string>* modifiedIndexedPaths() const;
     void refreshIndexKeys(const UpdateIndexData* indexedFields);
 
     bool logOp() const;
@@ -202,6 +210,9 @@ private:
     // at each call to update.
     bool _affectIndices;
 
+    // The indexed paths modified by the last call to update(). See modifiedIndexedPaths().
+    std::vector<std::string> _modifiedIndexedPaths;
+
     // Do any of the mods require positional match details when calling 'prepare'?
     bool _positional;
 
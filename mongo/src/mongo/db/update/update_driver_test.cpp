@@ -179,6 +179,69 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+TEST(IndexedPaths, ModifiedIndexedPathsOnlyIncludesIndexedPaths) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver::Options opts(expCtx);
+    UpdateDriver driver(opts);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_OK(driver.parse(fromjson("{$inc: {a: 1}, $set: {b: 1, 'c.d': 1}}"), arrayFilters));
+
+    UpdateIndexData indexData;
+    indexData.addPath("a");
+    indexData.addPath("c");
+    indexData.addPath("e");
+    driver.refreshIndexKeys(&indexData);
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1, b: 1, c: {d: 0}}"));
+    ASSERT_OK(driver.update(StringData(), BSONObj(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    ASSERT(driver.modifiedIndexedPaths());
+    std::vector<std::string> expected{"a", "c.d"};
+    ASSERT(expected == *driver.modifiedIndexedPaths());
+}
+
+TEST(IndexedPaths, ModifiedIndexedPathsIsEmptyIfNoIndexedPathChanges) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver::Options opts(expCtx);
+    UpdateDriver driver(opts);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_OK(driver.parse(fromjson("{$set: {a: 1, b: 2}}"), arrayFilters));
+
+    UpdateIndexData indexData;
+    indexData.addPath("a");
+    driver.refreshIndexKeys(&indexData);
+
+    // 'a' already has the value being set, so only 'b' is modified.
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1, b: 1}"));
+    ASSERT_OK(driver.update(StringData(), BSONObj(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_FALSE(driver.modsAffectIndices());
+    ASSERT(driver.modifiedIndexedPaths());
+    ASSERT(driver.modifiedIndexedPaths()->empty());
+}
+
+TEST(IndexedPaths, ReplacementMayModifyAnyIndexedPath) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver::Options opts(expCtx);
+    UpdateDriver driver(opts);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_OK(driver.parse(fromjson("{a: 2}"), arrayFilters));
+
+    UpdateIndexData indexData;
+    indexData.addPath("a");
+    driver.refreshIndexKeys(&indexData);
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1}"));
+    ASSERT_OK(driver.update(StringData(), BSONObj(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    ASSERT_FALSE(driver.modifiedIndexedPaths());
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
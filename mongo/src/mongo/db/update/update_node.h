@@ -29,6 +29,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "mongo/bson/bsonelement.h"
 #include "mongo/bson/mutable/element.h"
@@ -119,6 +121,10 @@ public:
         // Used to determine whether indexes are affected.
         const UpdateIndexData* indexData = nullptr;
 
+        // If provided, UpdateNode::apply appends each path it modifies that might be indexed,
+        // according to 'indexData', so that only the indexes over those paths need new keys.
+        std::vector<std::string>* modifiedIndexedPaths = nullptr;
+
         // If provided, UpdateNode::apply will log the update here.
         LogBuilder* logBuilder = nullptr;
     };
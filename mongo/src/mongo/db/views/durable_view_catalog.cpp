@@ -160,6 +160,7 @@ void DurableViewCatalogImpl::upsert(OperationContext* opCtx,
                                     view,
                                     enforceQuota,
                                     assumeIndexesAreAffected,
+                                    nullptr,
                                     &CurOp::get(opCtx)->debug(),
                                     &args);
     }
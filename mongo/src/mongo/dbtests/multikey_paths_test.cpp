@@ -300,6 +300,7 @@ TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentUpdate) {
                 BSON("_id" << 0 << "a" << 5 << "b" << BSON_ARRAY(1 << 2 << 3)),
                 enforceQuota,
                 indexesAffected,
+                nullptr,
                 opDebug,
                 &args);
             wuow.commit();
@@ -132,6 +132,7 @@ public:
                               false,
                               true,
                               NULL,
+                              NULL,
                               &args);
         wunit.commit();
     }
@@ -314,6 +314,43 @@ public:
     }
 };
 
+// Scanning through workBatch() returns the same keys, in the same order, as work() does.
+class QueryStageIxscanWorkBatch : public IndexScanTest {
+public:
+    void run() {
+        setup();
+
+        for (int i = 1; i <= 10; ++i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        std::unique_ptr<IndexScan> ixscan(
+            createIndexScan(BSON("x" << 2), BSON("x" << 8), true, false));
+
+        // The first unit opens the cursor and goes through doWork(); later ones are batched.
+        std::vector<WorkingSetID> batch;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::NEED_TIME == state) {
+            state = ixscan->workBatch(&_ws, 4, &batch, &id);
+        }
+        ASSERT_EQ(PlanStage::IS_EOF, state);
+        ASSERT(ixscan->isEOF());
+
+        ASSERT_EQ(6U, batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            WorkingSetMember* member = _ws.get(batch[i]);
+            ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
+            ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << static_cast<int>(i) + 2));
+        }
+
+        const IndexScanStats* stats =
+            static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
+        ASSERT_EQ(6U, stats->keysExamined);
+        ASSERT_EQ(6U, ixscan->getCommonStats()->advanced);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_ixscan") {}
@@ -324,6 +361,7 @@ public:
         add<QueryStageIxscanInsertDuringSaveExclusive>();
         add<QueryStageIxscanInsertDuringSaveExclusive2>();
         add<QueryStageIxscanInsertDuringSaveReverse>();
+        add<QueryStageIxscanWorkBatch>();
     }
 } QueryStageIxscanAll;
 
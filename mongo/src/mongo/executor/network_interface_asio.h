@@ -292,7 +292,10 @@ private:
 
         // This form of beginCommand takes a raw message. It is needed if the caller
         // has to form the command manually (e.g. to use a specific requestBuilder).
-        Status beginCommand(Message&& newCommand, const HostAndPort& target);
+        // 'compressor' names the compressor to use if it was negotiated on the connection.
+        Status beginCommand(Message&& newCommand,
+                            const HostAndPort& target,
+                            StringData compressor = StringData());
 
         AsyncCommand& command();
         bool commandIsInitialized() const;
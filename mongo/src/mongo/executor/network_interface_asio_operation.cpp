@@ -154,14 +154,20 @@ void NetworkInterfaceASIO::AsyncOp::setConnection(AsyncConnection&& conn) {
 
 //NetworkInterfaceASIO::_beginCommunication
 Status NetworkInterfaceASIO::AsyncOp::beginCommand(Message&& newCommand,
-                                                   const HostAndPort& target) {
+                                                   const HostAndPort& target,
+                                                   StringData compressor) {
     // NOTE: We operate based on the assumption that AsyncOp's
     // AsyncConnection does not change over its lifetime.
     MONGO_ASYNC_OP_INVARIANT(_connection.is_initialized(),
                              "Connection should not change over AsyncOp's lifetime");
 
 	//ѹ
-    auto swm = _connection->getCompressorManager().compressMessage(newCommand);
+    auto& compressorManager = _connection->getCompressorManager();
+    boost::optional<MessageCompressorId> compressorId;
+    if (!compressor.empty()) {
+        compressorId = compressorManager.getNegotiatedCompressorId(compressor);
+    }
+    auto swm = compressorManager.compressMessage(newCommand, compressorId.get_ptr());
     if (!swm.isOK())
         return swm.getStatus();
 
@@ -176,7 +182,8 @@ Status NetworkInterfaceASIO::AsyncOp::beginCommand(const RemoteCommandRequest& r
         rpc::messageFromOpMsgRequest(
             operationProtocol(),
             OpMsgRequest::fromDBAndBody(request.dbname, request.cmdObj, request.metadata)),
-        request.target);
+        request.target,
+        request.compressor);
 }
 
 NetworkInterfaceASIO::AsyncCommand& NetworkInterfaceASIO::AsyncOp::command() {
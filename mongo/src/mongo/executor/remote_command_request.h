@@ -104,6 +104,11 @@ struct RemoteCommandRequest {
 
     // Deadline by when the request must be completed
     Date_t expirationDate = kNoExpirationDate;
+
+    // Name of the network message compressor to send the request with, in place of the
+    // connection's preferred one, if it was negotiated on the connection. The remote node replies
+    // with the same compressor. Empty to use the preferred compressor.
+    std::string compressor;
 };
 
 std::ostream& operator<<(std::ostream& os, const RemoteCommandRequest& response);
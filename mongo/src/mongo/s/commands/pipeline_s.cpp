@@ -139,6 +139,14 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::list<BSONObj> getIndexSpecs(const NamespaceString& nss) final {
+        MONGO_UNREACHABLE;
+    }
+
+    Status createIndexes(const NamespaceString& nss, const std::vector<BSONObj>& specs) final {
+        MONGO_UNREACHABLE;
+    }
+
     Status renameIfOptionsAndIndexesHaveNotChanged(
         const BSONObj& renameCommandObj,
         const NamespaceString& targetNs,
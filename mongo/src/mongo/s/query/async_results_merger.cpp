@@ -111,6 +111,13 @@ bool AsyncResultsMerger::remotesExhausted() {
     return _remotesExhausted(lk);
 }
 
+bool AsyncResultsMerger::remoteExhaustedAndDrained(size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(remoteIndex < _remotes.size());
+    const auto& remote = _remotes[remoteIndex];
+    return remote.exhausted() && !remote.hasNext();
+}
+
 bool AsyncResultsMerger::_remotesExhausted(WithLock) {
     for (const auto& remote : _remotes) {
         if (!remote.exhausted()) {
@@ -104,6 +104,12 @@ public:
      */
     bool remotesExhausted();
 
+    /**
+     * Returns true if the remote cursor at 'remoteIndex', in the order the remotes were given to
+     * the ARM, is exhausted and all of its results have been returned by nextReady().
+     */
+    bool remoteExhaustedAndDrained(size_t remoteIndex);
+
     /**
      * Sets the maxTimeMS value that the ARM should forward with any internally issued getMore
      * requests.
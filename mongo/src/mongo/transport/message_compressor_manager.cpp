@@ -237,6 +237,16 @@ void MessageCompressorManager::clientFinish(const BSONObj& input) {
     }
 }
 
+boost::optional<MessageCompressorId> MessageCompressorManager::getNegotiatedCompressorId(
+    StringData name) const {
+    for (const auto compressor : _negotiated) {
+        if (compressor->getName() == name) {
+            return compressor->getId();
+        }
+    }
+    return boost::none;
+}
+
 void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
     LOG(3) << "Starting server-side compression negotiation";
 
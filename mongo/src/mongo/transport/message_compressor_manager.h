@@ -30,9 +30,11 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
+#include <boost/optional.hpp>
 #include <vector>
 
 namespace mongo {
@@ -123,6 +125,13 @@ public:
     StatusWith<Message> decompressMessage(const Message& msg,
                                           MessageCompressorId* compressorId = nullptr);
 
+    /*
+     * Returns the ID of the compressor named 'name' if it was negotiated for this connection, and
+     * boost::none otherwise. The ID can be passed to compressMessage to use that compressor
+     * instead of the preferred one, and the server answers with the same compressor.
+     */
+    boost::optional<MessageCompressorId> getNegotiatedCompressorId(StringData name) const;
+
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
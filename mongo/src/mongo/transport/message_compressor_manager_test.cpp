@@ -294,6 +294,47 @@ TEST(MessageCompressorManager, SERVER_28008) {
     ASSERT_EQ(compressorId, zlibId);
 }
 
+TEST(MessageCompressorManager, GetNegotiatedCompressorId) {
+    std::unique_ptr<MessageCompressorBase> zlibCompressor =
+        stdx::make_unique<ZlibMessageCompressor>();
+    const auto zlibId = zlibCompressor->getId();
+    const auto zlibName = zlibCompressor->getName();
+
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({"snappy", zlibName});
+    registry.registerImplementation(std::move(zlibCompressor));
+    registry.registerImplementation(stdx::make_unique<SnappyMessageCompressor>());
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager clientManager(&registry);
+    MessageCompressorManager serverManager(&registry);
+
+    // Nothing has been negotiated yet.
+    ASSERT_FALSE(clientManager.getNegotiatedCompressorId(zlibName));
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    auto clientObj = clientOutput.done();
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientObj, &serverOutput);
+    clientManager.clientFinish(serverOutput.done());
+
+    auto compressorId = clientManager.getNegotiatedCompressorId(zlibName);
+    ASSERT_TRUE(compressorId);
+    ASSERT_EQ(*compressorId, zlibId);
+    ASSERT_FALSE(clientManager.getNegotiatedCompressorId("noop"));
+    ASSERT_FALSE(clientManager.getNegotiatedCompressorId("fake"));
+
+    // Sending with the looked up compressor round trips as that compressor.
+    auto toSend = assertOk(clientManager.compressMessage(buildMessage(), compressorId.get_ptr()));
+    MessageCompressorId receivedId;
+    auto recvd = assertOk(serverManager.decompressMessage(toSend, &receivedId));
+    ASSERT_EQ(receivedId, zlibId);
+    toSend = assertOk(serverManager.compressMessage(recvd, &receivedId));
+    recvd = assertOk(clientManager.decompressMessage(toSend, &receivedId));
+    ASSERT_EQ(receivedId, zlibId);
+}
+
 TEST(MessageCompressorManager, MessageSizeTooLarge) {
     auto registry = buildRegistry();
     MessageCompressorManager compManager(&registry);